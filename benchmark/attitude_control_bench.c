@@ -0,0 +1,99 @@
+/***************************************************************************
+ * attitude_control_bench.c
+ * Created on: 23-Oct-2026 14:00:00
+ * M. Schermutzki
+ * Cycles per attitudeControl_update() (all three axes and the mix), with
+ * gyro rates and with rates differentiated from the angles. One JSON
+ * object per measurement; the controller behaviour is checked in
+ * test/test_attitude_control.
+ ***************************************************************************/
+#define _POSIX_C_SOURCE 200809L   // clock_gettime
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "attitude_control.h"
+#include "bench_common.h"
+
+/*** macros ***************************************************************/
+#define C_BENCH_RATE_HZ     (500u)
+#define C_BENCH_THROTTLE    (128)
+#if defined(__arm__)
+#define C_BENCH_UPDATES     (10000u)
+#else
+#define C_BENCH_UPDATES     (1000000u)
+#endif
+
+#define C_BENCH_INPUTS      (1024u)    // power of two
+
+#define Q(x)  ((q16_16_t)((x) * C_FIXEDPOINT_ONE))
+
+/*** local variables ******************************************************/
+static const attitude_control_config_t _config =
+{
+    .rateHz        = C_BENCH_RATE_HZ,
+    .integralLimit = Q(40),
+    .outputLimit   = Q(100),
+    .dFilterShift  = 2,
+    .motorMin      = 0,
+    .motorMax      = 255
+};
+
+static attitude_control_t _control;
+static q16_16_t _angles[C_BENCH_INPUTS][E_ATTITUDE_AXIS_COUNT];
+static q16_16_t _rates[C_BENCH_INPUTS][E_ATTITUDE_AXIS_COUNT];
+
+/*** functions ************************************************************/
+static void _setup(double p, double i, double d)
+{
+    attitude_control_gains_t gains = { Q(p), Q(i), Q(d) };
+
+    attitudeControl_init(&_control, &_config);
+    attitudeControl_setThrottle(&_control, Q(C_BENCH_THROTTLE));
+    for (uint8_t axis = 0; axis < E_ATTITUDE_AXIS_COUNT; axis++)
+    {
+        attitudeControl_setGains(&_control, (attitude_control_axis_t)axis, &gains);
+    }
+}
+
+static void _measure(const char* op, bool gyro)
+{
+    uint8_t motors[C_ATTITUDE_MOTORS];
+    uint32_t seed = 0x1234567u;
+
+    // +-32 deg, +-256 deg/s, generated before the measurement
+    for (uint32_t n = 0; n < C_BENCH_INPUTS; n++)
+    {
+        for (uint8_t axis = 0; axis < E_ATTITUDE_AXIS_COUNT; axis++)
+        {
+            _angles[n][axis] = (q16_16_t)(bench_random(&seed) >> 10) - (1 << 21);
+            _rates[n][axis] = (q16_16_t)(bench_random(&seed) >> 7) - (1 << 24);
+        }
+    }
+
+    _setup(2.0, 0.5, 0.4);
+    attitudeControl_setSetpoints(&_control, Q(5), Q(-5), Q(90));
+
+    uint64_t c0 = bench_cycles(), t0 = bench_nowNs();
+    for (uint32_t n = 0; n < C_BENCH_UPDATES; n++)
+    {
+        uint32_t k = n & (C_BENCH_INPUTS - 1u);
+        attitudeControl_update(&_control, _angles[k], gyro ? _rates[k] : NULL, motors);
+        bench_sink += motors[0];
+    }
+    uint64_t c1 = bench_cycles(), t1 = bench_nowNs();
+
+    printf("{\"bench\":\"attitude_control\",\"op\":\"%s\",\"rate_hz\":%u,"
+           "\"ns_per_update\":%.3f,\"cycles_per_update\":%.2f,\"clock\":\"%s\"}\n",
+           op, C_BENCH_RATE_HZ, (double)(t1 - t0) / C_BENCH_UPDATES, (double)(c1 - c0) / C_BENCH_UPDATES, BENCH_CLOCK_NAME);
+}
+
+int main(void)
+{
+    bench_init();
+    _measure("update_gyro", true);
+    _measure("update_differentiated", false);
+    return 0;
+}
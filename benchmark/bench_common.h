@@ -0,0 +1,115 @@
+/*************************************************************************
+ * bench_common.h
+ * Timing helpers shared by the benchmarks in benchmark/
+ * Created on: 17-Oct-2026 15:00:00
+ * M. Schermutzki
+ * Host: CLOCK_MONOTONIC for ns, TSC for cycles (x86 only, reference
+ * clock rate on modern CPUs).
+ * Target (Cortex-M3): DWT cycle counter, ns derived from SystemCoreClock,
+ * printf output goes out over ITM/SWO.
+ *************************************************************************/
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+/*** includes ************************************************************/
+#include <stdint.h>
+
+#if defined(__arm__)
+#include "stm32f2xx_hal.h"
+#else
+#include <time.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*** macros *************************************************************/
+#if defined(__arm__) || defined(__x86_64__) || defined(__i386__)
+#define BENCH_HAS_CYCLES  (1)
+#else
+#define BENCH_HAS_CYCLES  (0)
+#endif
+
+#if defined(__arm__)
+#define BENCH_CLOCK_NAME  "dwt"
+#else
+#define BENCH_CLOCK_NAME  "tsc"
+#endif
+
+/*** functions ***********************************************************/
+#if defined(__arm__)
+
+static inline void bench_init(void)
+{
+    HAL_Init();
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+// CYCCNT is 32 bit (wraps after ~35 s at 120 MHz), extended here; has to be
+// called at least once per wrap
+static inline uint64_t bench_cycles(void)
+{
+    static uint32_t last;
+    static uint64_t high;
+    uint32_t now = DWT->CYCCNT;
+
+    if (now < last) high += 1ull << 32;
+    last = now;
+    return high | now;
+}
+
+static inline uint64_t bench_nowNs(void)
+{
+    return bench_cycles() * 1000ull / (SystemCoreClock / 1000000u);
+}
+
+// newlib stdout -> ITM stimulus port 0 (SWO viewer)
+int _write(int file, char* ptr, int len)
+{
+    (void)file;
+    for (int i = 0; i < len; i++) ITM_SendChar(ptr[i]);
+    return len;
+}
+
+#else
+
+static inline void bench_init(void)
+{
+}
+
+static inline uint64_t bench_nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t bench_cycles(void)
+{
+#if BENCH_HAS_CYCLES
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+#endif
+
+// deterministic on host and target, so streams are identical between runs
+static inline uint32_t bench_random(uint32_t* state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// keeps results alive so the compiler cannot drop the measured code
+static volatile uint32_t bench_sink;
+
+#endif // BENCH_COMMON_H
@@ -0,0 +1,122 @@
+/***************************************************************************
+ * crc16_bench.c
+ * Created on: 17-Oct-2026 15:00:00
+ * M. Schermutzki
+ * Compares the crc16 kernels (byte-wise table, slice-by-4, slice-by-8)
+ * and checks them bit for bit against crc16_calculate(). Prints one JSON
+ * object per line.
+ ***************************************************************************/
+#define _POSIX_C_SOURCE 200809L   // clock_gettime
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crc16.h"
+#include "bench_common.h"
+
+/*** macros ***************************************************************/
+#define C_BENCH_BUFFER_SIZE  (4096u)
+#define C_BENCH_TOTAL_BYTES  (64u * 1024u * 1024u)
+
+/*** local variables ******************************************************/
+static uint8_t _buffer[C_BENCH_BUFFER_SIZE];
+static const size_t _lengths[] = {7u, 16u, 25u, 64u, 256u, 1024u, 4096u};
+static const uint8_t _slices[] = {1u, 4u, 8u};
+
+/*** functions ************************************************************/
+
+/***************************************************************************
+ * Reference: byte by byte through the public instance API
+ **************************************************************************/
+static uint16_t _reference(crc16_t* crc16, const uint8_t* data, size_t len)
+{
+    crc16_reset(crc16);
+    for (size_t i = 0; i < len; i++)
+    {
+        crc16_calculate(crc16, data[i]);
+    }
+    return crc16_get(crc16);
+}
+
+/***************************************************************************
+ * Check all kernels against the reference for every length and offset
+ **************************************************************************/
+static int _verify(crc16_t* crc16)
+{
+    for (size_t len = 0; len <= 64u; len++)
+    {
+        for (size_t offset = 0; offset < 8u; offset++)
+        {
+            uint16_t expected = _reference(crc16, &_buffer[offset], len);
+
+            for (size_t s = 0; s < sizeof(_slices); s++)
+            {
+                uint16_t actual = crc16_update(0xFFFF, &_buffer[offset], len, _slices[s]);
+                if (actual != expected)
+                {
+                    printf("{\"error\":\"mismatch\",\"slices\":%u,\"len\":%zu,\"offset\":%zu,"
+                           "\"expected\":%u,\"actual\":%u}\n",
+                           _slices[s], len, offset, expected, actual);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    // known value: CRC-16/CCITT-FALSE("123456789") = 0x29B1
+    if (crc16_update(0xFFFF, (const uint8_t*)"123456789", 9u, C_CRC16_IMPL) != 0x29B1)
+    {
+        printf("{\"error\":\"check value\"}\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    bench_init();
+    crc16_init();
+    crc16_t* crc16 = crc16_new(0x02, 0x1F, 0x03);
+
+    srand(1);
+    for (size_t i = 0; i < sizeof(_buffer); i++)
+    {
+        _buffer[i] = (uint8_t)rand();
+    }
+
+    if (!crc16 || _verify(crc16) != 0) return 1;
+
+    for (size_t l = 0; l < sizeof(_lengths) / sizeof(_lengths[0]); l++)
+    {
+        size_t len = _lengths[l];
+        size_t iterations = C_BENCH_TOTAL_BYTES / len;
+
+        for (size_t s = 0; s < sizeof(_slices); s++)
+        {
+            uint16_t crc = 0xFFFF;
+            uint64_t startNs = bench_nowNs();
+            uint64_t startCycles = bench_cycles();
+
+            for (size_t i = 0; i < iterations; i++)
+            {
+                crc = crc16_update(crc, _buffer, len, _slices[s]);
+            }
+
+            uint64_t cycles = bench_cycles() - startCycles;
+            uint64_t ns = bench_nowNs() - startNs;
+            double bytes = (double)iterations * (double)len;
+            bench_sink = crc;
+
+            printf("{\"bench\":\"crc16\",\"slices\":%u,\"len\":%zu,\"ns_per_byte\":%.4f,"
+                   "\"bytes_per_cycle\":%.4f,\"mb_per_s\":%.1f}\n",
+                   _slices[s], len,
+                   (double)ns / bytes,
+                   cycles ? bytes / (double)cycles : 0.0,
+                   bytes / ((double)ns / 1e9) / 1e6);
+        }
+    }
+
+    return 0;
+}
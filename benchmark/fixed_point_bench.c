@@ -0,0 +1,151 @@
+/***************************************************************************
+ * fixed_point_bench.c
+ * Created on: 18-Oct-2026 16:00:00
+ * M. Schermutzki
+ * Old double parameter path (int -> volatile double in the parser, / 10
+ * in the data callback, gain * error in the controller) against the
+ * Q16.16 path. Checks that raw -> Q16.16 -> raw is exact for all wire
+ * values and prints one JSON object per measurement.
+ ***************************************************************************/
+#define _POSIX_C_SOURCE 200809L   // clock_gettime
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "fixed_point.h"
+#include "bench_common.h"
+
+/*** macros ***************************************************************/
+#define C_BENCH_VALUES      (1024u)
+#if defined(__arm__)
+#define C_BENCH_ITERATIONS  (64u)
+#else
+#define C_BENCH_ITERATIONS  (16384u)
+#endif
+
+#define C_BENCH_SCALE       (10)
+#define C_BENCH_RAW_LIMIT   (100000)   // +-10000.0 at scale 10
+
+/*** local variables ******************************************************/
+static int32_t _raw[C_BENCH_VALUES];
+static double _gainDouble[C_BENCH_VALUES];
+static double _errorDouble[C_BENCH_VALUES];
+static q16_16_t _gainFixed[C_BENCH_VALUES];
+static q16_16_t _errorFixed[C_BENCH_VALUES];
+
+static volatile double _doubleOut;
+static volatile q16_16_t _fixedOut;
+
+/*** functions ************************************************************/
+static void _report(const char* op, const char* path, uint64_t cycles, uint64_t ns, double ops)
+{
+    printf("{\"bench\":\"fixed_point\",\"op\":\"%s\",\"path\":\"%s\","
+           "\"ns_per_op\":%.3f,\"cycles_per_op\":%.2f,\"clock\":\"%s\"}\n",
+           op, path, (double)ns / ops, (double)cycles / ops, BENCH_CLOCK_NAME);
+}
+
+/***************************************************************************
+ * raw -> Q16.16 -> raw must give back every wire value; error of the
+ * conversion at most half an LSB
+ **************************************************************************/
+static int _verify(void)
+{
+    double worstLsb = 0.0;
+
+    for (int32_t raw = -C_BENCH_RAW_LIMIT; raw <= C_BENCH_RAW_LIMIT; raw++)
+    {
+        q16_16_t q = fixedPoint_fromScaled(raw, C_BENCH_SCALE);
+        double lsb = (FIXEDPOINT_TO_DOUBLE(q) - (double)raw / C_BENCH_SCALE) * C_FIXEDPOINT_ONE;
+
+        if (lsb < 0) lsb = -lsb;
+        if (lsb > worstLsb) worstLsb = lsb;
+
+        if (fixedPoint_toScaled(q, C_BENCH_SCALE) != raw || lsb > 0.5)
+        {
+            printf("{\"error\":\"roundtrip\",\"raw\":%ld}\n", (long)raw);
+            return 1;
+        }
+    }
+
+    printf("{\"bench\":\"fixed_point\",\"check\":\"roundtrip\",\"range\":%d,\"worst_error_lsb\":%.4f}\n",
+           C_BENCH_RAW_LIMIT, worstLsb);
+    return 0;
+}
+
+int main(void)
+{
+    uint32_t seed = 0xC0FFEEu;
+
+    bench_init();
+
+    for (size_t i = 0; i < C_BENCH_VALUES; i++)
+    {
+        _raw[i] = (int32_t)(bench_random(&seed) % (2u * C_BENCH_RAW_LIMIT + 1u)) - C_BENCH_RAW_LIMIT;
+        _errorFixed[i] = (q16_16_t)(bench_random(&seed) % (2u * 90u * C_FIXEDPOINT_ONE)) - 90 * C_FIXEDPOINT_ONE;
+        _gainFixed[i] = fixedPoint_fromScaled(_raw[i] / 100, C_BENCH_SCALE);
+        _errorDouble[i] = FIXEDPOINT_TO_DOUBLE(_errorFixed[i]);
+        _gainDouble[i] = FIXEDPOINT_TO_DOUBLE(_gainFixed[i]);
+    }
+
+    if (_verify() != 0) return 1;
+
+    double ops = (double)C_BENCH_ITERATIONS * C_BENCH_VALUES;
+    uint64_t startNs, startCycles;
+
+    // parameter update: parser store + callback scaling
+    startNs = bench_nowNs();
+    startCycles = bench_cycles();
+    for (size_t n = 0; n < C_BENCH_ITERATIONS; n++)
+    {
+        for (size_t i = 0; i < C_BENCH_VALUES; i++)
+        {
+            volatile double stored = _raw[i];
+            _doubleOut = stored / 10;
+        }
+    }
+    _report("param_update", "double", bench_cycles() - startCycles, bench_nowNs() - startNs, ops);
+
+    startNs = bench_nowNs();
+    startCycles = bench_cycles();
+    for (size_t n = 0; n < C_BENCH_ITERATIONS; n++)
+    {
+        for (size_t i = 0; i < C_BENCH_VALUES; i++)
+        {
+            volatile int32_t stored = _raw[i];
+            _fixedOut = fixedPoint_fromScaled(stored, C_BENCH_SCALE);
+        }
+    }
+    _report("param_update", "q16_16", bench_cycles() - startCycles, bench_nowNs() - startNs, ops);
+
+    // controller term: gain * error + accumulator (gains +-100, errors +-90)
+    double accDouble = 0.0;
+    startNs = bench_nowNs();
+    startCycles = bench_cycles();
+    for (size_t n = 0; n < C_BENCH_ITERATIONS; n++)
+    {
+        for (size_t i = 0; i < C_BENCH_VALUES; i++)
+        {
+            accDouble += _gainDouble[i] * _errorDouble[i];
+        }
+        _doubleOut = accDouble;
+        accDouble = 0.0;
+    }
+    _report("gain_mul_acc", "double", bench_cycles() - startCycles, bench_nowNs() - startNs, ops);
+
+    q16_16_t accFixed = 0;
+    startNs = bench_nowNs();
+    startCycles = bench_cycles();
+    for (size_t n = 0; n < C_BENCH_ITERATIONS; n++)
+    {
+        for (size_t i = 0; i < C_BENCH_VALUES; i++)
+        {
+            accFixed = fixedPoint_add(accFixed, fixedPoint_mul(_gainFixed[i], _errorFixed[i]));
+        }
+        _fixedOut = accFixed;
+        accFixed = 0;
+    }
+    _report("gain_mul_acc", "q16_16", bench_cycles() - startCycles, bench_nowNs() - startNs, ops);
+
+    return 0;
+}
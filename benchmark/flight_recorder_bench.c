@@ -0,0 +1,77 @@
+/***************************************************************************
+ * flight_recorder_bench.c
+ * Created on: 23-Oct-2026 09:00:00
+ * M. Schermutzki
+ * Cost of the flight recorder in the control loop (set* + commit per
+ * record) and of reading a dump chunk. One JSON object per measurement;
+ * the ring itself is checked in test/test_flight_recorder.
+ ***************************************************************************/
+#define _POSIX_C_SOURCE 200809L   // clock_gettime
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "flight_recorder.h"
+#include "bench_common.h"
+
+/*** macros ***************************************************************/
+#define C_BENCH_CHUNK         (8u)     // records per dump chunk (matlab_communication.c)
+#if defined(__arm__)
+#define C_BENCH_ITERATIONS    (4u)
+#else
+#define C_BENCH_ITERATIONS    (256u)
+#endif
+
+/*** local variables ******************************************************/
+static flight_record_t _dump[C_FLIGHTREC_RECORDS];
+
+/*** functions ************************************************************/
+static void _report(const char* op, uint64_t cycles, uint64_t ns, double ops)
+{
+    printf("{\"bench\":\"flight_recorder\",\"op\":\"%s\",\"record_size\":%u,"
+           "\"ns_per_op\":%.3f,\"cycles_per_op\":%.2f,\"clock\":\"%s\"}\n",
+           op, (unsigned)sizeof(flight_record_t), (double)ns / ops, (double)cycles / ops, BENCH_CLOCK_NAME);
+}
+
+// what the control task does once per pass
+static void _record(uint32_t i)
+{
+    flightRecorder_setImu((int16_t)i, (int16_t)(i >> 1), (int16_t)-i);
+    flightRecorder_setMotors((uint8_t)i, (uint8_t)(i + 1u), (uint8_t)(i + 2u), (uint8_t)(i + 3u));
+    for (uint8_t axis = 0; axis < E_FLIGHTREC_AXIS_COUNT; axis++)
+    {
+        flightRecorder_setPid((flight_recorder_axis_t)axis, (q16_16_t)(i << 8), -(q16_16_t)(i << 8), (q16_16_t)axis << 16);
+    }
+    flightRecorder_setMode(1);
+    flightRecorder_commit();
+}
+
+int main(void)
+{
+    bench_init();
+    flightRecorder_init();
+
+    // record: always armed, the ring wraps all the time
+    flightRecorder_arm(0, 0);
+    uint64_t c0 = bench_cycles(), t0 = bench_nowNs();
+    for (uint32_t i = 0; i < C_BENCH_ITERATIONS * C_FLIGHTREC_RECORDS; i++) _record(i);
+    uint64_t c1 = bench_cycles(), t1 = bench_nowNs();
+    _report("record", c1 - c0, t1 - t0, (double)C_BENCH_ITERATIONS * C_FLIGHTREC_RECORDS);
+
+    // dump: chunk copies out of the frozen ring
+    flightRecorder_stop();
+    size_t chunks = 0;
+    c0 = bench_cycles(); t0 = bench_nowNs();
+    for (uint32_t n = 0; n < C_BENCH_ITERATIONS; n++)
+    {
+        for (uint32_t index = 0; index < C_FLIGHTREC_RECORDS; index += C_BENCH_CHUNK, chunks++)
+        {
+            bench_sink += (uint32_t)flightRecorder_read(index, _dump, C_BENCH_CHUNK);
+        }
+    }
+    c1 = bench_cycles(); t1 = bench_nowNs();
+    _report("read_chunk", c1 - c0, t1 - t0, (double)chunks);
+
+    return 0;
+}
@@ -0,0 +1,249 @@
+/***************************************************************************
+ * matlab_parser_bench.c
+ * Created on: 18-Oct-2026 14:00:00
+ * M. Schermutzki
+ * Feeds synthetic byte streams through the matlab_communication parser
+ * (matlabCommunication_parse, no UART/ring in between) and prints one JSON
+ * object per stream: ns/byte, frames/s and the worst single byte in
+ * cycles (TSC on the host, DWT on the target).
+ ***************************************************************************/
+#define _POSIX_C_SOURCE 200809L   // clock_gettime, setenv
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "matlab_communication.h"
+#include "frame_builder.h"
+#include "bench_common.h"
+
+/*** macros ***************************************************************/
+#if defined(__arm__)
+#define C_BENCH_STREAM_SIZE  (4096u)
+#define C_BENCH_TOTAL_BYTES  (256u * 1024u)
+#else
+#define C_BENCH_STREAM_SIZE  (16u * 1024u)
+#define C_BENCH_TOTAL_BYTES  (32u * 1024u * 1024u)
+#endif
+
+#define C_BENCH_FRAME_SIZE   (40u)
+#define C_BENCH_MAX_GARBAGE  (16u)
+#define C_BENCH_WORST_PASSES (5u)
+
+#define C_BENCH_STX  (C_MATLABCOM_STX)
+#define C_BENCH_US   (C_MATLABCOM_US)
+#define C_BENCH_ETX  (C_MATLABCOM_ETX)
+
+/*** definitions **********************************************************/
+typedef enum
+{
+    E_BENCH_STREAM_MOTOR,
+    E_BENCH_STREAM_PID_ANGLE,
+    E_BENCH_STREAM_CRC_ERROR,
+    E_BENCH_STREAM_NOISE,
+    E_BENCH_STREAM_GARBAGE_BETWEEN,
+    E_BENCH_STREAM_LOST_ETX,
+    E_BENCH_STREAM_COUNT
+} bench_stream_t;
+
+/*** local variables ******************************************************/
+static const char* const _streamNames[E_BENCH_STREAM_COUNT] = {
+    "motor", "pid_angle", "crc_error", "noise", "garbage_between", "lost_etx"
+};
+static const uint8_t _pidAngleCmds[] = {
+    C_MATLABCOM_ROLL_PITCH_DATA, C_MATLABCOM_YAW_DATA, C_MATLABCOM_ANGLE_DATA
+};
+
+static uint8_t _stream[C_BENCH_STREAM_SIZE];
+static uint32_t _byteCycles[C_BENCH_STREAM_SIZE];
+static volatile uint32_t _framesOk;
+
+/*** functions ************************************************************/
+// subscriber of every command in the streams, like main.c
+static void _onFrame(matlab_communication_t* matlabCom, const matlab_communication_data_t* data, void* context)
+{
+    (void)matlabCom;
+    (void)data;
+    (void)context;
+    _framesOk++;
+}
+
+/***************************************************************************
+ * One valid ASCII frame (motor or PID/angle), returns its length
+ **************************************************************************/
+static size_t _buildFrame(uint8_t* out, bool pidAngle, uint32_t* seed)
+{
+    frame_builder_t fb;
+    frameBuilder_begin(&fb, out, C_BENCH_FRAME_SIZE, C_BENCH_STX, C_BENCH_US, C_BENCH_ETX);
+
+    if (pidAngle)
+    {
+        frameBuilder_addHex(&fb, E_MATLABCOM_CMD_SET_PID_ANGLE_VALUES);
+        frameBuilder_addHex(&fb, _pidAngleCmds[bench_random(seed) % sizeof(_pidAngleCmds)]);
+        for (uint8_t i = 0; i < 3u; i++)
+        {
+            frameBuilder_addSigned(&fb, (int32_t)(bench_random(seed) % 20001u) - 10000);
+        }
+    }
+    else
+    {
+        frameBuilder_addHex(&fb, E_MATLABCOM_CMD_SET_MOTOR_VALUE);
+        for (uint8_t i = 0; i < 4u; i++)
+        {
+            frameBuilder_addHex(&fb, bench_random(seed) & 0xFFu);
+        }
+    }
+
+    return frameBuilder_finish(&fb);
+}
+
+/***************************************************************************
+ * Fill _stream, returns the used length and the number of good frames
+ **************************************************************************/
+static size_t _buildStream(bench_stream_t type, uint32_t* expectedFrames)
+{
+    uint32_t seed = 0x12345678u + (uint32_t)type;
+    uint8_t frame[C_BENCH_FRAME_SIZE];
+    size_t len = 0;
+
+    *expectedFrames = 0;
+
+    if (type == E_BENCH_STREAM_NOISE)
+    {
+        for (len = 0; len < C_BENCH_STREAM_SIZE; len++)
+        {
+            _stream[len] = (uint8_t)bench_random(&seed);
+        }
+        return len;
+    }
+
+    while (true)
+    {
+        bool pidAngle = (type == E_BENCH_STREAM_PID_ANGLE) ||
+                        (type != E_BENCH_STREAM_MOTOR && (bench_random(&seed) & 1u));
+        size_t frameLen = _buildFrame(frame, pidAngle, &seed);
+        size_t garbage = 0;
+
+        if (type == E_BENCH_STREAM_GARBAGE_BETWEEN) garbage = bench_random(&seed) % (C_BENCH_MAX_GARBAGE + 1u);
+        if (len + garbage + frameLen > C_BENCH_STREAM_SIZE) break;
+
+        // line noise between frames, STX included: a false start is given up
+        // at the STX of the next frame
+        for (size_t i = 0; i < garbage; i++)
+        {
+            _stream[len++] = (uint8_t)bench_random(&seed);
+        }
+
+        // replace the last CRC digit by another valid hex digit
+        if (type == E_BENCH_STREAM_CRC_ERROR) frame[frameLen - 2u] = (frame[frameLen - 2u] == '0') ? '1' : '0';
+        // every 4th frame (on average) loses its ETX, the next one has to get through
+        else if (type == E_BENCH_STREAM_LOST_ETX && (bench_random(&seed) & 3u) == 0) frameLen--;
+        else (*expectedFrames)++;
+
+        for (size_t i = 0; i < frameLen; i++) _stream[len++] = frame[i];
+    }
+
+    return len;
+}
+
+/***************************************************************************
+ * Throughput and per byte worst case for one stream
+ **************************************************************************/
+static void _runStream(matlab_communication_t* matlabCom, bench_stream_t type)
+{
+    uint32_t expectedFrames;
+    size_t len = _buildStream(type, &expectedFrames);
+    size_t repetitions = C_BENCH_TOTAL_BYTES / len;
+
+    // throughput, parser reset (back to idle) before every repetition
+    _framesOk = 0;
+    uint64_t startNs = bench_nowNs();
+    uint64_t startCycles = bench_cycles();
+
+    for (size_t r = 0; r < repetitions; r++)
+    {
+        matlabCommunication_setFrameFormat(matlabCom, E_MATLABCOM_FORMAT_ASCII);
+        matlabCommunication_parse(matlabCom, _stream, len);
+    }
+
+    uint64_t cycles = bench_cycles() - startCycles;
+    uint64_t ns = bench_nowNs() - startNs;
+    uint32_t framesOk = _framesOk;
+
+    // cost of the timing itself
+    uint64_t overhead = UINT64_MAX;
+    for (uint32_t i = 0; i < 1000u; i++)
+    {
+        uint64_t t0 = bench_cycles();
+        uint64_t t1 = bench_cycles();
+        if (t1 - t0 < overhead) overhead = t1 - t0;
+    }
+
+    // every pass starts from idle, so byte i sees the same parser state each
+    // time; the minimum over the passes removes interrupts/preemption
+    for (size_t i = 0; i < len; i++) _byteCycles[i] = UINT32_MAX;
+
+    for (uint32_t pass = 0; pass < C_BENCH_WORST_PASSES; pass++)
+    {
+        matlabCommunication_setFrameFormat(matlabCom, E_MATLABCOM_FORMAT_ASCII);
+        for (size_t i = 0; i < len; i++)
+        {
+            uint64_t t0 = bench_cycles();
+            matlabCommunication_parse(matlabCom, &_stream[i], 1u);
+            uint64_t t1 = bench_cycles();
+            uint64_t dt = (t1 - t0 > overhead) ? (t1 - t0 - overhead) : 0;
+            if (dt < _byteCycles[i]) _byteCycles[i] = (uint32_t)dt;
+        }
+    }
+
+    uint32_t worst = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (_byteCycles[i] > worst) worst = _byteCycles[i];
+    }
+
+    double bytes = (double)repetitions * (double)len;
+    double seconds = (double)ns / 1e9;
+
+    printf("{\"bench\":\"matlab_parser\",\"stream\":\"%s\",\"bytes\":%.0f,"
+           "\"frames_expected\":%lu,\"frames_ok\":%lu,\"ns_per_byte\":%.3f,"
+           "\"cycles_per_byte\":%.2f,\"frames_per_s\":%.0f,"
+           "\"worst_byte_cycles\":%lu,\"clock\":\"%s\"}\n",
+           _streamNames[type], bytes,
+           (unsigned long)expectedFrames * (unsigned long)repetitions, (unsigned long)framesOk,
+           (double)ns / bytes,
+           (double)cycles / bytes,
+           seconds > 0.0 ? (double)framesOk / seconds : 0.0,
+           (unsigned long)worst, BENCH_CLOCK_NAME);
+}
+
+int main(void)
+{
+#if defined(HAL_NATIVE)
+    // no pty for the benchmark, the UART is never used
+    setenv("HAL_NATIVE_PTY", "0", 1);
+#endif
+
+    bench_init();
+    matlabCommunication_init();
+
+    matlab_communication_t* matlabCom = matlabCommunication_new(uart_new(UART_4, 57600));
+    if (!matlabCom)
+    {
+        printf("{\"error\":\"no instance\"}\n");
+        return 1;
+    }
+    matlabCommunication_subscribe(matlabCom, E_MATLABCOM_CMD_SET_MOTOR_VALUE, 0, _onFrame, NULL);
+    for (size_t i = 0; i < sizeof(_pidAngleCmds); i++)
+    {
+        matlabCommunication_subscribe(matlabCom, E_MATLABCOM_CMD_SET_PID_ANGLE_VALUES, _pidAngleCmds[i], _onFrame, NULL);
+    }
+
+    for (bench_stream_t type = 0; type < E_BENCH_STREAM_COUNT; type++)
+    {
+        _runStream(matlabCom, type);
+    }
+
+    return 0;
+}
@@ -0,0 +1,350 @@
+/***************************************************************************
+ * ping_latency.c
+ * Created on: 22-Oct-2026 14:00:00
+ * M. Schermutzki
+ * Round trip latency of the ping command (CMD 0x0A) through uart.c, the
+ * RX ring, the parser and the dispatch. Host load generator: sweeps the
+ * payload (0/4/8 words) and the offered rate (share of the line capacity
+ * for the answer), sends open loop and prints p50/p99/p99.9 of the round
+ * trip and of the time inside the controller (queued - RX ISR stamp).
+ *   ping_latency                   matlab_communication in this process
+ *                                  (lib/hal_native) over a pty with the
+ *                                  baud rate model at C_TEST_BAUD
+ *   ping_latency <device> <baud>   real controller, e.g. /dev/ttyUSB0 57600
+ * One JSON object per step. p99.9 only means something with >= 1000
+ * answers, "received" says how many there were; in pty mode
+ * rx_ring_overflows counts request bytes lost in the RX ring of the parser
+ * (C_MATLABCOM_RX_RING_SIZE).
+ ***************************************************************************/
+#define _GNU_SOURCE   // setenv, cfsetspeed, B1000000
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <termios.h>
+
+#undef CR1   // termios.h vs. USART registers
+#undef CR2
+#undef CR3
+
+#include "hal_native.h"
+#include "uart.h"
+#include "matlab_communication.h"
+#include "frame_builder.h"
+#include "bench_common.h"
+
+/*** macros ***************************************************************/
+#define C_TEST_BAUD         (460800u)    // pty mode, C_MATLABCOM_MAX_BAUD
+#define C_TEST_SECONDS      (3u)         // per step
+#define C_TEST_MAX_PINGS    (4000u)      // per step
+#define C_TEST_DRAIN_MS     (300u)       // wait for the last answers of a step
+
+#define C_TEST_STX  (C_MATLABCOM_STX)
+#define C_TEST_US   (C_MATLABCOM_US)
+#define C_TEST_ETX  (C_MATLABCOM_ETX)
+
+#define CMD_PING    (C_MATLABCOM_ID_PING_0)
+
+/*** definitions **********************************************************/
+typedef struct
+{
+    uint8_t frame[C_MATLABCOM_ASCII_SIZE_PING_ANSWER_8];
+    size_t len;
+    bool inFrame;
+} answer_parser_t;
+
+typedef struct
+{
+    uint32_t tagBase;
+    uint32_t pings;
+    uint32_t received;
+    size_t answerBytes;   // sum, for the mean
+} step_t;
+
+/*** local variables ******************************************************/
+static const uint8_t _payloadWords[] = { 0u, 4u, 8u };
+static const uint32_t _answerSize[] =   // upper bound, sets the rate
+{
+    C_MATLABCOM_ASCII_SIZE_PING_ANSWER_0, C_MATLABCOM_ASCII_SIZE_PING_ANSWER_4, C_MATLABCOM_ASCII_SIZE_PING_ANSWER_8
+};
+static const uint8_t _loadPct[] = { 10u, 30u, 50u, 70u, 90u };
+
+static uint64_t _sentNs[C_TEST_MAX_PINGS];
+static bool _answered[C_TEST_MAX_PINGS];
+static double _rttUs[C_TEST_MAX_PINGS];
+static double _mcuUs[C_TEST_MAX_PINGS];
+
+static volatile bool _stop = false;
+static matlab_communication_t* _matlabCom;   // pty mode only
+static const char* _device;
+static uint32_t _baud;
+static int _failed = 0;
+
+/*** functions ************************************************************/
+
+static speed_t _speed(uint32_t baud)
+{
+    static const struct { uint32_t baud; speed_t speed; } map[] =
+    {
+        { 57600u, B57600 }, { 115200u, B115200 }, { 230400u, B230400 }, { 460800u, B460800 },
+        { 921600u, B921600 }, { 1000000u, B1000000 }, { 2000000u, B2000000 }
+    };
+
+    for (size_t i = 0; i < sizeof(map) / sizeof(map[0]); i++)
+    {
+        if (map[i].baud == baud) return map[i].speed;
+    }
+    return B0;
+}
+
+static uint16_t _crc(const uint8_t* data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    while (len--)
+    {
+        crc ^= (uint16_t)(*data++ << 8);
+        for (uint8_t k = 0; k < 8u; k++) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+static uint32_t _random(void)
+{
+    static uint32_t state = 0x2545F491u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+/***************************************************************************
+ * Ping with words payload words, full width values (longest ASCII frame)
+ **************************************************************************/
+static size_t _sendPing(int fd, uint8_t words, uint32_t tag)
+{
+    uint8_t frame[C_MATLABCOM_ASCII_SIZE_PING_ANSWER_8];
+    frame_builder_t fb;
+
+    frameBuilder_begin(&fb, frame, sizeof(frame), C_TEST_STX, C_TEST_US, C_TEST_ETX);
+    frameBuilder_addHex(&fb, CMD_PING);
+    frameBuilder_addHex(&fb, words);
+    frameBuilder_addHex(&fb, tag);
+    for (uint8_t i = 0; i < words; i++) frameBuilder_addHex(&fb, 0x80000000u | _random());
+
+    size_t len = frameBuilder_finish(&fb);
+    ssize_t written = write(fd, frame, len);
+    (void)written;
+    return len;
+}
+
+/***************************************************************************
+ * One complete ASCII frame (without STX/ETX): a ping answer of this step?
+ **************************************************************************/
+static void _onFrame(answer_parser_t* parser, step_t* step, uint8_t words, uint64_t nowNs)
+{
+    uint8_t* frame = parser->frame;
+    size_t len = parser->len;
+
+    // fields | US | crc
+    size_t lastUs = len;
+    while (lastUs > 0 && frame[lastUs - 1u] != C_TEST_US) lastUs--;
+    if (lastUs == 0) return;
+
+    frame[len] = 0;
+    if (strtoul((char*)&frame[lastUs], NULL, 16) != _crc(frame, lastUs)) return;
+
+    uint32_t values[4];
+    size_t count = 0;
+    char* token = (char*)frame;
+    frame[lastUs - 1u] = 0;
+    while (token)
+    {
+        if (count < 4u) values[count] = (uint32_t)strtoul(token, NULL, 16);
+        count++;
+        token = strchr(token, C_TEST_US);
+        if (token) token++;
+    }
+
+    // cmd | tag | ISR | queued | payload
+    if (count != 4u + words || values[0] != CMD_PING) return;
+
+    uint32_t index = values[1] - step->tagBase;
+    if (index >= step->pings || _answered[index]) return;
+
+    _answered[index] = true;
+    _rttUs[step->received] = (double)(nowNs - _sentNs[index]) / 1e3;
+    _mcuUs[step->received] = (double)(uint32_t)(values[3] - values[2]);
+    step->answerBytes += len + 2u;
+    step->received++;
+}
+
+static void _readAnswers(int fd, answer_parser_t* parser, step_t* step, uint8_t words)
+{
+    uint8_t buffer[512];
+    ssize_t n;
+
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        uint64_t nowNs = bench_nowNs();
+
+        for (ssize_t i = 0; i < n; i++)
+        {
+            uint8_t byte = buffer[i];
+
+            if (byte == C_TEST_STX) { parser->inFrame = true; parser->len = 0; continue; }
+            if (!parser->inFrame) continue;
+            if (byte != C_TEST_ETX)
+            {
+                if (parser->len + 1u < sizeof(parser->frame)) parser->frame[parser->len++] = byte;
+                else parser->inFrame = false;
+                continue;
+            }
+            parser->inFrame = false;
+            _onFrame(parser, step, words, nowNs);
+        }
+    }
+}
+
+static int _compare(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double _percentile(const double* sorted, uint32_t count, double q)
+{
+    if (count == 0) return 0.0;
+    return sorted[(uint32_t)(q * (double)(count - 1u) + 0.5)];
+}
+
+/***************************************************************************
+ * One step: open loop at rate, then wait for the last answers
+ **************************************************************************/
+static void _runStep(int fd, uint32_t stepIndex, uint8_t wordIndex, uint8_t loadPct)
+{
+    uint8_t words = _payloadWords[wordIndex];
+    double rateHz = (double)_baud / 10.0 / (double)_answerSize[wordIndex] * (double)loadPct / 100.0;
+    uint64_t periodNs = (uint64_t)(1e9 / rateHz);
+    answer_parser_t parser = { .len = 0, .inFrame = false };
+    step_t step = { .tagBase = stepIndex << 16, .pings = (uint32_t)(rateHz * C_TEST_SECONDS), .received = 0, .answerBytes = 0 };
+    size_t requestBytes = 0;
+    uint32_t sent = 0;
+
+    matlab_communication_rx_stats_t rxBefore = { 0 }, rxAfter = { 0 };
+
+    if (step.pings > C_TEST_MAX_PINGS) step.pings = C_TEST_MAX_PINGS;
+    memset(_answered, 0, sizeof(_answered));
+    matlabCommunication_getRxStats(_matlabCom, &rxBefore);
+    tcflush(fd, TCIFLUSH);
+
+    uint64_t nextNs = bench_nowNs();
+    uint64_t lastSendNs = nextNs;
+    while (true)
+    {
+        uint64_t nowNs = bench_nowNs();
+
+        if (sent < step.pings && nowNs >= nextNs)
+        {
+            requestBytes = _sendPing(fd, words, step.tagBase + sent);
+            _sentNs[sent++] = lastSendNs = bench_nowNs();
+            nextNs += periodNs;
+            continue;
+        }
+        if (sent == step.pings && (step.received == step.pings || nowNs - lastSendNs > C_TEST_DRAIN_MS * 1000000ull)) break;
+
+        int timeoutMs = (sent < step.pings) ? (int)((nextNs - nowNs) / 1000000ull) : 1;
+        struct pollfd pfd = { .fd = fd, .events = POLLIN, .revents = 0 };
+        poll(&pfd, 1, timeoutMs);
+        _readAnswers(fd, &parser, &step, words);
+    }
+
+    // requests lost in the RX ring of the parser (pty mode)
+    char overflows[16] = "null";
+    matlabCommunication_getRxStats(_matlabCom, &rxAfter);
+    if (_matlabCom) snprintf(overflows, sizeof(overflows), "%lu", (unsigned long)(rxAfter.overflows - rxBefore.overflows));
+
+    qsort(_rttUs, step.received, sizeof(double), _compare);
+    qsort(_mcuUs, step.received, sizeof(double), _compare);
+
+    printf("{\"bench\":\"ping_latency\",\"link\":\"%s\",\"baud\":%lu,\"payload_words\":%u,\"request_bytes\":%lu,"
+           "\"answer_bytes\":%.1f,\"load_pct\":%u,\"rate_hz\":%.1f,\"sent\":%lu,\"received\":%lu,\"rx_ring_overflows\":%s,"
+           "\"rtt_p50_us\":%.1f,\"rtt_p99_us\":%.1f,\"rtt_p999_us\":%.1f,"
+           "\"mcu_p50_us\":%.1f,\"mcu_p99_us\":%.1f,\"mcu_p999_us\":%.1f}\n",
+           _device ? "device" : "pty", (unsigned long)_baud, words, (unsigned long)requestBytes,
+           step.received ? (double)step.answerBytes / step.received : 0.0, loadPct, rateHz,
+           (unsigned long)sent, (unsigned long)step.received, overflows,
+           _percentile(_rttUs, step.received, 0.50), _percentile(_rttUs, step.received, 0.99),
+           _percentile(_rttUs, step.received, 0.999),
+           _percentile(_mcuUs, step.received, 0.50), _percentile(_mcuUs, step.received, 0.99),
+           _percentile(_mcuUs, step.received, 0.999));
+    fflush(stdout);
+
+    if (step.received == 0) _failed = 1;
+}
+
+static void* _host(void* arg)
+{
+    const char* path = (const char*)arg;
+    struct termios tio;
+    uint32_t stepIndex = 1;
+
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) { _failed = 1; _stop = true; return NULL; }
+
+    tcgetattr(fd, &tio);
+    cfmakeraw(&tio);
+    cfsetspeed(&tio, _speed(_baud));
+    tcsetattr(fd, TCSANOW, &tio);
+
+    for (uint8_t w = 0; w < sizeof(_payloadWords); w++)
+    {
+        for (uint8_t l = 0; l < sizeof(_loadPct); l++) _runStep(fd, stepIndex++, w, _loadPct[l]);
+    }
+
+    close(fd);
+    _stop = true;
+    return NULL;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc >= 3)
+    {
+        _device = argv[1];
+        _baud = (uint32_t)strtoul(argv[2], NULL, 10);
+        if (_speed(_baud) == B0) { fprintf(stderr, "ping_latency: unsupported baud rate %s\n", argv[2]); return 1; }
+
+        _host((void*)_device);
+        return _failed;
+    }
+
+    pthread_t host;
+    _baud = C_TEST_BAUD;
+    setenv("HAL_NATIVE_PTY_BAUD", "1", 1);
+    unsetenv("HAL_NATIVE_PTY");
+
+    HAL_Init();
+    matlabCommunication_init();
+    uart_t* uart = uart_new(UART_4, _baud);
+    _matlabCom = matlabCommunication_new(uart);
+
+    const char* ptyName = halNative_uartPtyName(UART4);
+    if (!_matlabCom || !ptyName) return 1;
+
+    pthread_create(&host, NULL, _host, (void*)ptyName);
+    while (!_stop)
+    {
+        matlabCommunication_poll(_matlabCom);
+        __WFI();
+    }
+    pthread_join(host, NULL);
+
+    return _failed;
+}
@@ -0,0 +1,172 @@
+/***************************************************************************
+ * attitude_control.c
+ * Created on: 23-Oct-2026 14:00:00
+ * M. Schermutzki
+ ***************************************************************************/
+
+/*** includes **************************************************************/
+#include <stddef.h>
+#include <string.h>
+
+#include "attitude_control.h"
+
+/*** macros ***************************************************************/
+#define C_ATTITUDE_MIN_RATE_HZ  (50u)
+#define C_ATTITUDE_MAX_RATE_HZ  (4000u)
+#define C_ATTITUDE_HALF_TURN    (180 * C_FIXEDPOINT_ONE)
+
+/*** local variables ******************************************************/
+// X frame: sign of roll, pitch and yaw per motor (see attitude_control.h);
+// the clockwise motors 1 and 3 slow down to yaw clockwise
+static const int8_t _mix[C_ATTITUDE_MOTORS][E_ATTITUDE_AXIS_COUNT] =
+{
+    { +1, +1, -1 },   // 1 front left
+    { -1, +1, +1 },   // 2 front right
+    { -1, -1, -1 },   // 3 rear right
+    { +1, -1, +1 }    // 4 rear left
+};
+
+/*** functions ************************************************************/
+
+static inline q16_16_t _clamp(q16_16_t value, q16_16_t limit)
+{
+    if (value > limit) return limit;
+    if (value < -limit) return -limit;
+    return value;
+}
+
+/***************************************************************************
+ * Check the configuration, clear gains, set points and state
+ **************************************************************************/ 
+bool attitudeControl_init(attitude_control_t* control, const attitude_control_config_t* config)
+{
+    if (!control || !config) return false;
+    if (config->rateHz < C_ATTITUDE_MIN_RATE_HZ || config->rateHz > C_ATTITUDE_MAX_RATE_HZ) return false;
+    if (config->integralLimit < 0 || config->outputLimit < 0 || config->dFilterShift > 15u) return false;
+    if (config->motorMin > config->motorMax) return false;
+
+    memset(control, 0, sizeof(*control));
+    control->config = *config;
+    control->dtQ32 = (uint32_t)((((uint64_t)1 << 32) + config->rateHz / 2u) / config->rateHz);
+    return true;
+}
+
+void attitudeControl_reset(attitude_control_t* control)
+{
+    if (!control) return;
+
+    memset(control->integral, 0, sizeof(control->integral));
+    memset(control->rateFiltered, 0, sizeof(control->rateFiltered));
+    memset(control->terms, 0, sizeof(control->terms));
+    control->hasLastAngle = false;
+}
+
+void attitudeControl_setGains(attitude_control_t* control, attitude_control_axis_t axis, const attitude_control_gains_t* gains)
+{
+    if (!control || !gains || axis >= E_ATTITUDE_AXIS_COUNT) return;
+
+    control->gains[axis] = *gains;
+}
+
+void attitudeControl_setSetpoints(attitude_control_t* control, q16_16_t roll, q16_16_t pitch, q16_16_t yaw)
+{
+    if (!control) return;
+
+    control->setpoint[E_ATTITUDE_ROLL] = roll;
+    control->setpoint[E_ATTITUDE_PITCH] = pitch;
+    control->setpoint[E_ATTITUDE_YAW] = yaw;
+}
+
+void attitudeControl_setThrottle(attitude_control_t* control, q16_16_t throttle)
+{
+    if (control) control->throttle = throttle;
+}
+
+/***************************************************************************
+ * One axis: PID with clamped, conditionally frozen integrator and
+ * derivative on the filtered rate
+ **************************************************************************/ 
+static q16_16_t _updateAxis(attitude_control_t* control, uint8_t axis, q16_16_t angle, q16_16_t rate)
+{
+    const attitude_control_gains_t* gains = &control->gains[axis];
+    attitude_control_terms_t* terms = &control->terms[axis];
+    q16_16_t error = fixedPoint_sub(control->setpoint[axis], angle);
+
+    // shortest way round for yaw
+    if (axis == E_ATTITUDE_YAW)
+    {
+        if (error > C_ATTITUDE_HALF_TURN) error -= 2 * C_ATTITUDE_HALF_TURN;
+        else if (error < -C_ATTITUDE_HALF_TURN) error += 2 * C_ATTITUDE_HALF_TURN;
+    }
+
+    control->rateFiltered[axis] += (rate - control->rateFiltered[axis]) >> control->config.dFilterShift;
+
+    terms->p = fixedPoint_mul(gains->p, error);
+    terms->d = -fixedPoint_mul(gains->d, control->rateFiltered[axis]);
+
+    // ki * error * dt: Q16.16 * Q0.32 >> 16 -> Q16.32
+    int64_t limit = (int64_t)control->config.integralLimit << 16;
+    int64_t integral = control->integral[axis] + (((int64_t)fixedPoint_mul(gains->i, error) * control->dtQ32) >> 16);
+    if (integral > limit) integral = limit;
+    if (integral < -limit) integral = -limit;
+
+    q16_16_t i = (q16_16_t)(integral >> 16);
+    int64_t sum = (int64_t)terms->p + i + terms->d;
+    bool saturated = sum > control->config.outputLimit || sum < -control->config.outputLimit;
+
+    // anti-windup: no integration further into the saturation
+    if (!saturated || (sum > 0) != (error > 0))
+    {
+        control->integral[axis] = integral;
+    }
+
+    terms->i = (q16_16_t)(control->integral[axis] >> 16);
+    terms->output = _clamp(fixedPoint_saturate((int64_t)terms->p + terms->i + terms->d), control->config.outputLimit);
+    return terms->output;
+}
+
+/***************************************************************************
+ * All axes and the motor mix, once per period
+ **************************************************************************/ 
+void attitudeControl_update(attitude_control_t* control, const q16_16_t angles[E_ATTITUDE_AXIS_COUNT],
+                            const q16_16_t rates[E_ATTITUDE_AXIS_COUNT], uint8_t motors[C_ATTITUDE_MOTORS])
+{
+    if (!control || !angles || !motors) return;
+
+    q16_16_t output[E_ATTITUDE_AXIS_COUNT];
+
+    for (uint8_t axis = 0; axis < E_ATTITUDE_AXIS_COUNT; axis++)
+    {
+        q16_16_t rate;
+
+        if (rates != NULL)
+        {
+            rate = rates[axis];
+        }
+        else
+        {
+            // first update after a reset has no previous angle: rate 0
+            q16_16_t delta = control->hasLastAngle ? fixedPoint_sub(angles[axis], control->lastAngle[axis]) : 0;
+            rate = fixedPoint_saturate((int64_t)delta * control->config.rateHz);
+        }
+        control->lastAngle[axis] = angles[axis];
+        output[axis] = _updateAxis(control, axis, angles[axis], rate);
+    }
+    control->hasLastAngle = true;
+
+    q16_16_t low = fixedPoint_fromInt(control->config.motorMin);
+    q16_16_t high = fixedPoint_fromInt(control->config.motorMax);
+
+    for (uint8_t m = 0; m < C_ATTITUDE_MOTORS; m++)
+    {
+        int64_t value = control->throttle;
+
+        for (uint8_t axis = 0; axis < E_ATTITUDE_AXIS_COUNT; axis++)
+        {
+            value += (_mix[m][axis] > 0) ? output[axis] : -(int64_t)output[axis];
+        }
+        if (value < low) value = low;
+        if (value > high) value = high;
+        motors[m] = (uint8_t)fixedPoint_toInt((q16_16_t)value);
+    }
+}
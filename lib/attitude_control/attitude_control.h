@@ -0,0 +1,96 @@
+/*************************************************************************
+ * attitude_control.h
+ * Headerfile for attitude_control.c
+ * Created on: 23-Oct-2026 14:00:00
+ * M. Schermutzki
+ * Roll/pitch/yaw PID for the attitude practical, Q16.16 throughout (no
+ * FPU on the M3), no allocation: the caller owns the controller state.
+ * Per axis: error = set point - angle (yaw wrapped to +-180 deg),
+ *   P = kp * error
+ *   I = sum ki * error * dt, clamped to +-integralLimit and frozen while
+ *       the axis output is saturated in the direction of the error
+ *   D = -kd * rate, rate low-pass filtered (first order, 2^-dFilterShift),
+ *       on the measurement: set point steps give no derivative kick
+ * The axis outputs (motor units) are mixed into the four motors of an X
+ * frame around the throttle and clamped to motorMin..motorMax.
+ * Units: angles in deg, rates in deg/s, outputs and throttle in motor
+ * units (0..255 like motorData). Call attitudeControl_update() at exactly
+ * config.rateHz, dt is derived from it.
+ *************************************************************************/
+#ifndef ATTITUDE_CONTROL_H
+#define ATTITUDE_CONTROL_H
+
+/*** includes ************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "fixed_point.h"
+
+/*** macros *************************************************************/
+#define C_ATTITUDE_MOTORS  (4u)
+
+/*** definitions ********************************************************/
+typedef enum
+{
+    E_ATTITUDE_ROLL,     // positive: right side down
+    E_ATTITUDE_PITCH,    // positive: nose up
+    E_ATTITUDE_YAW,      // positive: nose right (clockwise seen from above)
+    E_ATTITUDE_AXIS_COUNT
+} attitude_control_axis_t;
+
+// motors of the X frame: 1 front left, 2 front right, 3 rear right,
+// 4 rear left; 1 and 3 turn clockwise (attitude_control.c: _mix)
+typedef struct
+{
+    uint32_t rateHz;            // update rate, 500..1000 Hz
+    q16_16_t integralLimit;     // |I| per axis, motor units
+    q16_16_t outputLimit;       // |P + I + D| per axis, motor units
+    uint8_t dFilterShift;       // derivative low-pass, 0: unfiltered
+    uint8_t motorMin;
+    uint8_t motorMax;
+} attitude_control_config_t;
+
+typedef struct
+{
+    q16_16_t p;
+    q16_16_t i;
+    q16_16_t d;
+} attitude_control_gains_t;
+
+// last terms per axis (flight recorder, tuning)
+typedef struct
+{
+    q16_16_t p;
+    q16_16_t i;
+    q16_16_t d;
+    q16_16_t output;            // P + I + D, limited
+} attitude_control_terms_t;
+
+typedef struct
+{
+    attitude_control_config_t config;
+    uint32_t dtQ32;             // 1 / rateHz in Q0.32
+    attitude_control_gains_t gains[E_ATTITUDE_AXIS_COUNT];
+    q16_16_t setpoint[E_ATTITUDE_AXIS_COUNT];
+    q16_16_t throttle;
+    int64_t integral[E_ATTITUDE_AXIS_COUNT];      // Q16.32, keeps increments below one LSB
+    q16_16_t rateFiltered[E_ATTITUDE_AXIS_COUNT];
+    q16_16_t lastAngle[E_ATTITUDE_AXIS_COUNT];    // rate from the angle if there is no gyro
+    bool hasLastAngle;
+    attitude_control_terms_t terms[E_ATTITUDE_AXIS_COUNT];
+} attitude_control_t;
+
+/*** functions ***********************************************************/
+bool attitudeControl_init(attitude_control_t* control, const attitude_control_config_t* config);
+void attitudeControl_reset(attitude_control_t* control);   // integrators and filters, e.g. on arming
+
+void attitudeControl_setGains(attitude_control_t* control, attitude_control_axis_t axis, const attitude_control_gains_t* gains);
+void attitudeControl_setSetpoints(attitude_control_t* control, q16_16_t roll, q16_16_t pitch, q16_16_t yaw);
+void attitudeControl_setThrottle(attitude_control_t* control, q16_16_t throttle);
+
+// angles[3] in deg; rates[3] in deg/s from the gyro, NULL: differentiated
+// angles; motors[4] out
+void attitudeControl_update(attitude_control_t* control, const q16_16_t angles[E_ATTITUDE_AXIS_COUNT],
+                            const q16_16_t rates[E_ATTITUDE_AXIS_COUNT], uint8_t motors[C_ATTITUDE_MOTORS]);
+
+#endif // ATTITUDE_CONTROL_H
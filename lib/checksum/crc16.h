@@ -13,12 +13,27 @@
 #include <stdbool.h>
 /*** local constants ******************************************************/
 /*** macros *************************************************************/
+// software implementation of crc16_calculateBuffer, value = bytes per step
+#define CRC16_IMPL_TABLE   (1)
+#define CRC16_IMPL_SLICE4  (4)
+#define CRC16_IMPL_SLICE8  (8)
+
+#ifndef C_CRC16_IMPL
+#define C_CRC16_IMPL  CRC16_IMPL_SLICE4
+#endif
+
+// slice tables compiled in, const in flash (benchmarks set 8 to compare all variants)
+#ifndef C_CRC16_MAX_SLICES
+#define C_CRC16_MAX_SLICES  C_CRC16_IMPL
+#endif
 /*** definitions ********************************************************/
 typedef struct crc16_s crc16_t;
 /*** local variables ******************************************************/
 /*** funcions *************************************************************/
 void crc16_reset(crc16_t* checksum);
 void crc16_calculate(crc16_t* checksum, uint8_t data);
+void crc16_calculateBuffer(crc16_t* checksum, const uint8_t* data, size_t len);
+uint16_t crc16_update(uint16_t crc, const uint8_t* data, size_t len, uint8_t slices);
 uint16_t crc16_get(crc16_t* checksum);
 void crc16_insertIntoDatagram(crc16_t* crc16, size_t outputSize, const char* input, char* output);
 
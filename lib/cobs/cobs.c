@@ -0,0 +1,70 @@
+/***************************************************************************
+ * cobs.c
+ * Created on: 17-Oct-2026 13:00:00
+ * M. Schermutzki
+ ***************************************************************************/
+#include "cobs.h"
+
+/*** functions **********************************************************************************/
+/************************************************************************************************
+ * This function encodes a block, returns the encoded length or 0 if the output is too small
+ ***********************************************************************************************/
+size_t cobs_encode(const uint8_t* input, size_t len, uint8_t* output, size_t outputSize)
+{
+    if (!input || !output || outputSize < COBS_ENCODED_MAX(len)) return 0;
+
+    size_t codeIdx = 0;
+    size_t outIdx = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        if (input[i] != 0)
+        {
+            output[outIdx++] = input[i];
+            code++;
+        }
+
+        if (input[i] == 0 || code == 0xFF)
+        {
+            output[codeIdx] = code;
+            codeIdx = outIdx++;
+            code = 1;
+        }
+    }
+
+    output[codeIdx] = code;
+    return outIdx;
+}
+/************************************************************************************************
+ * This function decodes a block (without delimiter), returns the decoded length or 0 on error
+ ***********************************************************************************************/
+size_t cobs_decode(const uint8_t* input, size_t len, uint8_t* output, size_t outputSize)
+{
+    if (!input || !output) return 0;
+
+    size_t inIdx = 0;
+    size_t outIdx = 0;
+
+    while (inIdx < len)
+    {
+        uint8_t code = input[inIdx++];
+
+        if (code == 0 || inIdx + code - 1u > len) return 0;
+
+        for (uint8_t i = 1; i < code; i++)
+        {
+            if (outIdx >= outputSize || input[inIdx] == 0) return 0;
+            output[outIdx++] = input[inIdx++];
+        }
+
+        // implicit zero, except after a full block and at the end
+        if (code != 0xFF && inIdx < len)
+        {
+            if (outIdx >= outputSize) return 0;
+            output[outIdx++] = 0;
+        }
+    }
+
+    return outIdx;
+}
@@ -0,0 +1,24 @@
+/*************************************************************************
+ * cobs.h
+ * Headerfile for cobs.c
+ * Created on: 17-Oct-2026 13:00:00
+ * M. Schermutzki
+ * Consistent Overhead Byte Stuffing: removes every 0x00 from a block so
+ * that 0x00 can be used as frame delimiter on the wire.
+ *************************************************************************/
+#ifndef COBS_H
+#define COBS_H
+
+/*** includes ************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/*** macros *************************************************************/
+// worst case encoded size of n bytes (without the 0x00 delimiter)
+#define COBS_ENCODED_MAX(n)  ((n) + ((n) / 254u) + 1u)
+
+/*** funcions *************************************************************/
+size_t cobs_encode(const uint8_t* input, size_t len, uint8_t* output, size_t outputSize);
+size_t cobs_decode(const uint8_t* input, size_t len, uint8_t* output, size_t outputSize);
+
+#endif // COBS_H
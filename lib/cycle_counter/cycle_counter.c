@@ -0,0 +1,52 @@
+/***************************************************************************
+ * cycle_counter.c
+ * Created on: 19-Oct-2026 09:00:00
+ * M. Schermutzki
+ ***************************************************************************/
+#if defined(HAL_NATIVE)
+#define _POSIX_C_SOURCE 200809L   // clock_gettime
+#endif
+
+/*** includes **************************************************************/
+#include "cycle_counter.h"
+#include "stm32f2xx_hal.h"
+
+#if defined(HAL_NATIVE)
+#include <time.h>
+#endif
+
+/*** functions ************************************************************/
+
+/***************************************************************************
+ * Enable the DWT cycle counter (trace must be on for CYCCNT to run)
+ **************************************************************************/ 
+void cycleCounter_init(void)
+{
+#if !defined(HAL_NATIVE)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+uint32_t cycleCounter_now(void)
+{
+#if defined(HAL_NATIVE)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t ns = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    return (uint32_t)(ns * (SystemCoreClock / 1000000u) / 1000u);
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+uint32_t cycleCounter_toUs(uint32_t cycles)
+{
+    return cycles / (SystemCoreClock / 1000000u);
+}
+
+uint32_t cycleCounter_perTick(void)
+{
+    return SystemCoreClock / 1000u;
+}
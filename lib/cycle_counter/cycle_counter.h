@@ -0,0 +1,23 @@
+/*************************************************************************
+ * cycle_counter.h
+ * Headerfile for cycle_counter.c
+ * Created on: 19-Oct-2026 09:00:00
+ * M. Schermutzki
+ * Free running 32 bit core cycle counter (DWT CYCCNT on the target,
+ * CLOCK_MONOTONIC scaled to SystemCoreClock in the native build).
+ * Differences of two readings are valid across one wrap (~35 s at
+ * 120 MHz).
+ *************************************************************************/
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+/*** includes ************************************************************/
+#include <stdint.h>
+
+/*** functions ***********************************************************/
+void cycleCounter_init(void);
+uint32_t cycleCounter_now(void);
+uint32_t cycleCounter_toUs(uint32_t cycles);
+uint32_t cycleCounter_perTick(void);   // cycles per HAL tick (1 ms)
+
+#endif // CYCLE_COUNTER_H
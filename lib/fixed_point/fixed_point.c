@@ -0,0 +1,41 @@
+/***************************************************************************
+ * fixed_point.c
+ * Created on: 18-Oct-2026 16:00:00
+ * M. Schermutzki
+ ***************************************************************************/
+
+/*** includes **************************************************************/
+#include "fixed_point.h"
+
+/*** functions ************************************************************/
+
+/***************************************************************************
+ * raw / scale as Q16.16, rounded to nearest (64 bit division, only done
+ * when a parameter arrives)
+ **************************************************************************/ 
+q16_16_t fixedPoint_fromScaled(int32_t raw, int32_t scale)
+{
+    if (scale <= 0) return 0;
+
+    int64_t numerator = (int64_t)raw * C_FIXEDPOINT_ONE;
+    int64_t half = scale / 2;
+
+    return fixedPoint_saturate((numerator >= 0) ? (numerator + half) / scale
+                                                : (numerator - half) / scale);
+}
+
+/***************************************************************************
+ * Q16.16 back to wire units (value * scale), rounded to nearest
+ **************************************************************************/ 
+int32_t fixedPoint_toScaled(q16_16_t value, int32_t scale)
+{
+    int64_t scaled = (int64_t)value * scale;
+    int64_t half = C_FIXEDPOINT_ONE / 2;
+
+    scaled = (scaled >= 0) ? (scaled + half) >> C_FIXEDPOINT_FRAC_BITS
+                           : -((-scaled + half) >> C_FIXEDPOINT_FRAC_BITS);
+
+    if (scaled > INT32_MAX) return INT32_MAX;
+    if (scaled < INT32_MIN) return INT32_MIN;
+    return (int32_t)scaled;
+}
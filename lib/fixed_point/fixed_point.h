@@ -0,0 +1,69 @@
+/*************************************************************************
+ * fixed_point.h
+ * Headerfile for fixed_point.c
+ * Created on: 18-Oct-2026 16:00:00
+ * M. Schermutzki
+ * Q16.16 fixed point for the parameter and control path (the Cortex-M3
+ * has no FPU, every double operation is a library call). Values coming
+ * from MATLAB stay exact integers in wire units (value * scale) and are
+ * converted once with fixedPoint_fromScaled().
+ *************************************************************************/
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+/*** includes ************************************************************/
+#include <stdint.h>
+
+/*** definitions ********************************************************/
+typedef int32_t q16_16_t;
+
+/*** macros *************************************************************/
+#define C_FIXEDPOINT_FRAC_BITS  (16)
+#define C_FIXEDPOINT_ONE        ((q16_16_t)1 << C_FIXEDPOINT_FRAC_BITS)
+#define C_FIXEDPOINT_MAX        ((q16_16_t)INT32_MAX)
+#define C_FIXEDPOINT_MIN        ((q16_16_t)INT32_MIN)
+
+// host side / debugging only, never in target code
+#define FIXEDPOINT_TO_DOUBLE(q) ((double)(q) / 65536.0)
+
+/*** functions ***********************************************************/
+q16_16_t fixedPoint_fromScaled(int32_t raw, int32_t scale);
+int32_t fixedPoint_toScaled(q16_16_t value, int32_t scale);
+
+static inline q16_16_t fixedPoint_saturate(int64_t value)
+{
+    if (value > C_FIXEDPOINT_MAX) return C_FIXEDPOINT_MAX;
+    if (value < C_FIXEDPOINT_MIN) return C_FIXEDPOINT_MIN;
+    return (q16_16_t)value;
+}
+
+static inline q16_16_t fixedPoint_fromInt(int32_t value)
+{
+    return fixedPoint_saturate((int64_t)value * C_FIXEDPOINT_ONE);
+}
+
+// rounds to nearest, ties away from zero
+static inline int32_t fixedPoint_toInt(q16_16_t value)
+{
+    return (value >= 0) ? (int32_t)(((int64_t)value + (C_FIXEDPOINT_ONE / 2)) >> C_FIXEDPOINT_FRAC_BITS)
+                        : -(int32_t)((-(int64_t)value + (C_FIXEDPOINT_ONE / 2)) >> C_FIXEDPOINT_FRAC_BITS);
+}
+
+static inline q16_16_t fixedPoint_add(q16_16_t a, q16_16_t b)
+{
+    return fixedPoint_saturate((int64_t)a + b);
+}
+
+static inline q16_16_t fixedPoint_sub(q16_16_t a, q16_16_t b)
+{
+    return fixedPoint_saturate((int64_t)a - b);
+}
+
+// 32x32 -> 64 bit (one SMULL on the M3), rounded and saturated
+static inline q16_16_t fixedPoint_mul(q16_16_t a, q16_16_t b)
+{
+    int64_t product = (int64_t)a * b;
+    return fixedPoint_saturate((product + (1 << (C_FIXEDPOINT_FRAC_BITS - 1))) >> C_FIXEDPOINT_FRAC_BITS);
+}
+
+#endif // FIXED_POINT_H
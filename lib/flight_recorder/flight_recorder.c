@@ -0,0 +1,178 @@
+/***************************************************************************
+ * flight_recorder.c
+ * Created on: 23-Oct-2026 09:00:00
+ * M. Schermutzki
+ ***************************************************************************/
+
+/*** includes **************************************************************/
+#include <string.h>
+
+#include "flight_recorder.h"
+#include "timebase.h"
+
+/*** definitions **********************************************************/
+_Static_assert(sizeof(flight_record_t) == 36u, "flight_record_t layout is part of the dump format");
+
+/*** local variables ******************************************************/
+static flight_record_t _records[C_FLIGHTREC_RECORDS];
+static flight_record_t _current;        // values for the next commit
+static uint32_t _head;                  // next slot
+static uint32_t _count;                 // valid records
+static uint32_t _sequence;
+static uint32_t _remaining;             // post trigger records still to record
+static uint32_t _postTrigger;
+static uint32_t _triggerSequence;       // sequence of the trigger record
+static bool _triggerPending;
+static uint8_t _triggerEvents;
+static flight_recorder_state_t _state = E_FLIGHTREC_IDLE;
+
+/*** functions ************************************************************/
+
+void flightRecorder_init(void)
+{
+    memset(&_current, 0, sizeof(_current));
+    _head = 0;
+    _count = 0;
+    _sequence = 0;
+    _triggerPending = false;
+    _state = E_FLIGHTREC_IDLE;
+    timebase_init();
+}
+
+void flightRecorder_setImu(int16_t x, int16_t y, int16_t z)
+{
+    _current.imu[0] = x;
+    _current.imu[1] = y;
+    _current.imu[2] = z;
+}
+
+void flightRecorder_setMotors(uint8_t motor1, uint8_t motor2, uint8_t motor3, uint8_t motor4)
+{
+    _current.motor[0] = motor1;
+    _current.motor[1] = motor2;
+    _current.motor[2] = motor3;
+    _current.motor[3] = motor4;
+}
+
+// Q16.16 -> Q8.8, saturated to +-128
+static int16_t _toQ8_8(q16_16_t value)
+{
+    int32_t q = value >> 8;
+
+    if (q > INT16_MAX) return INT16_MAX;
+    if (q < INT16_MIN) return INT16_MIN;
+    return (int16_t)q;
+}
+
+void flightRecorder_setPid(flight_recorder_axis_t axis, q16_16_t p, q16_16_t i, q16_16_t d)
+{
+    if (axis >= E_FLIGHTREC_AXIS_COUNT) return;
+
+    _current.pid[axis][0] = _toQ8_8(p);
+    _current.pid[axis][1] = _toQ8_8(i);
+    _current.pid[axis][2] = _toQ8_8(d);
+}
+
+void flightRecorder_setMode(uint8_t mode)
+{
+    _current.mode = mode;
+}
+
+/***************************************************************************
+ * Remember events for the next record; a selected one triggers it
+ **************************************************************************/ 
+void flightRecorder_event(uint8_t events)
+{
+    _current.events |= events;
+    if (_state == E_FLIGHTREC_ARMED && (events & _triggerEvents) != 0) _triggerPending = true;
+}
+
+/***************************************************************************
+ * Store the current values as the next record (control loop rate)
+ **************************************************************************/ 
+void flightRecorder_commit(void)
+{
+    if (_state != E_FLIGHTREC_ARMED && _state != E_FLIGHTREC_TRIGGERED) return;
+
+    if (_state == E_FLIGHTREC_ARMED && _triggerPending)
+    {
+        _current.events |= E_FLIGHTREC_EVENT_TRIGGER;
+        _triggerSequence = _sequence;
+        _remaining = _postTrigger;
+        _state = E_FLIGHTREC_TRIGGERED;
+    }
+
+    _current.timestampUs = timebase_nowUs();
+    _current.sequence = (uint16_t)_sequence++;
+    _records[_head] = _current;
+    _current.events = 0;
+
+    if (++_head >= C_FLIGHTREC_RECORDS) _head = 0;
+    if (_count < C_FLIGHTREC_RECORDS) _count++;
+
+    if (_state == E_FLIGHTREC_TRIGGERED && _remaining-- == 0) _state = E_FLIGHTREC_STOPPED;
+}
+
+/***************************************************************************
+ * Start a new recording (the old one is dropped)
+ **************************************************************************/ 
+bool flightRecorder_arm(uint32_t postTrigger, uint8_t triggerEvents)
+{
+    if (postTrigger >= C_FLIGHTREC_RECORDS) return false;
+
+    _head = 0;
+    _count = 0;
+    _postTrigger = postTrigger;
+    _triggerEvents = triggerEvents;
+    _triggerPending = false;
+    _current.events = 0;
+    _state = E_FLIGHTREC_ARMED;
+    return true;
+}
+
+void flightRecorder_trigger(void)
+{
+    if (_state == E_FLIGHTREC_ARMED) _triggerPending = true;
+}
+
+void flightRecorder_stop(void)
+{
+    if (_state == E_FLIGHTREC_ARMED || _state == E_FLIGHTREC_TRIGGERED) _state = E_FLIGHTREC_STOPPED;
+}
+
+void flightRecorder_getStatus(flight_recorder_status_t* status)
+{
+    if (!status) return;
+
+    status->state = (uint8_t)_state;
+    status->recordSize = (uint8_t)sizeof(flight_record_t);
+    status->capacity = C_FLIGHTREC_RECORDS;
+    status->count = _count;
+    status->sequence = _sequence;
+    status->triggerIndex = C_FLIGHTREC_NO_TRIGGER;
+
+    // the trigger record is still in the ring if it is one of the last _count
+    if (_state == E_FLIGHTREC_TRIGGERED || _state == E_FLIGHTREC_STOPPED)
+    {
+        uint32_t age = _sequence - _triggerSequence;   // 1: newest record
+        if (age >= 1u && age <= _count) status->triggerIndex = _count - age;
+    }
+}
+
+/***************************************************************************
+ * Copy records in dump order (0: oldest), straight from the ring; returns
+ * the number copied
+ **************************************************************************/ 
+size_t flightRecorder_read(uint32_t index, flight_record_t* records, size_t count)
+{
+    if (!records || index >= _count) return 0;
+    if (count > _count - index) count = _count - index;
+
+    uint32_t start = (_head + C_FLIGHTREC_RECORDS - _count + index) % C_FLIGHTREC_RECORDS;
+    size_t first = C_FLIGHTREC_RECORDS - start;
+    if (first > count) first = count;
+
+    memcpy(records, &_records[start], first * sizeof(flight_record_t));
+    memcpy(&records[first], &_records[0], (count - first) * sizeof(flight_record_t));
+    return count;
+}
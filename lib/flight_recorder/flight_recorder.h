@@ -0,0 +1,104 @@
+/*************************************************************************
+ * flight_recorder.h
+ * Headerfile for flight_recorder.c
+ * Created on: 23-Oct-2026 09:00:00
+ * M. Schermutzki
+ * Flight data recorder: a ring of fixed size records in SRAM, one record
+ * per control loop (flightRecorder_commit()), no UART involved. Producers
+ * update the current values (IMU, motors, PID terms, parser events), the
+ * control task commits them. Armed, the ring runs continuously; a trigger
+ * (command, API or a selected event) records postTrigger more records and
+ * freezes the ring for the dump (matlab_communication, CMD 0x0C).
+ * All functions from task context (the scheduler is cooperative).
+ *************************************************************************/
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+/*** includes ************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "fixed_point.h"
+
+/*** macros *************************************************************/
+#ifndef C_FLIGHTREC_RECORDS
+#define C_FLIGHTREC_RECORDS     (1024u)   // 36 KiB, ~2 s at 500 Hz
+#endif
+
+#define C_FLIGHTREC_NO_TRIGGER  (0xFFFFFFFFu)
+
+/*** definitions ********************************************************/
+// parser and recorder events, OR-ed into the next record
+typedef enum
+{
+    E_FLIGHTREC_EVENT_FRAME_OK     = 0x01,
+    E_FLIGHTREC_EVENT_CRC_ERROR    = 0x02,
+    E_FLIGHTREC_EVENT_INVALID_SIGN = 0x04,   // bad sign, short or undecodable frame
+    E_FLIGHTREC_EVENT_UNKNOWN_CMD  = 0x08,
+    E_FLIGHTREC_EVENT_RESYNC       = 0x10,
+    E_FLIGHTREC_EVENT_NACK         = 0x20,
+    E_FLIGHTREC_EVENT_TRIGGER      = 0x80    // this record is the trigger
+} flight_recorder_event_t;
+
+typedef enum
+{
+    E_FLIGHTREC_AXIS_ROLL,
+    E_FLIGHTREC_AXIS_PITCH,
+    E_FLIGHTREC_AXIS_YAW,
+    E_FLIGHTREC_AXIS_COUNT
+} flight_recorder_axis_t;
+
+typedef enum
+{
+    E_FLIGHTREC_IDLE,        // nothing recorded since init/stop
+    E_FLIGHTREC_ARMED,       // recording, waiting for the trigger
+    E_FLIGHTREC_TRIGGERED,   // recording the post trigger records
+    E_FLIGHTREC_STOPPED      // frozen, ready for the dump
+} flight_recorder_state_t;
+
+// one record, little endian and dumped as it is; the host decoder
+// (matlab/readFlightRecorder.m) depends on this layout
+typedef struct
+{
+    uint32_t timestampUs;    // timebase_nowUs() at the commit
+    uint16_t sequence;       // committed records, low 16 bits (gaps, order)
+    uint8_t events;          // flight_recorder_event_t bits since the last record
+    uint8_t mode;            // set by the application (active practical)
+    int16_t imu[3];          // raw sensor values x, y, z
+    uint8_t motor[4];        // motor outputs (motorData)
+    int16_t pid[E_FLIGHTREC_AXIS_COUNT][3];   // P, I, D term per axis, Q8.8
+} flight_record_t;
+
+typedef struct
+{
+    uint8_t state;           // flight_recorder_state_t
+    uint8_t recordSize;
+    uint32_t capacity;
+    uint32_t count;          // valid records
+    uint32_t triggerIndex;   // of the trigger record in dump order, C_FLIGHTREC_NO_TRIGGER: none
+    uint32_t sequence;       // records committed since init
+} flight_recorder_status_t;
+
+/*** functions ***********************************************************/
+void flightRecorder_init(void);
+
+// current values, taken by the next commit
+void flightRecorder_setImu(int16_t x, int16_t y, int16_t z);
+void flightRecorder_setMotors(uint8_t motor1, uint8_t motor2, uint8_t motor3, uint8_t motor4);
+void flightRecorder_setPid(flight_recorder_axis_t axis, q16_16_t p, q16_16_t i, q16_16_t d);
+void flightRecorder_setMode(uint8_t mode);
+void flightRecorder_event(uint8_t events);
+
+void flightRecorder_commit(void);   // once per control loop
+
+// postTrigger: records after the trigger record (at most capacity - 1);
+// triggerEvents: events that trigger on their own, 0: only by command/API
+bool flightRecorder_arm(uint32_t postTrigger, uint8_t triggerEvents);
+void flightRecorder_trigger(void);
+void flightRecorder_stop(void);
+
+void flightRecorder_getStatus(flight_recorder_status_t* status);
+size_t flightRecorder_read(uint32_t index, flight_record_t* records, size_t count);   // index 0: oldest
+
+#endif // FLIGHT_RECORDER_H
@@ -0,0 +1,768 @@
+/**************************************************************************
+ * hal_native.c
+ * Created on: 18-Oct-2026 09:00:00
+ * M. Schermutzki
+ * Single threaded simulation: bytes, TX completions and ticks are turned
+ * into calls of the IRQ handlers from halNative_service(), which runs from
+ * HAL_GetTick(), HAL_Delay(), __WFI() and __enable_irq().
+ **************************************************************************/
+#define _GNU_SOURCE
+
+/*** includes *************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <termios.h>
+
+// termios.h defines CR1..CR3 (newline delays), they collide with the USART registers
+#undef CR1
+#undef CR2
+#undef CR3
+
+#include "hal_native.h"
+
+/*** macros ***************************************************************/
+#define C_HALNATIVE_PORTS        (6u)
+#define C_HALNATIVE_DMA_STREAMS  (16u)
+#define C_HALNATIVE_STREAM_SIZE  (8192u)
+#define C_HALNATIVE_MAX_TICKS    (100u)   // catch-up limit per service call
+
+#define C_HALNATIVE_BAUD_TOLERANCE_PCT  (3u)  // more deviation -> bytes are garbage
+#define C_HALNATIVE_GARBLE_MASK  (0x5Au)
+
+#define C_HALNATIVE_DMA_FLAG_HT  (0x01u)
+#define C_HALNATIVE_DMA_FLAG_TC  (0x02u)
+
+/*** definitions **********************************************************/
+typedef struct
+{
+    uint8_t data[C_HALNATIVE_STREAM_SIZE];
+    size_t head;
+    size_t count;
+} _stream_t;
+
+typedef struct
+{
+    UART_HandleTypeDef* huart;
+    _stream_t input;
+    _stream_t output;
+    int ptyFd;
+    char ptyName[64];
+    bool rxDma;
+    bool txDonePending;
+    uint64_t rxLastNs;      // RX is paced to the baud rate from here
+    uint32_t errorPending;
+} _port_t;
+
+/*** weak vectors / callbacks (overridden by the application) ************/
+void USART1_IRQHandler(void) __attribute__((weak));
+void USART2_IRQHandler(void) __attribute__((weak));
+void USART3_IRQHandler(void) __attribute__((weak));
+void UART4_IRQHandler(void) __attribute__((weak));
+void UART5_IRQHandler(void) __attribute__((weak));
+void USART6_IRQHandler(void) __attribute__((weak));
+void DMA1_Stream0_IRQHandler(void) __attribute__((weak));
+void DMA1_Stream1_IRQHandler(void) __attribute__((weak));
+void DMA1_Stream2_IRQHandler(void) __attribute__((weak));
+void DMA1_Stream3_IRQHandler(void) __attribute__((weak));
+void DMA1_Stream4_IRQHandler(void) __attribute__((weak));
+void DMA1_Stream5_IRQHandler(void) __attribute__((weak));
+void DMA1_Stream6_IRQHandler(void) __attribute__((weak));
+void DMA1_Stream7_IRQHandler(void) __attribute__((weak));
+void DMA2_Stream0_IRQHandler(void) __attribute__((weak));
+void DMA2_Stream1_IRQHandler(void) __attribute__((weak));
+void DMA2_Stream2_IRQHandler(void) __attribute__((weak));
+void DMA2_Stream3_IRQHandler(void) __attribute__((weak));
+void DMA2_Stream4_IRQHandler(void) __attribute__((weak));
+void DMA2_Stream5_IRQHandler(void) __attribute__((weak));
+void DMA2_Stream6_IRQHandler(void) __attribute__((weak));
+void DMA2_Stream7_IRQHandler(void) __attribute__((weak));
+void SysTick_Handler(void) __attribute__((weak));
+
+void USART1_IRQHandler(void) {}
+void USART2_IRQHandler(void) {}
+void USART3_IRQHandler(void) {}
+void UART4_IRQHandler(void) {}
+void UART5_IRQHandler(void) {}
+void USART6_IRQHandler(void) {}
+void DMA1_Stream0_IRQHandler(void) {}
+void DMA1_Stream1_IRQHandler(void) {}
+void DMA1_Stream2_IRQHandler(void) {}
+void DMA1_Stream3_IRQHandler(void) {}
+void DMA1_Stream4_IRQHandler(void) {}
+void DMA1_Stream5_IRQHandler(void) {}
+void DMA1_Stream6_IRQHandler(void) {}
+void DMA1_Stream7_IRQHandler(void) {}
+void DMA2_Stream0_IRQHandler(void) {}
+void DMA2_Stream1_IRQHandler(void) {}
+void DMA2_Stream2_IRQHandler(void) {}
+void DMA2_Stream3_IRQHandler(void) {}
+void DMA2_Stream4_IRQHandler(void) {}
+void DMA2_Stream5_IRQHandler(void) {}
+void DMA2_Stream6_IRQHandler(void) {}
+void DMA2_Stream7_IRQHandler(void) {}
+void SysTick_Handler(void) { HAL_IncTick(); }
+
+__attribute__((weak)) void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) { (void)huart; }
+__attribute__((weak)) void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart) { (void)huart; }
+__attribute__((weak)) void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef* huart) { (void)huart; }
+__attribute__((weak)) void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart) { (void)huart; }
+
+/*** local constants ******************************************************/
+static void (*const _uartVectors[C_HALNATIVE_PORTS])(void) = {
+    USART1_IRQHandler, USART2_IRQHandler, USART3_IRQHandler,
+    UART4_IRQHandler, UART5_IRQHandler, USART6_IRQHandler
+};
+
+static void (*const _dmaVectors[C_HALNATIVE_DMA_STREAMS])(void) = {
+    DMA1_Stream0_IRQHandler, DMA1_Stream1_IRQHandler, DMA1_Stream2_IRQHandler, DMA1_Stream3_IRQHandler,
+    DMA1_Stream4_IRQHandler, DMA1_Stream5_IRQHandler, DMA1_Stream6_IRQHandler, DMA1_Stream7_IRQHandler,
+    DMA2_Stream0_IRQHandler, DMA2_Stream1_IRQHandler, DMA2_Stream2_IRQHandler, DMA2_Stream3_IRQHandler,
+    DMA2_Stream4_IRQHandler, DMA2_Stream5_IRQHandler, DMA2_Stream6_IRQHandler, DMA2_Stream7_IRQHandler
+};
+
+static const char* const _portNames[C_HALNATIVE_PORTS] = {
+    "USART1", "USART2", "USART3", "UART4", "UART5", "USART6"
+};
+
+/*** global variables (peripheral "registers") ***************************/
+uint32_t SystemCoreClock = 120000000u;
+GPIO_TypeDef halNative_gpio[9];
+DMA_Stream_TypeDef halNative_dmaStream[C_HALNATIVE_DMA_STREAMS];
+USART_TypeDef halNative_usart[C_HALNATIVE_PORTS];
+
+/*** local variables ******************************************************/
+static _port_t _ports[C_HALNATIVE_PORTS] = {
+    {.ptyFd = -1}, {.ptyFd = -1}, {.ptyFd = -1}, {.ptyFd = -1}, {.ptyFd = -1}, {.ptyFd = -1}
+};
+static volatile uint32_t _tick = 0;
+static uint64_t _lastTickNs = 0;
+static uint32_t _primask = 0;
+static bool _inService = false;
+static bool _modelBaudRate = false;   // HAL_NATIVE_PTY_BAUD=1
+
+/*** prototypes ***********************************************************/
+static uint64_t _nowNs(void);
+static _port_t* _portOf(const USART_TypeDef* instance);
+static size_t _streamPush(_stream_t* stream, const uint8_t* data, size_t len);
+static bool _streamPop(_stream_t* stream, uint8_t* data);
+static void _openPty(_port_t* port, size_t index);
+static void _emit(_port_t* port, const uint8_t* data, size_t len);
+static uint32_t _speedToBaud(speed_t speed);
+static bool _baudMismatch(const _port_t* port);
+static void _garble(uint8_t* data, size_t len);
+static void _serviceTicks(void);
+static void _servicePort(size_t index);
+static size_t _rxBudget(_port_t* port);
+static void _raiseDma(DMA_HandleTypeDef* hdma, uint32_t flags);
+
+/*** helpers **************************************************************/
+static uint64_t _nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static _port_t* _portOf(const USART_TypeDef* instance)
+{
+    if (instance < &halNative_usart[0] || instance >= &halNative_usart[C_HALNATIVE_PORTS]) return NULL;
+    return &_ports[instance - &halNative_usart[0]];
+}
+
+static size_t _streamPush(_stream_t* stream, const uint8_t* data, size_t len)
+{
+    size_t n = 0;
+    while (n < len && stream->count < C_HALNATIVE_STREAM_SIZE)
+    {
+        stream->data[(stream->head + stream->count) % C_HALNATIVE_STREAM_SIZE] = data[n++];
+        stream->count++;
+    }
+    return n;
+}
+
+static bool _streamPop(_stream_t* stream, uint8_t* data)
+{
+    if (stream->count == 0) return false;
+
+    *data = stream->data[stream->head];
+    stream->head = (stream->head + 1u) % C_HALNATIVE_STREAM_SIZE;
+    stream->count--;
+    return true;
+}
+
+/*************************************************************************
+ * pty per port, kept open over DeInit/Init (baud rate changes)
+ ************************************************************************/ 
+static void _openPty(_port_t* port, size_t index)
+{
+    const char* enabled = getenv("HAL_NATIVE_PTY");
+    if (port->ptyFd >= 0 || (enabled && strcmp(enabled, "0") == 0)) return;
+
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0)
+    {
+        if (fd >= 0) close(fd);
+        return;
+    }
+
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    port->ptyFd = fd;
+    snprintf(port->ptyName, sizeof(port->ptyName), "%s", ptsname(fd));
+
+    const char* modelBaud = getenv("HAL_NATIVE_PTY_BAUD");
+    _modelBaudRate = modelBaud && strcmp(modelBaud, "1") == 0;
+
+    const char* linkPrefix = getenv("HAL_NATIVE_PTY_LINK");
+    if (linkPrefix)
+    {
+        char link[128];
+        snprintf(link, sizeof(link), "%s%s", linkPrefix, _portNames[index]);
+        unlink(link);
+        if (symlink(port->ptyName, link) == 0) fprintf(stderr, "hal_native: %s -> %s\n", link, port->ptyName);
+    }
+    fprintf(stderr, "hal_native: %s on %s\n", _portNames[index], port->ptyName);
+}
+
+/*************************************************************************
+ * Baud rate model: the host's side of the pty has a speed (tcsetattr on
+ * the slave, visible through the master). If it differs from the UART's
+ * rate, bytes are garbled in both directions, as on a real wire.
+ ************************************************************************/ 
+static uint32_t _speedToBaud(speed_t speed)
+{
+    static const struct { speed_t speed; uint32_t baud; } map[] = {
+        {B9600, 9600u}, {B19200, 19200u}, {B38400, 38400u}, {B57600, 57600u},
+        {B115200, 115200u}, {B230400, 230400u}, {B460800, 460800u}, {B500000, 500000u},
+        {B576000, 576000u}, {B921600, 921600u}, {B1000000, 1000000u}, {B1152000, 1152000u},
+        {B1500000, 1500000u}, {B2000000, 2000000u}, {B2500000, 2500000u}, {B3000000, 3000000u},
+        {B3500000, 3500000u}, {B4000000, 4000000u}
+    };
+
+    for (size_t i = 0; i < sizeof(map) / sizeof(map[0]); i++)
+    {
+        if (map[i].speed == speed) return map[i].baud;
+    }
+    return 0;
+}
+
+static bool _baudMismatch(const _port_t* port)
+{
+    struct termios tio;
+
+    if (!_modelBaudRate || port->ptyFd < 0 || !port->huart) return false;
+    if (tcgetattr(port->ptyFd, &tio) != 0) return false;
+
+    uint32_t host = _speedToBaud(cfgetospeed(&tio));
+    uint32_t uart = port->huart->Init.BaudRate;
+    uint32_t diff = (host > uart) ? host - uart : uart - host;
+
+    return host != 0 && (uint64_t)diff * 100u > (uint64_t)uart * C_HALNATIVE_BAUD_TOLERANCE_PCT;
+}
+
+static void _garble(uint8_t* data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) data[i] ^= C_HALNATIVE_GARBLE_MASK;
+}
+
+static void _emit(_port_t* port, const uint8_t* data, size_t len)
+{
+    if (port->ptyFd >= 0)
+    {
+        uint8_t buffer[256];
+
+        // nobody listening on the slave side -> bytes are simply lost, like on a wire
+        while (len > 0)
+        {
+            size_t chunk = len < sizeof(buffer) ? len : sizeof(buffer);
+            memcpy(buffer, data, chunk);
+            if (_baudMismatch(port)) _garble(buffer, chunk);
+
+            ssize_t written = write(port->ptyFd, buffer, chunk);
+            (void)written;
+            data += chunk;
+            len -= chunk;
+        }
+    }
+    else
+    {
+        _streamPush(&port->output, data, len);
+    }
+}
+
+/*** core / system ********************************************************/
+HAL_StatusTypeDef HAL_Init(void)
+{
+    _lastTickNs = _nowNs();
+    return HAL_OK;
+}
+
+void HAL_IncTick(void)
+{
+    _tick++;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    halNative_service();
+    return _tick;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    uint32_t start = HAL_GetTick();
+    while ((HAL_GetTick() - start) < Delay)
+    {
+        __WFI();
+    }
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    (void)IRQn; (void)PreemptPriority; (void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) { (void)IRQn; }
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn) { (void)IRQn; }
+
+uint32_t __get_PRIMASK(void) { return _primask; }
+uint32_t __get_IPSR(void) { return _inService ? 1u : 0u; }
+void __disable_irq(void) { _primask = 1u; }
+
+void __set_PRIMASK(uint32_t priMask)
+{
+    _primask = priMask & 1u;
+    if (!_primask) halNative_service();
+}
+
+void __enable_irq(void)
+{
+    __set_PRIMASK(0u);
+}
+
+/*************************************************************************
+ * Sleep until a pty has data or the next tick is due
+ ************************************************************************/ 
+void __WFI(void)
+{
+    struct pollfd fds[C_HALNATIVE_PORTS];
+    nfds_t n = 0;
+
+    for (size_t i = 0; i < C_HALNATIVE_PORTS; i++)
+    {
+        if (_ports[i].ptyFd < 0) continue;
+        fds[n].fd = _ports[i].ptyFd;
+        fds[n].events = POLLIN;
+        n++;
+    }
+
+    if (n > 0) poll(fds, n, 1);
+    else       usleep(1000);
+
+    halNative_service();
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void) { return SystemCoreClock / 4u; }
+uint32_t HAL_RCC_GetPCLK2Freq(void) { return SystemCoreClock / 2u; }
+
+void HAL_GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_Init)
+{
+    (void)GPIOx; (void)GPIO_Init;
+}
+
+/*** DMA ******************************************************************/
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef* hdma)
+{
+    if (!hdma || !hdma->Instance) return HAL_ERROR;
+
+    hdma->Instance->NDTR = 0;
+    hdma->pendingFlags = 0;
+    return HAL_OK;
+}
+
+static void _raiseDma(DMA_HandleTypeDef* hdma, uint32_t flags)
+{
+    hdma->pendingFlags |= flags;
+    _dmaVectors[hdma->Instance - &halNative_dmaStream[0]]();
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef* hdma)
+{
+    if (!hdma) return;
+
+    uint32_t flags = hdma->pendingFlags;
+    UART_HandleTypeDef* huart = (UART_HandleTypeDef*)hdma->Parent;
+    hdma->pendingFlags = 0;
+
+    // TX completion is reported through the UART TC interrupt, as on the target
+    if (!huart || hdma->Init.Direction != DMA_PERIPH_TO_MEMORY) return;
+
+    if (flags & C_HALNATIVE_DMA_FLAG_HT) HAL_UART_RxHalfCpltCallback(huart);
+    if (flags & C_HALNATIVE_DMA_FLAG_TC) HAL_UART_RxCpltCallback(huart);
+}
+
+/*** UART *****************************************************************/
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef* huart)
+{
+    if (!huart) return HAL_ERROR;
+
+    _port_t* port = _portOf(huart->Instance);
+    if (!port) return HAL_ERROR;
+
+    port->huart = huart;
+    port->rxDma = false;
+    port->txDonePending = false;
+    port->errorPending = 0;
+
+    huart->Instance->SR = UART_FLAG_TC;
+    huart->Instance->CR1 = 0;
+    huart->Instance->BRR = huart->Init.BaudRate;
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+
+    _openPty(port, (size_t)(port - _ports));
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef* huart)
+{
+    _port_t* port = huart ? _portOf(huart->Instance) : NULL;
+    if (!port) return HAL_ERROR;
+
+    port->rxDma = false;
+    port->txDonePending = false;
+    huart->gState = HAL_UART_STATE_RESET;
+    huart->RxState = HAL_UART_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+    _port_t* port = huart ? _portOf(huart->Instance) : NULL;
+
+    if (!port || !pData) return HAL_ERROR;
+    if (huart->gState != HAL_UART_STATE_READY) return HAL_BUSY;
+
+    _emit(port, pData, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size)
+{
+    _port_t* port = huart ? _portOf(huart->Instance) : NULL;
+
+    if (!port || !pData || Size == 0) return HAL_ERROR;
+    if (huart->gState != HAL_UART_STATE_READY) return HAL_BUSY;
+
+    // bytes leave at once, the completion interrupt follows on the next service
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    huart->pTxBuffPtr = pData;
+    huart->TxXferSize = Size;
+    huart->TxXferCount = 0;
+    _emit(port, pData, Size);
+    port->txDonePending = true;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size)
+{
+    return HAL_UART_Transmit_IT(huart, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size)
+{
+    _port_t* port = huart ? _portOf(huart->Instance) : NULL;
+
+    if (!port || !pData || Size == 0) return HAL_ERROR;
+    if (huart->RxState != HAL_UART_STATE_READY) return HAL_BUSY;
+
+    huart->pRxBuffPtr = pData;
+    huart->RxXferSize = Size;
+    huart->RxXferCount = Size;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    port->rxDma = false;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size)
+{
+    _port_t* port = huart ? _portOf(huart->Instance) : NULL;
+
+    if (!port || !pData || Size == 0 || !huart->hdmarx) return HAL_ERROR;
+    if (huart->RxState != HAL_UART_STATE_READY) return HAL_BUSY;
+
+    huart->pRxBuffPtr = pData;
+    huart->RxXferSize = Size;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    huart->hdmarx->Instance->NDTR = Size;
+    huart->hdmarx->pendingFlags = 0;
+    port->rxDma = true;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_DMAStop(UART_HandleTypeDef* huart)
+{
+    _port_t* port = huart ? _portOf(huart->Instance) : NULL;
+    if (!port) return HAL_ERROR;
+
+    port->rxDma = false;
+    huart->RxState = HAL_UART_STATE_READY;
+    if (huart->hdmatx && huart->gState == HAL_UART_STATE_BUSY_TX)
+    {
+        port->txDonePending = false;
+        huart->gState = HAL_UART_STATE_READY;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef* huart)
+{
+    _port_t* port = huart ? _portOf(huart->Instance) : NULL;
+    if (!port) return HAL_ERROR;
+
+    port->rxDma = false;
+    huart->RxXferCount = 0;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+uint32_t HAL_UART_GetError(UART_HandleTypeDef* huart)
+{
+    return huart ? huart->ErrorCode : HAL_UART_ERROR_NONE;
+}
+
+/*************************************************************************
+ * Same order as the HAL: errors, RXNE, TC
+ ************************************************************************/ 
+void HAL_UART_IRQHandler(UART_HandleTypeDef* huart)
+{
+    _port_t* port = huart ? _portOf(huart->Instance) : NULL;
+    if (!port) return;
+
+    if (port->errorPending)
+    {
+        huart->ErrorCode |= port->errorPending;
+        port->errorPending = 0;
+        huart->Instance->SR &= ~(UART_FLAG_PE | UART_FLAG_FE | UART_FLAG_NE | UART_FLAG_ORE | UART_FLAG_RXNE);
+
+        // blocking error: reception is aborted, the application has to re-arm it
+        port->rxDma = false;
+        huart->RxState = HAL_UART_STATE_READY;
+        HAL_UART_ErrorCallback(huart);
+        return;
+    }
+
+    if (huart->Instance->SR & UART_FLAG_RXNE)
+    {
+        huart->Instance->SR &= ~UART_FLAG_RXNE;
+
+        if (huart->RxState == HAL_UART_STATE_BUSY_RX && !port->rxDma && huart->RxXferCount > 0)
+        {
+            *huart->pRxBuffPtr++ = (uint8_t)huart->Instance->DR;
+            if (--huart->RxXferCount == 0)
+            {
+                huart->RxState = HAL_UART_STATE_READY;
+                HAL_UART_RxCpltCallback(huart);
+            }
+        }
+    }
+
+    if (port->txDonePending)
+    {
+        port->txDonePending = false;
+        huart->gState = HAL_UART_STATE_READY;
+        HAL_UART_TxCpltCallback(huart);
+    }
+}
+
+/*** simulation ***********************************************************/
+static void _serviceTicks(void)
+{
+    uint64_t now = _nowNs();
+    uint32_t ticks = 0;
+
+    if (_lastTickNs == 0) _lastTickNs = now;
+
+    while (now - _lastTickNs >= 1000000ull && ticks < C_HALNATIVE_MAX_TICKS)
+    {
+        _lastTickNs += 1000000ull;
+        ticks++;
+        SysTick_Handler();
+    }
+
+    // far behind (debugger, suspended process): drop the missed ticks
+    if (ticks == C_HALNATIVE_MAX_TICKS) _lastTickNs = now;
+}
+
+/*************************************************************************
+ * Bytes the line could have delivered since the last service (8N1 = 10
+ * bit times per byte), so bursts from the host do not arrive faster than
+ * on the real wire
+ ************************************************************************/ 
+static size_t _rxBudget(_port_t* port)
+{
+    uint64_t now = _nowNs();
+    uint64_t baudRate = port->huart->Init.BaudRate;
+
+    if (port->input.count == 0 || baudRate == 0)
+    {
+        port->rxLastNs = now;
+        return 0;
+    }
+
+    uint64_t bytes = (now - port->rxLastNs) * baudRate / 10000000000ull;
+    port->rxLastNs += bytes * 10000000000ull / baudRate;
+    return (size_t)bytes;
+}
+
+static void _servicePort(size_t index)
+{
+    _port_t* port = &_ports[index];
+    UART_HandleTypeDef* huart = port->huart;
+
+    if (port->input.count == 0) port->rxLastNs = _nowNs();
+
+    if (port->ptyFd >= 0)
+    {
+        uint8_t buffer[256];
+        size_t space = C_HALNATIVE_STREAM_SIZE - port->input.count;
+        ssize_t n = read(port->ptyFd, buffer, space < sizeof(buffer) ? space : sizeof(buffer));
+        if (n > 0)
+        {
+            if (_baudMismatch(port)) _garble(buffer, (size_t)n);
+            _streamPush(&port->input, buffer, (size_t)n);
+        }
+    }
+
+    if (port->errorPending)
+    {
+        _uartVectors[index]();
+    }
+
+    bool received = false;
+    size_t budget = _rxBudget(port);
+    uint8_t byte;
+
+    if (port->rxDma)
+    {
+        DMA_HandleTypeDef* hdma = huart->hdmarx;
+
+        while (port->rxDma && budget > 0 && _streamPop(&port->input, &byte))
+        {
+            budget--;
+            uint32_t size = huart->RxXferSize;
+            huart->pRxBuffPtr[size - hdma->Instance->NDTR] = byte;
+            hdma->Instance->NDTR--;
+            received = true;
+
+            if (hdma->Instance->NDTR == size / 2u)
+            {
+                _raiseDma(hdma, C_HALNATIVE_DMA_FLAG_HT);
+            }
+            else if (hdma->Instance->NDTR == 0)
+            {
+                if (hdma->Init.Mode == DMA_CIRCULAR)
+                {
+                    hdma->Instance->NDTR = size;
+                }
+                else
+                {
+                    port->rxDma = false;
+                    huart->RxState = HAL_UART_STATE_READY;
+                }
+                _raiseDma(hdma, C_HALNATIVE_DMA_FLAG_TC);
+            }
+        }
+    }
+    else
+    {
+        // bytes wait in the stream until a receive is armed
+        while (huart->RxState == HAL_UART_STATE_BUSY_RX && !port->rxDma && budget > 0 && _streamPop(&port->input, &byte))
+        {
+            budget--;
+            huart->Instance->DR = byte;
+            huart->Instance->SR |= UART_FLAG_RXNE;
+            received = true;
+            _uartVectors[index]();
+        }
+    }
+
+    // burst over -> line idle
+    if (received && port->input.count == 0)
+    {
+        huart->Instance->SR |= UART_FLAG_IDLE;
+        if (huart->Instance->CR1 & UART_IT_IDLE) _uartVectors[index]();
+    }
+
+    if (port->txDonePending)
+    {
+        _uartVectors[index]();
+    }
+}
+
+void halNative_service(void)
+{
+    if (_primask || _inService) return;
+    _inService = true;
+
+    _serviceTicks();
+
+    for (size_t i = 0; i < C_HALNATIVE_PORTS; i++)
+    {
+        if (_ports[i].huart && _ports[i].huart->gState != HAL_UART_STATE_RESET)
+        {
+            _servicePort(i);
+        }
+    }
+
+    _inService = false;
+}
+
+/*** host hooks ***********************************************************/
+bool halNative_uartInject(USART_TypeDef* instance, const uint8_t* data, size_t len)
+{
+    _port_t* port = _portOf(instance);
+    if (!port || !data) return false;
+
+    return _streamPush(&port->input, data, len) == len;
+}
+
+void halNative_uartInjectError(USART_TypeDef* instance, uint32_t errorCode)
+{
+    _port_t* port = _portOf(instance);
+    if (port) port->errorPending |= errorCode;
+}
+
+size_t halNative_uartTakeOutput(USART_TypeDef* instance, uint8_t* data, size_t maxLen)
+{
+    _port_t* port = _portOf(instance);
+    size_t n = 0;
+
+    if (!port || !data) return 0;
+
+    while (n < maxLen && _streamPop(&port->output, &data[n])) n++;
+    return n;
+}
+
+const char* halNative_uartPtyName(USART_TypeDef* instance)
+{
+    _port_t* port = _portOf(instance);
+    if (!port || port->ptyFd < 0) return NULL;
+    return port->ptyName;
+}
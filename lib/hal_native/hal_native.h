@@ -0,0 +1,34 @@
+/*************************************************************************
+ * hal_native.h
+ * Headerfile for hal_native.c
+ * Created on: 18-Oct-2026 09:00:00
+ * M. Schermutzki
+ * Host side of the HAL stand-in: feed and drain the simulated UARTs and
+ * run the pending "interrupts". Every port gets an in-memory stream; a
+ * pty is opened per initialised port unless HAL_NATIVE_PTY=0 is set
+ * (HAL_NATIVE_PTY_LINK=<prefix> adds a symlink <prefix><PORT>, e.g.
+ * /tmp/tty -> /tmp/ttyUART4). HAL_NATIVE_PTY_BAUD=1 garbles the bytes
+ * while the speed set on the pty differs from the UART's baud rate, so
+ * baud rate switches have to be followed by the host.
+ *************************************************************************/
+#ifndef HAL_NATIVE_H
+#define HAL_NATIVE_H
+
+/*** includes ************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "stm32f2xx_hal.h"
+
+/*** functions ***********************************************************/
+// deliver pending RX bytes, TX completions and ticks to the ISRs
+void halNative_service(void);
+
+// in-memory streams; output is only captured while the port has no pty
+bool halNative_uartInject(USART_TypeDef* instance, const uint8_t* data, size_t len);
+void halNative_uartInjectError(USART_TypeDef* instance, uint32_t errorCode);
+size_t halNative_uartTakeOutput(USART_TypeDef* instance, uint8_t* data, size_t maxLen);
+
+const char* halNative_uartPtyName(USART_TypeDef* instance);
+
+#endif // HAL_NATIVE_H
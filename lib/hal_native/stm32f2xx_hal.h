@@ -0,0 +1,325 @@
+/*************************************************************************
+ * stm32f2xx_hal.h (native)
+ * Host stand-in for the STM32F2 HAL, only the surface used in lib/ and
+ * src/. Peripherals are plain structs, UART traffic goes to in-memory
+ * streams and optionally to a pty (see hal_native.h).
+ * Created on: 18-Oct-2026 09:00:00
+ * M. Schermutzki
+ *************************************************************************/
+#ifndef STM32F2XX_HAL_H
+#define STM32F2XX_HAL_H
+
+/*** includes ************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/*** common **************************************************************/
+typedef enum
+{
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY  0xFFFFFFFFU
+
+extern uint32_t SystemCoreClock;
+
+HAL_StatusTypeDef HAL_Init(void);
+void HAL_IncTick(void);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+/*** core (CMSIS) ********************************************************/
+typedef enum
+{
+    SysTick_IRQn       = -1,
+    DMA1_Stream0_IRQn  = 11,
+    DMA1_Stream1_IRQn  = 12,
+    DMA1_Stream2_IRQn  = 13,
+    DMA1_Stream3_IRQn  = 14,
+    DMA1_Stream4_IRQn  = 15,
+    DMA1_Stream5_IRQn  = 16,
+    DMA1_Stream6_IRQn  = 17,
+    TIM2_IRQn          = 28,
+    USART1_IRQn        = 37,
+    USART2_IRQn        = 38,
+    USART3_IRQn        = 39,
+    DMA1_Stream7_IRQn  = 47,
+    UART4_IRQn         = 52,
+    UART5_IRQn         = 53,
+    DMA2_Stream0_IRQn  = 56,
+    DMA2_Stream1_IRQn  = 57,
+    DMA2_Stream2_IRQn  = 58,
+    DMA2_Stream3_IRQn  = 59,
+    DMA2_Stream4_IRQn  = 60,
+    DMA2_Stream5_IRQn  = 68,
+    DMA2_Stream6_IRQn  = 69,
+    DMA2_Stream7_IRQn  = 70,
+    USART6_IRQn        = 71
+} IRQn_Type;
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+
+// "interrupts" are delivered from halNative_service(); PRIMASK defers them,
+// IPSR is non-zero while a handler runs
+uint32_t __get_PRIMASK(void);
+uint32_t __get_IPSR(void);
+void __set_PRIMASK(uint32_t priMask);
+void __disable_irq(void);
+void __enable_irq(void);
+void __WFI(void);
+
+/*** GPIO / RCC **********************************************************/
+typedef struct
+{
+    volatile uint32_t MODER;
+    volatile uint32_t IDR;
+    volatile uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+    uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+extern GPIO_TypeDef halNative_gpio[9];
+#define GPIOA  (&halNative_gpio[0])
+#define GPIOB  (&halNative_gpio[1])
+#define GPIOC  (&halNative_gpio[2])
+#define GPIOD  (&halNative_gpio[3])
+#define GPIOE  (&halNative_gpio[4])
+#define GPIOF  (&halNative_gpio[5])
+#define GPIOG  (&halNative_gpio[6])
+
+#define GPIO_PIN_0    ((uint16_t)0x0001)
+#define GPIO_PIN_1    ((uint16_t)0x0002)
+#define GPIO_PIN_2    ((uint16_t)0x0004)
+#define GPIO_PIN_3    ((uint16_t)0x0008)
+#define GPIO_PIN_4    ((uint16_t)0x0010)
+#define GPIO_PIN_5    ((uint16_t)0x0020)
+#define GPIO_PIN_6    ((uint16_t)0x0040)
+#define GPIO_PIN_7    ((uint16_t)0x0080)
+#define GPIO_PIN_8    ((uint16_t)0x0100)
+#define GPIO_PIN_9    ((uint16_t)0x0200)
+#define GPIO_PIN_10   ((uint16_t)0x0400)
+#define GPIO_PIN_11   ((uint16_t)0x0800)
+#define GPIO_PIN_12   ((uint16_t)0x1000)
+#define GPIO_PIN_13   ((uint16_t)0x2000)
+#define GPIO_PIN_14   ((uint16_t)0x4000)
+#define GPIO_PIN_15   ((uint16_t)0x8000)
+
+#define GPIO_MODE_AF_PP            0x00000002U
+#define GPIO_NOPULL                0x00000000U
+#define GPIO_PULLUP                0x00000001U
+#define GPIO_SPEED_FREQ_VERY_HIGH  0x00000003U
+
+#define GPIO_AF7_USART1  ((uint8_t)0x07)
+#define GPIO_AF7_USART2  ((uint8_t)0x07)
+#define GPIO_AF7_USART3  ((uint8_t)0x07)
+#define GPIO_AF8_UART4   ((uint8_t)0x08)
+#define GPIO_AF8_UART5   ((uint8_t)0x08)
+#define GPIO_AF8_USART6  ((uint8_t)0x08)
+
+void HAL_GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_Init);
+
+#define HAL_NATIVE_CLK_ENABLE()  do { } while (0)
+#define __HAL_RCC_GPIOA_CLK_ENABLE()   HAL_NATIVE_CLK_ENABLE()
+#define __HAL_RCC_GPIOB_CLK_ENABLE()   HAL_NATIVE_CLK_ENABLE()
+#define __HAL_RCC_GPIOC_CLK_ENABLE()   HAL_NATIVE_CLK_ENABLE()
+#define __HAL_RCC_GPIOD_CLK_ENABLE()   HAL_NATIVE_CLK_ENABLE()
+#define __HAL_RCC_GPIOG_CLK_ENABLE()   HAL_NATIVE_CLK_ENABLE()
+#define __HAL_RCC_USART1_CLK_ENABLE()  HAL_NATIVE_CLK_ENABLE()
+#define __HAL_RCC_USART2_CLK_ENABLE()  HAL_NATIVE_CLK_ENABLE()
+#define __HAL_RCC_USART3_CLK_ENABLE()  HAL_NATIVE_CLK_ENABLE()
+#define __HAL_RCC_UART4_CLK_ENABLE()   HAL_NATIVE_CLK_ENABLE()
+#define __HAL_RCC_UART5_CLK_ENABLE()   HAL_NATIVE_CLK_ENABLE()
+#define __HAL_RCC_USART6_CLK_ENABLE()  HAL_NATIVE_CLK_ENABLE()
+#define __HAL_RCC_DMA1_CLK_ENABLE()    HAL_NATIVE_CLK_ENABLE()
+#define __HAL_RCC_DMA2_CLK_ENABLE()    HAL_NATIVE_CLK_ENABLE()
+
+// F207 at 120 MHz: APB1 = HCLK/4, APB2 = HCLK/2
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+
+/*** DMA *****************************************************************/
+typedef struct
+{
+    volatile uint32_t CR;
+    volatile uint32_t NDTR;
+} DMA_Stream_TypeDef;
+
+// index 0..7 = DMA1 stream 0..7, 8..15 = DMA2 stream 0..7
+extern DMA_Stream_TypeDef halNative_dmaStream[16];
+#define DMA1_Stream0  (&halNative_dmaStream[0])
+#define DMA1_Stream1  (&halNative_dmaStream[1])
+#define DMA1_Stream2  (&halNative_dmaStream[2])
+#define DMA1_Stream3  (&halNative_dmaStream[3])
+#define DMA1_Stream4  (&halNative_dmaStream[4])
+#define DMA1_Stream5  (&halNative_dmaStream[5])
+#define DMA1_Stream6  (&halNative_dmaStream[6])
+#define DMA1_Stream7  (&halNative_dmaStream[7])
+#define DMA2_Stream0  (&halNative_dmaStream[8])
+#define DMA2_Stream1  (&halNative_dmaStream[9])
+#define DMA2_Stream2  (&halNative_dmaStream[10])
+#define DMA2_Stream3  (&halNative_dmaStream[11])
+#define DMA2_Stream4  (&halNative_dmaStream[12])
+#define DMA2_Stream5  (&halNative_dmaStream[13])
+#define DMA2_Stream6  (&halNative_dmaStream[14])
+#define DMA2_Stream7  (&halNative_dmaStream[15])
+
+typedef struct
+{
+    uint32_t Channel;
+    uint32_t Direction;
+    uint32_t PeriphInc;
+    uint32_t MemInc;
+    uint32_t PeriphDataAlignment;
+    uint32_t MemDataAlignment;
+    uint32_t Mode;
+    uint32_t Priority;
+    uint32_t FIFOMode;
+} DMA_InitTypeDef;
+
+typedef struct __DMA_HandleTypeDef
+{
+    DMA_Stream_TypeDef* Instance;
+    DMA_InitTypeDef Init;
+    void* Parent;
+    volatile uint32_t pendingFlags;   // native: HT/TC raised by the simulation
+} DMA_HandleTypeDef;
+
+#define DMA_CHANNEL_4          0x08000000U
+#define DMA_CHANNEL_5          0x0A000000U
+#define DMA_PERIPH_TO_MEMORY   0x00000000U
+#define DMA_MEMORY_TO_PERIPH   0x00000040U
+#define DMA_PINC_DISABLE       0x00000000U
+#define DMA_MINC_ENABLE        0x00000400U
+#define DMA_PDATAALIGN_BYTE    0x00000000U
+#define DMA_MDATAALIGN_BYTE    0x00000000U
+#define DMA_NORMAL             0x00000000U
+#define DMA_CIRCULAR           0x00000100U
+#define DMA_PRIORITY_MEDIUM    0x00010000U
+#define DMA_PRIORITY_HIGH      0x00020000U
+#define DMA_FIFOMODE_DISABLE   0x00000000U
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef* hdma);
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef* hdma);
+
+#define __HAL_DMA_GET_COUNTER(__HANDLE__)  ((__HANDLE__)->Instance->NDTR)
+#define __HAL_LINKDMA(__HANDLE__, __PPP_DMA_FIELD__, __DMA_HANDLE__) \
+    do { (__HANDLE__)->__PPP_DMA_FIELD__ = &(__DMA_HANDLE__);        \
+         (__DMA_HANDLE__).Parent = (__HANDLE__); } while (0)
+
+/*** UART ****************************************************************/
+typedef struct
+{
+    volatile uint32_t SR;
+    volatile uint32_t DR;
+    volatile uint32_t BRR;
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t CR3;
+} USART_TypeDef;
+
+// index 0..5 = USART1, USART2, USART3, UART4, UART5, USART6
+extern USART_TypeDef halNative_usart[6];
+#define USART1  (&halNative_usart[0])
+#define USART2  (&halNative_usart[1])
+#define USART3  (&halNative_usart[2])
+#define UART4   (&halNative_usart[3])
+#define UART5   (&halNative_usart[4])
+#define USART6  (&halNative_usart[5])
+
+typedef struct
+{
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+    uint32_t OverSampling;
+} UART_InitTypeDef;
+
+typedef enum
+{
+    HAL_UART_STATE_RESET   = 0x00U,
+    HAL_UART_STATE_READY   = 0x20U,
+    HAL_UART_STATE_BUSY    = 0x24U,
+    HAL_UART_STATE_BUSY_TX = 0x21U,
+    HAL_UART_STATE_BUSY_RX = 0x22U
+} HAL_UART_StateTypeDef;
+
+typedef struct __UART_HandleTypeDef
+{
+    USART_TypeDef* Instance;
+    UART_InitTypeDef Init;
+    const uint8_t* pTxBuffPtr;
+    uint16_t TxXferSize;
+    volatile uint16_t TxXferCount;
+    uint8_t* pRxBuffPtr;
+    uint16_t RxXferSize;
+    volatile uint16_t RxXferCount;
+    DMA_HandleTypeDef* hdmatx;
+    DMA_HandleTypeDef* hdmarx;
+    volatile HAL_UART_StateTypeDef gState;
+    volatile HAL_UART_StateTypeDef RxState;
+    volatile uint32_t ErrorCode;
+} UART_HandleTypeDef;
+
+#define UART_WORDLENGTH_8B    0x00000000U
+#define UART_STOPBITS_1       0x00000000U
+#define UART_PARITY_NONE      0x00000000U
+#define UART_MODE_TX_RX       0x0000000CU
+#define UART_HWCONTROL_NONE   0x00000000U
+#define UART_OVERSAMPLING_16  0x00000000U
+
+#define UART_FLAG_PE    0x00000001U
+#define UART_FLAG_FE    0x00000002U
+#define UART_FLAG_NE    0x00000004U
+#define UART_FLAG_ORE   0x00000008U
+#define UART_FLAG_IDLE  0x00000010U
+#define UART_FLAG_RXNE  0x00000020U
+#define UART_FLAG_TC    0x00000040U
+#define UART_IT_IDLE    0x00000010U
+
+#define HAL_UART_ERROR_NONE  0x00000000U
+#define HAL_UART_ERROR_PE    0x00000001U
+#define HAL_UART_ERROR_NE    0x00000002U
+#define HAL_UART_ERROR_FE    0x00000004U
+#define HAL_UART_ERROR_ORE   0x00000008U
+#define HAL_UART_ERROR_DMA   0x00000010U
+
+#define __HAL_UART_ENABLE_IT(__HANDLE__, __IT__)   ((__HANDLE__)->Instance->CR1 |= (__IT__))
+#define __HAL_UART_DISABLE_IT(__HANDLE__, __IT__)  ((__HANDLE__)->Instance->CR1 &= ~(__IT__))
+#define __HAL_UART_GET_IT_SOURCE(__HANDLE__, __IT__) (((__HANDLE__)->Instance->CR1 & (__IT__)) != 0U)
+#define __HAL_UART_GET_FLAG(__HANDLE__, __FLAG__)  (((__HANDLE__)->Instance->SR & (__FLAG__)) == (__FLAG__))
+#define __HAL_UART_CLEAR_IDLEFLAG(__HANDLE__)      ((__HANDLE__)->Instance->SR &= ~UART_FLAG_IDLE)
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_DMAStop(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef* huart);
+void HAL_UART_IRQHandler(UART_HandleTypeDef* huart);
+uint32_t HAL_UART_GetError(UART_HandleTypeDef* huart);
+
+// weak in the simulation, overridden by lib/uart
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart);
+void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef* huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart);
+
+#endif // STM32F2XX_HAL_H
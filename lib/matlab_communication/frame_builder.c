@@ -0,0 +1,132 @@
+/***************************************************************************
+ * frame_builder.c
+ * Created on: 17-Oct-2026 16:30:00
+ * M. Schermutzki
+ ***************************************************************************/
+
+/*** includes **************************************************************/
+#include "frame_builder.h"
+#include "crc16.h"
+
+/*** local constants ******************************************************/
+static const uint8_t _hexDigits[16] = {
+    '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'
+};
+
+/*** prototypes ***********************************************************/
+static void _put(frame_builder_t* fb, uint8_t sign);
+static void _putCovered(frame_builder_t* fb, const uint8_t* data, size_t len);
+
+/*** functions ************************************************************/
+
+/***************************************************************************
+ * Append raw sign (not part of the crc)
+ **************************************************************************/ 
+static void _put(frame_builder_t* fb, uint8_t sign)
+{
+    if (fb->len < fb->size) fb->buffer[fb->len++] = sign;
+    else fb->overflow = true;
+}
+
+/***************************************************************************
+ * Append signs that are covered by the crc
+ **************************************************************************/ 
+static void _putCovered(frame_builder_t* fb, const uint8_t* data, size_t len)
+{
+    if (fb->len + len > fb->size)
+    {
+        fb->overflow = true;
+        return;
+    }
+
+    for (size_t i = 0; i < len; i++) fb->buffer[fb->len + i] = data[i];
+    fb->crc = crc16_update(fb->crc, &fb->buffer[fb->len], len, C_CRC16_IMPL);
+    fb->len += len;
+}
+
+/***************************************************************************
+ * Start a new frame
+ **************************************************************************/ 
+void frameBuilder_begin(frame_builder_t* fb, uint8_t* buffer, size_t size,
+                        uint8_t startSign, uint8_t seperator, uint8_t endSign)
+{
+    if (!fb) return;
+
+    fb->buffer = buffer;
+    fb->size = buffer ? size : 0;
+    fb->len = 0;
+    fb->crc = 0xFFFF;
+    fb->seperator = seperator;
+    fb->endSign = endSign;
+    fb->fieldOpen = false;
+    fb->overflow = false;
+
+    _put(fb, startSign);
+}
+
+/***************************************************************************
+ * Append a field as upper case hex without leading zeros
+ **************************************************************************/ 
+void frameBuilder_addHex(frame_builder_t* fb, uint32_t value)
+{
+    if (!fb) return;
+
+    uint8_t digits[9];   // separator + max. 8 digits
+    uint8_t pos = sizeof(digits);
+
+    do
+    {
+        digits[--pos] = _hexDigits[value & 0xF];
+        value >>= 4;
+    } while (value != 0);
+
+    if (fb->fieldOpen) digits[--pos] = fb->seperator;
+    fb->fieldOpen = true;
+
+    _putCovered(fb, &digits[pos], sizeof(digits) - pos);
+}
+
+/***************************************************************************
+ * Append a signed field ('-' followed by the magnitude, as the parser expects)
+ **************************************************************************/ 
+void frameBuilder_addSigned(frame_builder_t* fb, int32_t value)
+{
+    if (!fb) return;
+
+    if (value < 0)
+    {
+        uint8_t prefix[2];
+        uint8_t n = 0;
+
+        if (fb->fieldOpen) prefix[n++] = fb->seperator;
+        prefix[n++] = '-';
+        _putCovered(fb, prefix, n);
+
+        fb->fieldOpen = false;   // separator already written
+        frameBuilder_addHex(fb, (uint32_t)0 - (uint32_t)value);
+    }
+    else
+    {
+        frameBuilder_addHex(fb, (uint32_t)value);
+    }
+}
+
+/***************************************************************************
+ * Close the frame: US, 4 digit crc, ETX. Returns the frame length, 0 if the
+ * buffer was too small.
+ **************************************************************************/ 
+size_t frameBuilder_finish(frame_builder_t* fb)
+{
+    if (!fb) return 0;
+
+    _putCovered(fb, &fb->seperator, 1);
+
+    uint16_t crc = fb->crc;
+    _put(fb, _hexDigits[(crc >> 12) & 0xF]);
+    _put(fb, _hexDigits[(crc >> 8) & 0xF]);
+    _put(fb, _hexDigits[(crc >> 4) & 0xF]);
+    _put(fb, _hexDigits[crc & 0xF]);
+    _put(fb, fb->endSign);
+
+    return fb->overflow ? 0 : fb->len;
+}
@@ -0,0 +1,40 @@
+/***************************************************************************
+ * frame_builder.h
+ * Headerfile for frame_builder.c
+ * Created on: 17-Oct-2026 16:30:00
+ * M. Schermutzki
+ * Builds an ASCII frame  STX | hex field | US | ... | US | crc | ETX  in a
+ * single pass: digits, separators and the running crc are written straight
+ * into the output buffer, no libc formatting. The crc covers everything
+ * between STX and the crc, including the last separator (same as the
+ * receiving parser).
+ ***************************************************************************/
+#ifndef FRAME_BUILDER_H
+#define FRAME_BUILDER_H
+
+/*** includes ************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*** definitions ********************************************************/
+typedef struct
+{
+    uint8_t* buffer;
+    size_t size;
+    size_t len;
+    uint16_t crc;
+    uint8_t seperator;
+    uint8_t endSign;
+    bool fieldOpen;     // a field was written since the last separator
+    bool overflow;
+} frame_builder_t;
+
+/*** functions ***********************************************************/
+void frameBuilder_begin(frame_builder_t* fb, uint8_t* buffer, size_t size,
+                        uint8_t startSign, uint8_t seperator, uint8_t endSign);
+void frameBuilder_addHex(frame_builder_t* fb, uint32_t value);
+void frameBuilder_addSigned(frame_builder_t* fb, int32_t value);
+size_t frameBuilder_finish(frame_builder_t* fb);
+
+#endif // FRAME_BUILDER_H
@@ -6,28 +6,128 @@
 
 /*** includes **************************************************************/
 #include <stdbool.h>
-#include <stdio.h>
 #include <string.h>
 #include <math.h>
 
 #include "matlab_communication.h"
 #include "crc16.h"
+#include "ring_buffer.h"
+#include "cobs.h"
+#include "frame_builder.h"
+#include "probe.h"
+#include "timebase.h"
+#include "stm32f2xx_hal.h"
 /*** macros ***************************************************************/
-#define C_MATLABCOM_MAX_INSTANCES    (1u)
-#define C_MATLABCOM_MAX_BUFFER_SIZE  (25u)
+#define C_MATLABCOM_MAX_INSTANCES    (2u)  // e.g. command link + telemetry link
+#define C_MATLABCOM_RX_RING_SIZE     (512u) // power of two, sized for C_MATLABCOM_MAX_BAUD
+#define C_MATLABCOM_POLL_HZ          (1000u) // matlabCommunication_poll() rate (comm task)
+#define C_MATLABCOM_POLL_SLACK       (10u)  // poll periods the RX ring bridges (late comm task)
+#define C_MATLABCOM_MAX_BAUD         (460800u) // highest rate the baud handshake accepts
+#define C_MATLABCOM_MAX_HEX_DIGITS   (8u)   // per ASCII field, 32 bit
+#define C_MATLABCOM_RX_STAMPS        (16u)  // power of two, frame ends between ISR and parser
+#define C_MATLABCOM_BAUD_TIMEOUT_MS  (500u) // no valid frame at the new rate -> back to the old one
+#define C_MATLABCOM_DUMP_RECORDS     (8u)   // flight records per dump chunk
+#define C_MATLABCOM_DUMP_HEADROOM    (64u)  // TX ring left to other frames during a dump
 
-// parser commands
-#define CMD_MOTOR_VALUES (0x01)
-#define CMD_PID_ANGLE (0x02)
+// command registry: built-ins + application commands, sub tables for
+// commands with sub commands (PID/angle)
+#define C_MATLABCOM_MAX_COMMANDS     (24u)
+#define C_MATLABCOM_MAX_SUB_TABLES   (2u)
 
-// protocol frame data
-#define C_MATLABCOM_STX  (0x02) // start sign
-#define C_MATLABCOM_US   (0x1F) // separator
-#define C_MATLABCOM_ETX  (0x03) // end sign
+// probe stats answer (not in the schema, variable length): probe count,
+// per probe count | min | max | mean | histogram buckets
+#define C_MATLABCOM_STATS_VALUES       (E_PROBE_COUNT * (4u + C_PROBE_HIST_BUCKETS))
+#define C_MATLABCOM_STATS_ASCII_SIZE   (C_MATLABCOM_ASCII_OVERHEAD + 2u * C_MATLABCOM_ASCII_WIDTH_U8 + \
+                                        C_MATLABCOM_STATS_VALUES * C_MATLABCOM_ASCII_WIDTH_U32)
+#define C_MATLABCOM_STATS_BINARY_SIZE  (C_MATLABCOM_BIN_OVERHEAD + 1u + C_MATLABCOM_STATS_VALUES * C_MATLABCOM_BINARY_WIDTH_U32)
+
+// flight recorder dump chunk (not in the schema): index | raw records
+#define C_MATLABCOM_DUMP_CHUNK_SIZE    (C_MATLABCOM_BIN_OVERHEAD + 4u + C_MATLABCOM_DUMP_RECORDS * sizeof(flight_record_t))
+
+// largest frames, exact from matlab_protocol.h (size unions below)
+#define C_MATLABCOM_ASCII_MAX_TX       (sizeof(ascii_tx_sizes_t))
+#define C_MATLABCOM_BIN_MAX_FRAME      (sizeof(binary_rx_sizes_t))  // decoded, incl. sequence number
+#define C_MATLABCOM_BIN_MAX_TX_FRAME   (sizeof(binary_tx_sizes_t))
 
 /*** definitions **********************************************************/
 typedef void (*parser_state_t)(matlab_communication_t* matlabCom, const uint8_t sign);
 
+// one index per message of matlab_protocol.h
+#define MATLABCOM_GEN_INDEX(name, cmd, sub, direction, fields, asciiCmd)  E_MATLABCOM_MSG_##name,
+typedef enum
+{
+    MATLABCOM_MESSAGES(MATLABCOM_GEN_INDEX)
+    E_MATLABCOM_MSG_COUNT
+} message_id_t;
+
+typedef struct
+{
+    const matlab_communication_field_t* fields;
+    uint8_t fieldCount;
+    uint8_t cmd;
+    uint8_t subCmd;
+    bool asciiCmd;        // false: ASCII frame without the cmd field
+} message_t;
+
+// one member per message and direction, sizeof() is the largest frame
+#define MATLABCOM_GEN_ASCII_TX(name, cmd, sub, direction, fields, asciiCmd) \
+    uint8_t name[((direction) & C_MATLABCOM_TO_HOST) ? C_MATLABCOM_ASCII_SIZE_##name : 1u];
+#define MATLABCOM_GEN_BINARY_TX(name, cmd, sub, direction, fields, asciiCmd) \
+    uint8_t name[((direction) & C_MATLABCOM_TO_HOST) ? C_MATLABCOM_BINARY_SIZE_##name : 1u];
+#define MATLABCOM_GEN_BINARY_RX(name, cmd, sub, direction, fields, asciiCmd) \
+    uint8_t name[((direction) & C_MATLABCOM_TO_MCU) ? C_MATLABCOM_BINARY_SIZE_##name + 1u : 1u];
+
+typedef union { MATLABCOM_MESSAGES(MATLABCOM_GEN_ASCII_TX) } ascii_tx_sizes_t;
+typedef union { MATLABCOM_MESSAGES(MATLABCOM_GEN_BINARY_TX) uint8_t probeStats[C_MATLABCOM_STATS_BINARY_SIZE];
+                 uint8_t recorderChunk[C_MATLABCOM_DUMP_CHUNK_SIZE]; } binary_tx_sizes_t;
+typedef union { MATLABCOM_MESSAGES(MATLABCOM_GEN_BINARY_RX) } binary_rx_sizes_t;
+
+// every frame goes into the TX ring in one piece, otherwise it is never sent
+_Static_assert(C_MATLABCOM_ASCII_MAX_TX <= C_UART_TX_RING_SIZE, "ASCII frame exceeds the UART TX ring");
+_Static_assert(C_MATLABCOM_STATS_ASCII_SIZE <= C_UART_TX_RING_SIZE, "ASCII probe stats exceed the UART TX ring");
+_Static_assert(COBS_ENCODED_MAX(C_MATLABCOM_BIN_MAX_TX_FRAME) + 1u <= C_UART_TX_RING_SIZE, "binary frame exceeds the UART TX ring");
+// bytes arriving at the highest rate (10 bits per byte on the wire) while
+// the poll is C_MATLABCOM_POLL_SLACK periods late still fit into the RX ring
+_Static_assert(C_MATLABCOM_POLL_SLACK * (C_MATLABCOM_MAX_BAUD / 10u / C_MATLABCOM_POLL_HZ + 1u) <= C_MATLABCOM_RX_RING_SIZE,
+               "RX ring overflows between two polls at C_MATLABCOM_MAX_BAUD");
+_Static_assert(COBS_ENCODED_MAX(C_MATLABCOM_DUMP_CHUNK_SIZE) + 2u + C_MATLABCOM_DUMP_HEADROOM <= C_UART_TX_RING_SIZE,
+               "dump chunk and headroom exceed the UART TX ring");
+
+// registry entry; a command with sub commands only owns a sub table
+typedef struct
+{
+    matlab_communication_command_t command;
+    uint8_t id;
+    uint8_t binarySize;   // request fields in a binary frame
+    int8_t subTable;      // index into _subCommands, -1: none
+    int8_t subscribers;   // first of its chain in _subscriberPool, -1: none
+} command_entry_t;
+
+// subscriber chain per command entry; entries are shared by all
+// instances, each subscriber belongs to one
+typedef struct
+{
+    matlab_communication_t* matlabCom;
+    matlab_communication_subscriber_t handler;
+    void* context;
+    int8_t next;          // -1: end of the chain
+} subscriber_t;
+
+// built-in command, registered by matlabCommunication_init()
+typedef struct
+{
+    uint8_t request;      // message_id_t
+    uint8_t response;     // E_MATLABCOM_MSG_COUNT: no answer
+    matlab_communication_handler_t handler;
+} builtin_command_t;
+
+// payload of a dump chunk, the records are copied as they are in SRAM
+typedef struct
+{
+    uint8_t index[4];     // little endian, first record of the chunk
+    flight_record_t records[C_MATLABCOM_DUMP_RECORDS];
+} dump_chunk_t;
+
 struct matlab_communication_s
 {
     matlab_communication_error_t error;
@@ -36,39 +136,133 @@ struct matlab_communication_s
     matlabData_cb_t dataCallback;
     uart_t* communication;
     crc16_t* checksum;
-    char _datagram[C_MATLABCOM_MAX_BUFFER_SIZE];
-    char readyToSend[C_MATLABCOM_MAX_BUFFER_SIZE];
     bool isNegative;
     uint8_t fieldIndex;
-    int32_t numContainer;
-    uint8_t currentCommand;
+    uint32_t numContainer;  // magnitude, the sign is applied in _takeNumber
+    uint8_t numDigits;
+    const command_entry_t* command;  // of the current frame, NULL: unknown
+    bool hasSequence;       // sequence number read, answer with ACK/NACK
+    uint8_t sequence;
+    uint32_t baudPending;   // confirmed, switch once the confirmation is sent
+    uint32_t baudFallback;  // rate before the switch, 0: nothing to confirm
+    uint32_t baudSwitchTick;
+    uint32_t dumpNext;      // flight recorder dump: next record, end
+    uint32_t dumpEnd;
+    bool dumpActive;
+    matlab_communication_link_stats_t linkStats;
+    matlab_communication_frame_format_t frameFormat;
+    uint8_t binRx[COBS_ENCODED_MAX(C_MATLABCOM_BIN_MAX_FRAME)];
+    uint8_t binRxLen;
+    bool binRxOverflow;
     bool isInUse;
+    // RX ISR time per frame end byte (ETX or 0x00 in any format), ISR and
+    // parser count the same bytes -> _frameRxStamp()
+    volatile uint32_t rxEndStamp[C_MATLABCOM_RX_STAMPS];
+    volatile uint32_t rxEndCount;
+    uint32_t rxEndParsed;
+    ring_buffer_t rxRing;   // UART ISR -> matlabCommunication_poll()
+    uint8_t rxStorage[C_MATLABCOM_RX_RING_SIZE];
 };
 
 /*** local variables ******************************************************/
 static matlab_communication_t _matlabComInstances[C_MATLABCOM_MAX_INSTANCES];
 static bool _initialised = false;
-matlabData_cb_t _dataCallback = NULL;
+
+static command_entry_t _commandPool[C_MATLABCOM_MAX_COMMANDS];
+static uint8_t _commandCount;
+static command_entry_t* _commands[C_MATLABCOM_MAX_COMMAND_ID + 1u];
+static command_entry_t* _subCommands[C_MATLABCOM_MAX_SUB_TABLES][C_MATLABCOM_MAX_SUB_ID + 1u];
+static uint8_t _subTableCount;
+static subscriber_t _subscriberPool[C_MATLABCOM_MAX_SUBSCRIBERS];
+static uint8_t _subscriberCount;
+
+// field tables and messages of matlab_protocol.h; { 0 } closes lists
+// without fields
+#define MATLABCOM_GEN_FIELD(type, member, scale) \
+    { E_MATLABCOM_FIELD_##type, (scale), offsetof(matlab_communication_data_t, member) },
+#define MATLABCOM_GEN_FIELD_TABLE(name, cmd, sub, direction, fields, asciiCmd) \
+    static const matlab_communication_field_t _fields_##name[] = { fields(MATLABCOM_GEN_FIELD) { 0 } };
+#define MATLABCOM_GEN_MESSAGE(name, cmd, sub, direction, fields, asciiCmd) \
+    [E_MATLABCOM_MSG_##name] = { _fields_##name, C_MATLABCOM_FIELD_COUNT_##name, (cmd), (sub), (asciiCmd) },
+
+MATLABCOM_MESSAGES(MATLABCOM_GEN_FIELD_TABLE)
+
+static const message_t _messages[E_MATLABCOM_MSG_COUNT] = { MATLABCOM_MESSAGES(MATLABCOM_GEN_MESSAGE) };
+
+static const uint8_t _asciiWidth[E_MATLABCOM_FIELD_TYPE_COUNT] =
+{
+    [E_MATLABCOM_FIELD_U8]     = C_MATLABCOM_ASCII_WIDTH_U8,
+    [E_MATLABCOM_FIELD_U32]    = C_MATLABCOM_ASCII_WIDTH_U32,
+    [E_MATLABCOM_FIELD_I32]    = C_MATLABCOM_ASCII_WIDTH_I32,
+    [E_MATLABCOM_FIELD_Q16_16] = C_MATLABCOM_ASCII_WIDTH_Q16_16,
+    [E_MATLABCOM_FIELD_I16]    = C_MATLABCOM_ASCII_WIDTH_I16
+};
+
+static const uint8_t _binaryWidth[E_MATLABCOM_FIELD_TYPE_COUNT] =
+{
+    [E_MATLABCOM_FIELD_U8]     = C_MATLABCOM_BINARY_WIDTH_U8,
+    [E_MATLABCOM_FIELD_U32]    = C_MATLABCOM_BINARY_WIDTH_U32,
+    [E_MATLABCOM_FIELD_I32]    = C_MATLABCOM_BINARY_WIDTH_I32,
+    [E_MATLABCOM_FIELD_Q16_16] = C_MATLABCOM_BINARY_WIDTH_Q16_16,
+    [E_MATLABCOM_FIELD_I16]    = C_MATLABCOM_BINARY_WIDTH_I16
+};
 
 /*** prototypes ***********************************************************/
 static bool _asciiToNumber(matlab_communication_t* matlabCom, const char input);
+static int32_t _takeNumber(matlab_communication_t* matlabCom);
+static void _storeField(matlab_communication_data_t* data, const matlab_communication_field_t* field, int32_t value);
+static int32_t _loadField(const matlab_communication_data_t* data, const matlab_communication_field_t* field);
+static void _beginFields(matlab_communication_t* matlabCom);
+static void _executeCommand(matlab_communication_t* matlabCom);
+static matlab_communication_error_t _sendFields(matlab_communication_t* matlabCom, matlab_communication_frame_format_t format, uint8_t cmd, bool asciiCmd,
+                                               const matlab_communication_field_t* fields, uint8_t count, const matlab_communication_data_t* data);
+static matlab_communication_error_t _sendMessage(matlab_communication_t* matlabCom, matlab_communication_frame_format_t format, message_id_t id, const matlab_communication_data_t* data);
+static void _sendAck(matlab_communication_t* matlabCom, matlab_communication_frame_format_t format);
+static void _frameError(matlab_communication_t* matlabCom, matlab_communication_error_t error);
+static void _abortFrame(matlab_communication_t* matlabCom, matlab_communication_error_t error);
+static void _badSign(matlab_communication_t* matlabCom, uint8_t sign);
+static void _endFrame(matlab_communication_t* matlabCom);
+static void _resync(matlab_communication_t* matlabCom);
+static void _processBinaryFrame(matlab_communication_t* matlabCom);
+static matlab_communication_error_t _applyFrameFormat(matlab_communication_t* matlabCom, uint32_t format);
+static void _serviceBaudRate(matlab_communication_t* matlabCom);
+static void _serviceDump(matlab_communication_t* matlabCom);
+static void _registerBuiltins(void);
+// built-in handlers
+static matlab_communication_error_t _handleData(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context);
+static matlab_communication_error_t _handlePidAngleRead(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context);
+static matlab_communication_error_t _handleFrameFormat(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context);
+static matlab_communication_error_t _handleProbeStats(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context);
+static matlab_communication_error_t _handleBaudRate(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context);
+static matlab_communication_error_t _handleLinkStats(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context);
+static matlab_communication_error_t _handleTimeSync(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context);
+static matlab_communication_error_t _handlePing(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context);
+static matlab_communication_error_t _handleRecorderControl(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context);
+static matlab_communication_error_t _handleRecorderDump(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context);
+static uint32_t _frameRxStamp(matlab_communication_t* matlabCom);
+static matlab_communication_error_t _sendProbeStats(matlab_communication_t* matlabCom, bool reset);
+static void _handleBinaryFrame(matlab_communication_t* matlabCom);
+static matlab_communication_error_t _sendBinaryFrame(matlab_communication_t* matlabCom, uint8_t cmd, const uint8_t* payload, size_t len);
 // state machine functions
 static void _parserState_idle(matlab_communication_t* matlabCom, uint8_t sign);
 static void _parserState_readCommand(matlab_communication_t* matlabCom, uint8_t sign);
-static void _parserState_readMotorValues(matlab_communication_t* matlabCom, uint8_t sign);
-static void _parserState_readPidAngle(matlab_communication_t* matlabCom, uint8_t sign);
+static void _parserState_readSequence(matlab_communication_t* matlabCom, uint8_t sign);
+static void _parserState_readSubCommand(matlab_communication_t* matlabCom, uint8_t sign);
+static void _parserState_readFields(matlab_communication_t* matlabCom, uint8_t sign);
 static void _parserState_validateChecksum(matlab_communication_t* matlabCom, uint8_t sign);
+static void _parserState_discard(matlab_communication_t* matlabCom, uint8_t sign);
+static void _parserState_binary(matlab_communication_t* matlabCom, uint8_t sign);
 
 /*** functions ************************************************************/
 
 /***************************************************************************
- * Transform ascii signs into numbers
+ * Transform ascii signs into numbers, at most 8 hex digits (32 bit)
  **************************************************************************/ 
 static bool _asciiToNumber(matlab_communication_t* matlabCom, const char input)
 {
     uint8_t digit;
 
-    if (input == '-' && matlabCom->numContainer == 0) {
+    if (input == '-' && matlabCom->numDigits == 0 && !matlabCom->isNegative) {
         matlabCom->isNegative = true;
         return true;
     }
@@ -83,10 +277,107 @@ static bool _asciiToNumber(matlab_communication_t* matlabCom, const char input)
         return false;
     }
 
-    matlabCom->numContainer = matlabCom->numContainer * 16 + digit;
+    if (matlabCom->numDigits >= C_MATLABCOM_MAX_HEX_DIGITS) return false;
+
+    matlabCom->numContainer = (matlabCom->numContainer << 4) | digit;
+    matlabCom->numDigits++;
     return true;
 }
 
+/***************************************************************************
+ * Take the number read so far (sign applied) and start the next one
+ **************************************************************************/ 
+static int32_t _takeNumber(matlab_communication_t* matlabCom)
+{
+    // two's complement: U32 fields above 0x7FFFFFFF come back unchanged
+    // when _storeField casts to uint32_t
+    uint32_t magnitude = matlabCom->isNegative ? 0u - matlabCom->numContainer : matlabCom->numContainer;
+
+    matlabCom->numContainer = 0;
+    matlabCom->numDigits = 0;
+    matlabCom->isNegative = false;
+    return (int32_t)magnitude;
+}
+
+/***************************************************************************
+ * Field helpers: binary width, sign allowed
+ **************************************************************************/ 
+static inline uint8_t _fieldWidth(const matlab_communication_field_t* field)
+{
+    return _binaryWidth[field->type];
+}
+
+static inline bool _fieldIsSigned(const matlab_communication_field_t* field)
+{
+    return field->type == E_MATLABCOM_FIELD_I32 || field->type == E_MATLABCOM_FIELD_Q16_16 ||
+           field->type == E_MATLABCOM_FIELD_I16;
+}
+
+/***************************************************************************
+ * Store one received field (wire units) at its destination
+ **************************************************************************/ 
+static void _storeField(matlab_communication_data_t* data, const matlab_communication_field_t* field, int32_t value)
+{
+    uint8_t* destination = (uint8_t*)data + field->offset;
+
+    switch (field->type)
+    {
+        case E_MATLABCOM_FIELD_U8:
+            *destination = (uint8_t)value;
+            break;
+
+        case E_MATLABCOM_FIELD_I16:
+        {
+            int16_t narrow = (int16_t)value;
+            memcpy(destination, &narrow, sizeof(narrow));
+            break;
+        }
+
+        case E_MATLABCOM_FIELD_Q16_16:
+            value = fixedPoint_fromScaled(value, field->scale);
+            memcpy(destination, &value, sizeof(value));
+            break;
+
+        default:
+            memcpy(destination, &value, sizeof(value));
+            break;
+    }
+}
+
+/***************************************************************************
+ * Load one field to be sent, in wire units
+ **************************************************************************/ 
+static int32_t _loadField(const matlab_communication_data_t* data, const matlab_communication_field_t* field)
+{
+    const uint8_t* source = (const uint8_t*)data + field->offset;
+    int32_t value;
+
+    if (field->type == E_MATLABCOM_FIELD_U8) return *source;
+    if (field->type == E_MATLABCOM_FIELD_I16)
+    {
+        int16_t narrow;
+        memcpy(&narrow, source, sizeof(narrow));
+        return narrow;
+    }
+
+    memcpy(&value, source, sizeof(value));
+    return (field->type == E_MATLABCOM_FIELD_Q16_16) ? fixedPoint_toScaled(value, field->scale) : value;
+}
+
+/***************************************************************************
+ * Registry lookup, O(1): command id -> entry, sub command id -> entry in
+ * the sub table of the command
+ **************************************************************************/ 
+static inline const command_entry_t* _findCommand(uint32_t cmd)
+{
+    return (cmd <= C_MATLABCOM_MAX_COMMAND_ID) ? _commands[cmd] : NULL;
+}
+
+static inline const command_entry_t* _findSubCommand(const command_entry_t* parent, uint32_t subCmd)
+{
+    return (subCmd <= C_MATLABCOM_MAX_SUB_ID) ? _subCommands[parent->subTable][subCmd] : NULL;
+}
+
 /***************************************************************************
  * State machine: idle
  **************************************************************************/ 
@@ -96,11 +387,18 @@ static void _parserState_idle(matlab_communication_t* matlabCom, uint8_t sign)
     {
         crc16_reset(matlabCom->checksum);
         matlabCom->numContainer = 0;
+        matlabCom->numDigits = 0;
+        matlabCom->isNegative = false;
         matlabCom->fieldIndex = 0;
         matlabCom->data.currentPidAngleCmd = 0;  
+        matlabCom->hasSequence = false;
         matlabCom->currentState = _parserState_readCommand;
         matlabCom->error = E_MATLABCOMERROR_IN_PROGRESS;
     }
+    else
+    {
+        matlabCom->linkStats.bytesDiscarded++;
+    }
 }
 
 /***************************************************************************
@@ -108,163 +406,128 @@ static void _parserState_idle(matlab_communication_t* matlabCom, uint8_t sign)
  **************************************************************************/ 
 static void _parserState_readCommand(matlab_communication_t* matlabCom, uint8_t sign)
 {
-    if (matlabCom->error != E_MATLABCOMERROR_IN_PROGRESS) return;
-
     if (sign == C_MATLABCOM_US)
     {
         crc16_calculate(matlabCom->checksum, sign);
 
-        if (matlabCom->numContainer == CMD_MOTOR_VALUES)
-        {
-            matlabCom->data.cmd = E_MATLABCOM_CMD_SET_MOTOR_VALUE;
-            matlabCom->currentCommand = CMD_MOTOR_VALUES;
-            matlabCom->numContainer = 0;
-            matlabCom->currentState = _parserState_readMotorValues;
-        }
-        else if(matlabCom->numContainer == CMD_PID_ANGLE)
-        {
-            matlabCom->data.cmd = E_MATLABCOM_CMD_SET_PID_ANGLE_VALUES;
-            matlabCom->currentCommand = CMD_PID_ANGLE;
-            matlabCom->numContainer = 0;
-            matlabCom->currentState = _parserState_readPidAngle;
-        }
-        else
-        {
-            matlabCom->error = E_MATLABCOMERROR_UNK_CMD;
-        }
+        uint32_t command = (uint32_t)_takeNumber(matlabCom);
+        bool sequenced = (command & C_MATLABCOM_SEQ_FLAG) != 0;
+        command &= ~(uint32_t)C_MATLABCOM_SEQ_FLAG;
+
+        matlabCom->data.cmd = (matlab_communication_practical_cmd_t)command;
+        matlabCom->command = _findCommand(command);
+
+        // an unknown sequenced command still reads its sequence number, so
+        // the NACK can name the frame
+        if (sequenced) matlabCom->currentState = _parserState_readSequence;
+        else _beginFields(matlabCom);
     }
     else
     {
         bool success = _asciiToNumber(matlabCom, sign);
         if (success) crc16_calculate(matlabCom->checksum, sign);
-        else matlabCom->error = E_MATLABCOMERROR_INVALID_SIGN;
+        else _badSign(matlabCom, sign);
     }
 }
 
 /***************************************************************************
- * State machine: read motor values
+ * State machine: read the sequence number of a sequenced frame, then go on
+ * with the command
  **************************************************************************/ 
-static void _parserState_readMotorValues(matlab_communication_t* matlabCom, uint8_t sign)
+static void _parserState_readSequence(matlab_communication_t* matlabCom, uint8_t sign)
 {
-    if (matlabCom->error != E_MATLABCOMERROR_IN_PROGRESS) return;
-    if (matlabCom->currentCommand != CMD_MOTOR_VALUES) return;
-
     if (sign == C_MATLABCOM_US)
     {
         crc16_calculate(matlabCom->checksum, sign);
+        matlabCom->sequence = (uint8_t)_takeNumber(matlabCom);
+        matlabCom->hasSequence = true;
+        _beginFields(matlabCom);
+    }
+    else
+    {
+        bool success = _asciiToNumber(matlabCom, sign);
+        if (success) crc16_calculate(matlabCom->checksum, sign);
+        else _badSign(matlabCom, sign);
+    }
+}
 
-        switch (matlabCom->fieldIndex)
-        {
-            case 0: matlabCom->data.motorData.motor1 = (unsigned char)matlabCom->numContainer; break;
-            case 1: matlabCom->data.motorData.motor2 = (unsigned char)matlabCom->numContainer; break;
-            case 2: matlabCom->data.motorData.motor3 = (unsigned char)matlabCom->numContainer; break;
-            case 3: matlabCom->data.motorData.motor4 = (unsigned char)matlabCom->numContainer; break;
-            default: matlabCom->error = E_MATLABCOMERROR_NOK; return;
-        }
+/***************************************************************************
+ * Go on with what the registry entry of the frame expects next: its sub
+ * command id, its fields or directly the crc
+ **************************************************************************/ 
+static void _beginFields(matlab_communication_t* matlabCom)
+{
+    const command_entry_t* entry = matlabCom->command;
 
-        matlabCom->numContainer = 0;
-        matlabCom->fieldIndex++;
+    matlabCom->fieldIndex = 0;
 
-        if (matlabCom->fieldIndex > 3)
-        {
-            matlabCom->fieldIndex = 0;
-            matlabCom->numContainer = 0;
-            matlabCom->currentState = _parserState_validateChecksum;
-        }
+    if (entry == NULL)
+    {
+        _abortFrame(matlabCom, E_MATLABCOMERROR_UNK_CMD);
+    }
+    else if (entry->subTable >= 0)
+    {
+        matlabCom->currentState = _parserState_readSubCommand;
+    }
+    else
+    {
+        matlabCom->currentState = (entry->command.fieldCount > 0) ? _parserState_readFields : _parserState_validateChecksum;
+    }
+}
+
+/***************************************************************************
+ * State machine: read the sub command id (e.g. C_MATLABCOM_YAW_DATA)
+ **************************************************************************/ 
+static void _parserState_readSubCommand(matlab_communication_t* matlabCom, uint8_t sign)
+{
+    if (sign == C_MATLABCOM_US)
+    {
+        crc16_calculate(matlabCom->checksum, sign);
+
+        uint32_t subCmd = (uint32_t)_takeNumber(matlabCom);
+        matlabCom->data.currentPidAngleCmd = (uint8_t)subCmd;
+        matlabCom->command = _findSubCommand(matlabCom->command, subCmd);
+        _beginFields(matlabCom);
     }
     else
     {
         bool success = _asciiToNumber(matlabCom, sign);
         if (success) crc16_calculate(matlabCom->checksum, sign);
-        else matlabCom->error = E_MATLABCOMERROR_INVALID_SIGN;
+        else _badSign(matlabCom, sign);
     }
 }
 
 /***************************************************************************
- * State machine: read PID/angle values (negative angles supported)
+ * State machine: read the fields of the current command as described by
+ * its registry entry (negative values only for signed fields)
  **************************************************************************/ 
-static void _parserState_readPidAngle(matlab_communication_t* matlabCom, uint8_t sign)
+static void _parserState_readFields(matlab_communication_t* matlabCom, uint8_t sign)
 {
-    if (matlabCom->error != E_MATLABCOMERROR_IN_PROGRESS) return;
-
     if (sign == C_MATLABCOM_US)
     {
         crc16_calculate(matlabCom->checksum, sign);
 
-        // erstes Feld = Command
-        if (matlabCom->data.currentPidAngleCmd == 0) 
-        {
-            matlabCom->data.currentPidAngleCmd = (uint8_t)matlabCom->numContainer;
-
-            if (matlabCom->data.currentPidAngleCmd != C_MATLABCOM_ROLL_PITCH_DATA &&
-                matlabCom->data.currentPidAngleCmd != C_MATLABCOM_YAW_DATA &&
-                matlabCom->data.currentPidAngleCmd != C_MATLABCOM_ANGLE_DATA)
-            {
-                matlabCom->error = E_MATLABCOMERROR_UNK_CMD;
-                return;
-            }
+        const matlab_communication_command_t* command = &matlabCom->command->command;
+        const matlab_communication_field_t* field = &command->fields[matlabCom->fieldIndex];
 
-            matlabCom->fieldIndex = 0;
-        }
-        else
+        if (matlabCom->isNegative && !_fieldIsSigned(field))
         {
-            int32_t value = matlabCom->numContainer;
-            if (matlabCom->isNegative) 
-            {
-                value = -value;
-                matlabCom->isNegative = false;
-            }
-
-            switch(matlabCom->data.currentPidAngleCmd)
-            {
-                case C_MATLABCOM_ROLL_PITCH_DATA:
-                    switch(matlabCom->fieldIndex)
-                    {
-                        case 0: matlabCom->data.pidAngleData.pPitch_Roll = value; break;
-                        case 1: matlabCom->data.pidAngleData.iPitch_Roll = value; break;
-                        case 2: matlabCom->data.pidAngleData.dPitch_Roll = value; break;
-                    }
-                    break;
-
-                case C_MATLABCOM_YAW_DATA:
-                    switch(matlabCom->fieldIndex)
-                    {
-                        case 0: matlabCom->data.pidAngleData.pYaw = value; break;
-                        case 1: matlabCom->data.pidAngleData.iYaw = value; break;
-                        case 2: matlabCom->data.pidAngleData.dYaw = value; break;
-                    }
-                    break;
-
-                case C_MATLABCOM_ANGLE_DATA:
-                    switch(matlabCom->fieldIndex)
-                    {
-                        case 0: matlabCom->data.pidAngleData.targetAngleRoll = value; break;
-                        case 1: matlabCom->data.pidAngleData.targetAnglePitch = value; break;
-                        case 2: matlabCom->data.pidAngleData.targetAngleYaw = value; break;
-                    }
-                    break;
-
-                default:
-                    matlabCom->error = E_MATLABCOMERROR_UNK_CMD;
-                    return;
-            }
-
-            matlabCom->fieldIndex++;
-
-            if (matlabCom->fieldIndex > 2) 
-            {   
-                matlabCom->fieldIndex = 0;
-                matlabCom->currentState = _parserState_validateChecksum;
-            }
+            _abortFrame(matlabCom, E_MATLABCOMERROR_NOK);
+            return;
         }
+        _storeField(&matlabCom->data, field, _takeNumber(matlabCom));
 
-        matlabCom->numContainer = 0;
+        if (++matlabCom->fieldIndex >= command->fieldCount)
+        {
+            matlabCom->fieldIndex = 0;
+            matlabCom->currentState = _parserState_validateChecksum;
+        }
     }
-    else 
-    {   
+    else
+    {
         bool success = _asciiToNumber(matlabCom, sign);
-        if(success) crc16_calculate(matlabCom->checksum, sign);
-        else matlabCom->error = E_MATLABCOMERROR_INVALID_SIGN;
+        if (success) crc16_calculate(matlabCom->checksum, sign);
+        else _badSign(matlabCom, sign);
     }
 }
 
@@ -273,120 +536,1094 @@ static void _parserState_readPidAngle(matlab_communication_t* matlabCom, uint8_t
  **************************************************************************/ 
 static void _parserState_validateChecksum(matlab_communication_t* matlabCom, uint8_t sign)
 {
-    if (matlabCom->error != E_MATLABCOMERROR_IN_PROGRESS) return;
-
     if (sign == C_MATLABCOM_ETX)
     {
         uint16_t calculatedCrc = crc16_get(matlabCom->checksum);
         uint16_t sendedCrc = (uint16_t)matlabCom->numContainer;
 
+        matlabCom->numContainer = 0;
+        matlabCom->numDigits = 0;
+        matlabCom->isNegative = false;
+        matlabCom->fieldIndex = 0;
+        matlabCom->currentState = _parserState_idle;
+
         if (calculatedCrc == sendedCrc)
         {
-            if (matlabCom->dataCallback != NULL) 
-            {
-                matlabCom->dataCallback(&matlabCom->data);
-            }
-            matlabCom->error = E_MATLABCOMERROR_OK;
+            matlabCom->baudFallback = 0;  // link works at the current rate
+            _executeCommand(matlabCom);
         }
         else
         {
-            matlabCom->error = E_MATLABCOMERROR_CHECKSUM_ERROR;
+            _frameError(matlabCom, E_MATLABCOMERROR_CHECKSUM_ERROR);
         }
 
-        matlabCom->numContainer = 0;
-        matlabCom->fieldIndex = 0;
-        matlabCom->currentState = _parserState_idle;
+        _sendAck(matlabCom, E_MATLABCOM_FORMAT_ASCII);
     }
     else
     {
         bool success = _asciiToNumber(matlabCom, sign);
-        if (!success) matlabCom->error = E_MATLABCOMERROR_INVALID_SIGN;
+        if (!success) _badSign(matlabCom, sign);
     }
 }
 
+/***************************************************************************
+ * Frame errors: counted per instance (matlabCommunication_getLinkStats)
+ **************************************************************************/ 
+static void _frameError(matlab_communication_t* matlabCom, matlab_communication_error_t error)
+{
+    matlabCom->error = error;
+
+    switch (error)
+    {
+        case E_MATLABCOMERROR_CHECKSUM_ERROR:
+            matlabCom->linkStats.crcErrors++;
+            flightRecorder_event(E_FLIGHTREC_EVENT_CRC_ERROR);
+            break;
+        case E_MATLABCOMERROR_INVALID_SIGN:
+            matlabCom->linkStats.invalidSigns++;
+            flightRecorder_event(E_FLIGHTREC_EVENT_INVALID_SIGN);
+            break;
+        case E_MATLABCOMERROR_UNK_CMD:
+            matlabCom->linkStats.unknownCommands++;
+            flightRecorder_event(E_FLIGHTREC_EVENT_UNKNOWN_CMD);
+            break;
+        case E_MATLABCOMERROR_BAD_LENGTH:
+            matlabCom->linkStats.badLength++;
+            flightRecorder_event(E_FLIGHTREC_EVENT_INVALID_SIGN);
+            break;
+        default: break;
+    }
+}
 
 /***************************************************************************
- * UART RX wrapper for single instance
+ * A failed ASCII frame drops the rest of its bytes (_parserState_discard)
  **************************************************************************/ 
-static void _uartRxWrapper(void* context, uint8_t byte)
+static void _abortFrame(matlab_communication_t* matlabCom, matlab_communication_error_t error)
 {
-    matlab_communication_t* matlabCom = (matlab_communication_t*) context;
+    _frameError(matlabCom, error);
+    matlabCom->currentState = _parserState_discard;
+}
 
-    if (matlabCom && matlabCom->isInUse && matlabCom->currentState)
+/***************************************************************************
+ * No number sign: STX starts the next frame at once, ETX ends a frame that
+ * is too short, everything else aborts the frame
+ **************************************************************************/ 
+static void _badSign(matlab_communication_t* matlabCom, uint8_t sign)
+{
+    if (sign == C_MATLABCOM_STX)
     {
-        matlabCom->currentState(matlabCom, byte);
+        _resync(matlabCom);
+        return;
     }
+
+    _abortFrame(matlabCom, E_MATLABCOMERROR_INVALID_SIGN);
+    if (sign == C_MATLABCOM_ETX) _endFrame(matlabCom);
 }
 
 /***************************************************************************
- * Send MATLAB parameters
+ * End of a failed frame: NACK if it was sequenced, wait for the next STX
  **************************************************************************/ 
-/*
-matlab_communication_error_t matlabCommunication_sendParameter(matlab_communication_t* matlabCom, matlab_communication_data_t* data)
+static void _endFrame(matlab_communication_t* matlabCom)
 {
-    if(matlabCom == NULL || data == NULL) return E_MATLABCOMERROR_INVALID_POINTER;
+    _sendAck(matlabCom, E_MATLABCOM_FORMAT_ASCII);
+    matlabCom->numContainer = 0;
+    matlabCom->numDigits = 0;
+    matlabCom->fieldIndex = 0;
+    matlabCom->isNegative = false;
+    matlabCom->currentState = _parserState_idle;
+}
 
-    char datagram[C_MATLABCOM_MAX_BUFFER_SIZE] = {0};
-    char readyToSend[C_MATLABCOM_MAX_BUFFER_SIZE] = {0};
+/***************************************************************************
+ * STX inside a frame (its ETX got lost): give up the old frame and start
+ * the new one with this STX
+ **************************************************************************/ 
+static void _resync(matlab_communication_t* matlabCom)
+{
+    matlabCom->linkStats.resyncs++;
+    flightRecorder_event(E_FLIGHTREC_EVENT_RESYNC);
+    if (matlabCom->error == E_MATLABCOMERROR_IN_PROGRESS) matlabCom->error = E_MATLABCOMERROR_INVALID_SIGN;
 
-    if(data->parameter1 && data->parameter2 && data->parameter3)
-    {
-        snprintf(datagram, sizeof(datagram), "%hu%c%hu%c%hu%c%hu",
-                 data->command, C_MATLABCOM_US,
-                 *data->parameter1, C_MATLABCOM_US,
-                 *data->parameter2, C_MATLABCOM_US,
-                 *data->parameter3);
+    _endFrame(matlabCom);
+    _parserState_idle(matlabCom, C_MATLABCOM_STX);
+}
 
-        crc16_insertIntoDatagram(matlabCom->checksum, sizeof(readyToSend), datagram, readyToSend);
-        uart_sendBuffer(matlabCom->communication, (uint8_t*)readyToSend, strlen(readyToSend));
+/***************************************************************************
+ * State machine: rest of a failed frame up to its ETX or the next STX
+ **************************************************************************/ 
+static void _parserState_discard(matlab_communication_t* matlabCom, uint8_t sign)
+{
+    if (sign == C_MATLABCOM_STX) _resync(matlabCom);
+    else if (sign == C_MATLABCOM_ETX) _endFrame(matlabCom);
+    else matlabCom->linkStats.bytesDiscarded++;
+}
+
+/***************************************************************************
+ * State machine: binary mode, collect COBS bytes up to the delimiter
+ **************************************************************************/ 
+static void _parserState_binary(matlab_communication_t* matlabCom, uint8_t sign)
+{
+    if (sign != C_MATLABCOM_BIN_DELIMITER)
+    {
+        if (matlabCom->binRxLen < sizeof(matlabCom->binRx))
+        {
+            matlabCom->binRx[matlabCom->binRxLen++] = sign;
+        }
+        else
+        {
+            matlabCom->binRxOverflow = true;
+            matlabCom->linkStats.bytesDiscarded++;
+        }
+        return;
     }
-    else
+
+    if (matlabCom->binRxOverflow)
     {
+        matlabCom->linkStats.resyncs++;
+        flightRecorder_event(E_FLIGHTREC_EVENT_RESYNC);
         matlabCom->error = E_MATLABCOMERROR_NOK;
-        return matlabCom->error;
+    }
+    else if (matlabCom->binRxLen > 0)
+    {
+        _handleBinaryFrame(matlabCom);
     }
 
-    return E_MATLABCOMERROR_OK;
+    matlabCom->binRxLen = 0;
+    matlabCom->binRxOverflow = false;
 }
-*/
+
 /***************************************************************************
- * Return parser error
- **************************************************************************/
-matlab_communication_error_t matlabCommunication_getParserError(matlab_communication_t* matlabCom)
+ * Little endian helpers
+ **************************************************************************/ 
+static inline uint16_t _readLe16(const uint8_t* p)
 {
-    if (!matlabCom) return E_MATLABCOMERROR_INVALID_POINTER;
-    if (!matlabCom->isInUse) return E_MATLABCOMERROR_INVALID_INSTANCE;
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
 
-    return matlabCom->error;
+static inline int32_t _readLe32(const uint8_t* p)
+{
+    return (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+}
+
+static inline void _writeLe16(uint8_t* p, uint16_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static inline void _writeLe32(uint8_t* p, uint32_t value)
+{
+    _writeLe16(&p[0], (uint16_t)value);
+    _writeLe16(&p[2], (uint16_t)(value >> 16));
 }
+
 /***************************************************************************
- * 
- **************************************************************************/
-void matlabCommunication_registerDataCallback(matlab_communication_t* matlabCom, matlabData_cb_t cb) 
+ * Handle one complete binary frame, sequenced frames get ACK/NACK
+ **************************************************************************/ 
+static void _handleBinaryFrame(matlab_communication_t* matlabCom)
 {
-    if (matlabCom) {matlabCom->dataCallback = cb;}
+    matlabCom->hasSequence = false;
+    _processBinaryFrame(matlabCom);
+    _sendAck(matlabCom, E_MATLABCOM_FORMAT_BINARY);
 }
+
 /***************************************************************************
- * Send IMU data
+ * Decode, check and dispatch one complete binary frame
  **************************************************************************/ 
-void matlabCommunication_sendImuData(matlab_communication_t* matlabCom, int16_t x, int16_t y, int16_t z)
+static void _processBinaryFrame(matlab_communication_t* matlabCom)
 {
-    if(matlabCom == NULL) return;
+    uint8_t frame[C_MATLABCOM_BIN_MAX_FRAME];
+    size_t len = cobs_decode(matlabCom->binRx, matlabCom->binRxLen, frame, sizeof(frame));
+
+    if (len < C_MATLABCOM_BIN_OVERHEAD)
+    {
+        _frameError(matlabCom, E_MATLABCOMERROR_INVALID_SIGN);
+        return;
+    }
+
+    crc16_reset(matlabCom->checksum);
+    crc16_calculateBuffer(matlabCom->checksum, frame, len - 2u);
+
+    if (crc16_get(matlabCom->checksum) != _readLe16(&frame[len - 2u]))
+    {
+        _frameError(matlabCom, E_MATLABCOMERROR_CHECKSUM_ERROR);
+        return;
+    }
+
+    const uint8_t* payload = &frame[1];
+    size_t payloadLen = len - C_MATLABCOM_BIN_OVERHEAD;
+    uint8_t command = frame[0];
+    matlabCom->baudFallback = 0;  // link works at the current rate
+
+    if (command & C_MATLABCOM_SEQ_FLAG)
+    {
+        if (payloadLen < 1u) { _frameError(matlabCom, E_MATLABCOMERROR_BAD_LENGTH); return; }
+
+        command &= (uint8_t)~C_MATLABCOM_SEQ_FLAG;
+        matlabCom->sequence = payload[0];
+        matlabCom->hasSequence = true;
+        payload++;
+        payloadLen--;
+    }
+
+    const command_entry_t* entry = _findCommand(command);
+    matlabCom->data.currentPidAngleCmd = 0;
+
+    if (entry != NULL && entry->subTable >= 0)
+    {
+        if (payloadLen < 1u) { _frameError(matlabCom, E_MATLABCOMERROR_BAD_LENGTH); return; }
 
-    snprintf(matlabCom->_datagram, sizeof(matlabCom->_datagram),
-             "%hu%c%hu%c%hu",
-             x,
-             C_MATLABCOM_US, 
-             y,
-             C_MATLABCOM_US, 
-             z);
+        matlabCom->data.currentPidAngleCmd = payload[0];
+        entry = _findSubCommand(entry, payload[0]);
+        payload++;
+        payloadLen--;
+    }
+
+    if (entry == NULL) { _frameError(matlabCom, E_MATLABCOMERROR_UNK_CMD); return; }
+    if (payloadLen != entry->binarySize) { _frameError(matlabCom, E_MATLABCOMERROR_BAD_LENGTH); return; }
+
+    for (uint8_t i = 0; i < entry->command.fieldCount; i++)
+    {
+        const matlab_communication_field_t* field = &entry->command.fields[i];
+
+        int32_t value;
+
+        switch (_fieldWidth(field))
+        {
+            case 1u:  value = payload[0]; break;
+            case 2u:  value = (int16_t)_readLe16(payload); break;
+            default:  value = _readLe32(payload); break;
+        }
+        _storeField(&matlabCom->data, field, value);
+        payload += _fieldWidth(field);
+    }
+
+    matlabCom->data.cmd = (matlab_communication_practical_cmd_t)command;
+    matlabCom->command = entry;
+    _executeCommand(matlabCom);
+}
+
+/***************************************************************************
+ * Run the handler of a received frame and send its answer, if the command
+ * has one. The answer goes out even if the handler failed (e.g. rejected
+ * baud rate), the error itself is reported by ACK/NACK.
+ **************************************************************************/ 
+static void _executeCommand(matlab_communication_t* matlabCom)
+{
+    const command_entry_t* entry = matlabCom->command;
+    matlab_communication_error_t error = E_MATLABCOMERROR_OK;
 
-    crc16_insertIntoDatagram(matlabCom->checksum, 
-                             sizeof(matlabCom->readyToSend), 
-                             matlabCom->_datagram, 
-                             matlabCom->readyToSend);
+    matlabCom->linkStats.framesOk++;
+    flightRecorder_event(E_FLIGHTREC_EVENT_FRAME_OK);
 
-    uart_sendBuffer(matlabCom->communication, (const uint8_t*)matlabCom->readyToSend, sizeof(matlabCom->readyToSend));
+    PROBE_START(E_PROBE_DATA_CALLBACK);
+    if (entry->command.handler != NULL)
+    {
+        error = entry->command.handler(matlabCom, &matlabCom->data, entry->command.context);
+    }
+
+    // only the chain of this command, no copy of the frame
+    for (int8_t i = entry->subscribers; i >= 0 && error == E_MATLABCOMERROR_OK; i = _subscriberPool[i].next)
+    {
+        const subscriber_t* subscriber = &_subscriberPool[i];
+        if (subscriber->matlabCom == matlabCom) subscriber->handler(matlabCom, &matlabCom->data, subscriber->context);
+    }
+    PROBE_STOP(E_PROBE_DATA_CALLBACK);
+
+    if (entry->command.response != NULL)
+    {
+        matlab_communication_error_t sent = _sendFields(matlabCom, matlabCom->frameFormat, entry->id, true,
+                                                        entry->command.response, entry->command.responseCount, &matlabCom->data);
+        if (error == E_MATLABCOMERROR_OK) error = sent;
+    }
+
+    matlabCom->error = error;
+}
+
+/***************************************************************************
+ * Send cmd | fields, read from data, in the given format; the buffers are
+ * sized for the largest frame of matlab_protocol.h
+ **************************************************************************/ 
+static matlab_communication_error_t _sendFields(matlab_communication_t* matlabCom, matlab_communication_frame_format_t format, uint8_t cmd, bool asciiCmd,
+                                               const matlab_communication_field_t* fields, uint8_t count, const matlab_communication_data_t* data)
+{
+    if (format == E_MATLABCOM_FORMAT_BINARY)
+    {
+        uint8_t payload[C_MATLABCOM_BIN_MAX_TX_FRAME - C_MATLABCOM_BIN_OVERHEAD];
+        size_t len = 0;
+
+        for (uint8_t i = 0; i < count; i++)
+        {
+            uint32_t value = (uint32_t)_loadField(data, &fields[i]);
+
+            for (uint8_t b = 0; b < _fieldWidth(&fields[i]); b++) payload[len++] = (uint8_t)(value >> (8u * b));
+        }
+        return _sendBinaryFrame(matlabCom, cmd, payload, len);
+    }
+
+    uint8_t frame[C_MATLABCOM_ASCII_MAX_TX];
+    frame_builder_t fb;
+
+    frameBuilder_begin(&fb, frame, sizeof(frame), C_MATLABCOM_STX, C_MATLABCOM_US, C_MATLABCOM_ETX);
+    if (asciiCmd) frameBuilder_addHex(&fb, cmd);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        int32_t value = _loadField(data, &fields[i]);
+
+        if (_fieldIsSigned(&fields[i])) frameBuilder_addSigned(&fb, value);
+        else frameBuilder_addHex(&fb, (uint32_t)value);
+    }
+
+    size_t len = frameBuilder_finish(&fb);
+    if (len == 0 || uart_sendBufferAsync(matlabCom->communication, frame, len) != UART_TX_OK)
+        return E_MATLABCOMERROR_SEND;
+
+    return E_MATLABCOMERROR_OK;
+}
+
+static matlab_communication_error_t _sendMessage(matlab_communication_t* matlabCom, matlab_communication_frame_format_t format, message_id_t id, const matlab_communication_data_t* data)
+{
+    const message_t* message = &_messages[id];
+
+    return _sendFields(matlabCom, format, message->cmd, message->asciiCmd, message->fields, message->fieldCount, data);
+}
+
+/***************************************************************************
+ * Built-in handlers: data frames go to the callback of
+ * matlabCommunication_registerDataCallback() (the application can replace
+ * them with matlabCommunication_setHandler() or add subscribers with
+ * matlabCommunication_subscribe()), link commands are handled here
+ **************************************************************************/ 
+static matlab_communication_error_t _handleData(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context)
+{
+    (void)context;
+
+    if (matlabCom->dataCallback != NULL)
+    {
+        matlabCom->dataCallback(data);
+    }
+    return E_MATLABCOMERROR_OK;
+}
+
+// the callback fills pidAngleData, it is sent back as the answer
+static matlab_communication_error_t _handlePidAngleRead(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context)
+{
+    memset(&data->pidAngleData, 0, sizeof(data->pidAngleData));
+    return _handleData(matlabCom, data, context);
+}
+
+static matlab_communication_error_t _handleFrameFormat(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context)
+{
+    (void)context;
+    return _applyFrameFormat(matlabCom, data->linkData.frameFormat);
+}
+
+static matlab_communication_error_t _handleProbeStats(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context)
+{
+    (void)context;
+    return _sendProbeStats(matlabCom, data->linkData.resetStats != 0);
+}
+
+/***************************************************************************
+ * Baud rate proposed by the host: confirm at the current rate (answer
+ * baud rate | accepted), switch once the confirmation has left
+ * (_serviceBaudRate). The host has to send a valid frame at the new rate
+ * within C_MATLABCOM_BAUD_TIMEOUT_MS, else both sides are back at the old
+ * rate. Rates above C_MATLABCOM_MAX_BAUD are rejected, the RX ring would
+ * overflow between two polls.
+ **************************************************************************/ 
+static matlab_communication_error_t _handleBaudRate(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context)
+{
+    (void)context;
+    uint32_t baudRate = data->linkData.baudRate;
+
+    data->linkData.accepted = baudRate <= C_MATLABCOM_MAX_BAUD &&
+                              uart_isBaudRateSupported(matlabCom->communication, baudRate);
+    if (!data->linkData.accepted) return E_MATLABCOMERROR_NOK;
+
+    if (baudRate != uart_getBaudRate(matlabCom->communication))
+    {
+        matlabCom->baudPending = baudRate;
+    }
+    return E_MATLABCOMERROR_OK;
+}
+
+/***************************************************************************
+ * Link counters as the answer, reset afterwards on request
+ **************************************************************************/ 
+static matlab_communication_error_t _handleLinkStats(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context)
+{
+    (void)context;
+    bool reset = data->linkData.resetStats != 0;   // same union as the answer
+
+    data->linkStats = matlabCom->linkStats;
+    if (reset) memset(&matlabCom->linkStats, 0, sizeof(matlabCom->linkStats));
+    return E_MATLABCOMERROR_OK;
+}
+
+/***************************************************************************
+ * Clock sync: t1 back to the host with t2 (RX ISR of the last byte of the
+ * request) and t3 (now, the answer is queued right after the handler). The
+ * host takes t4 on arrival and estimates offset and drift from the
+ * exchanges with the shortest round trip (matlab/syncMcuClock.m).
+ **************************************************************************/ 
+static matlab_communication_error_t _handleTimeSync(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context)
+{
+    (void)context;
+
+    data->timeSync.mcuReceive = _frameRxStamp(matlabCom);
+    data->timeSync.mcuSend = timebase_nowUs();
+    return E_MATLABCOMERROR_OK;
+}
+
+/***************************************************************************
+ * Ping: tag and payload stay in data and go back as they are, stamped with
+ * the RX ISR of the frame end and the time the answer is queued
+ * (queued - ISR: RX ring, parser and dispatch; benchmark/ping_latency.c)
+ **************************************************************************/ 
+static matlab_communication_error_t _handlePing(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context)
+{
+    (void)context;
+
+    data->pingData.isrUs = _frameRxStamp(matlabCom);
+    data->pingData.queuedUs = timebase_nowUs();
+    return E_MATLABCOMERROR_OK;
+}
+
+/***************************************************************************
+ * Flight recorder: arm, trigger or stop; the status is the answer
+ **************************************************************************/ 
+static matlab_communication_error_t _handleRecorderControl(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context)
+{
+    (void)context;
+    matlab_communication_recorder_control_t control = data->recorderControl;   // same union as the answer
+    matlab_communication_error_t error = E_MATLABCOMERROR_OK;
+
+    switch (control.action)
+    {
+        case E_MATLABCOM_REC_STATUS:
+            break;
+
+        case E_MATLABCOM_REC_ARM:
+            matlabCom->dumpActive = false;   // the records are overwritten from now on
+            if (!flightRecorder_arm(control.postTrigger, control.triggerEvents)) error = E_MATLABCOMERROR_NOK;
+            break;
+
+        case E_MATLABCOM_REC_TRIGGER:
+            flightRecorder_trigger();
+            break;
+
+        case E_MATLABCOM_REC_STOP:
+            flightRecorder_stop();
+            break;
+
+        default:
+            error = E_MATLABCOMERROR_NOK;
+            break;
+    }
+
+    flightRecorder_getStatus(&data->recorderStatus);
+    return error;
+}
+
+/***************************************************************************
+ * Flight recorder dump: freeze the recording and send the records in
+ * chunks from matlabCommunication_poll() (_serviceDump); a running dump is
+ * replaced
+ **************************************************************************/ 
+static matlab_communication_error_t _handleRecorderDump(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context)
+{
+    (void)context;
+    flight_recorder_status_t status;
+    uint32_t first = data->recorderControl.first;
+    uint32_t count = data->recorderControl.count;
+
+    flightRecorder_stop();
+    flightRecorder_getStatus(&status);
+
+    if (first > status.count) return E_MATLABCOMERROR_NOK;
+    if (count > status.count - first) count = status.count - first;
+
+    matlabCom->dumpNext = first;
+    matlabCom->dumpEnd = first + count;
+    matlabCom->dumpActive = true;
+    return E_MATLABCOMERROR_OK;
+}
+
+/***************************************************************************
+ * RX ISR time of the frame end byte the parser is at; the time of the
+ * parser itself if the stamp was overwritten or the bytes came through
+ * matlabCommunication_parse() directly
+ **************************************************************************/ 
+static uint32_t _frameRxStamp(matlab_communication_t* matlabCom)
+{
+    uint32_t index = matlabCom->rxEndParsed - 1u;
+
+    if (matlabCom->rxEndParsed == 0 || matlabCom->rxEndCount - index - 1u >= C_MATLABCOM_RX_STAMPS)
+        return timebase_nowUs();
+
+    return matlabCom->rxEndStamp[index & (C_MATLABCOM_RX_STAMPS - 1u)];
+}
+
+/***************************************************************************
+ * Build and queue a binary frame
+ **************************************************************************/ 
+static matlab_communication_error_t _sendBinaryFrame(matlab_communication_t* matlabCom, uint8_t cmd, const uint8_t* payload, size_t len)
+{
+    uint8_t frame[C_MATLABCOM_BIN_MAX_TX_FRAME];
+    uint8_t encoded[COBS_ENCODED_MAX(C_MATLABCOM_BIN_MAX_TX_FRAME) + 1u];
+
+    if (len + C_MATLABCOM_BIN_OVERHEAD > sizeof(frame)) return E_MATLABCOMERROR_NOK;
+
+    frame[0] = cmd;
+    if (len > 0) memcpy(&frame[1], payload, len);
+
+    crc16_reset(matlabCom->checksum);
+    crc16_calculateBuffer(matlabCom->checksum, frame, len + 1u);
+    _writeLe16(&frame[len + 1u], crc16_get(matlabCom->checksum));
+
+    size_t encodedLen = cobs_encode(frame, len + C_MATLABCOM_BIN_OVERHEAD, encoded, sizeof(encoded) - 1u);
+    encoded[encodedLen++] = C_MATLABCOM_BIN_DELIMITER;
+
+    if (uart_sendBufferAsync(matlabCom->communication, encoded, encodedLen) != UART_TX_OK)
+        return E_MATLABCOMERROR_SEND;
+
+    return E_MATLABCOMERROR_OK;
+}
+
+/***************************************************************************
+ * Answer a sequenced frame: ACK if it was applied, NACK with the reason.
+ * Sent in the format the frame arrived in.
+ **************************************************************************/ 
+static void _sendAck(matlab_communication_t* matlabCom, matlab_communication_frame_format_t format)
+{
+    if (!matlabCom->hasSequence) return;
+    matlabCom->hasSequence = false;
+
+    matlab_communication_data_t answer;
+    answer.ackData.sequence = matlabCom->sequence;
+    answer.ackData.error = (uint8_t)matlabCom->error;
+    if (matlabCom->error != E_MATLABCOMERROR_OK) flightRecorder_event(E_FLIGHTREC_EVENT_NACK);
+
+    _sendMessage(matlabCom, format, (matlabCom->error == E_MATLABCOMERROR_OK) ? E_MATLABCOM_MSG_ACK : E_MATLABCOM_MSG_NACK, &answer);
+}
+
+/***************************************************************************
+ * Confirm a frame format request in the current format, then switch
+ **************************************************************************/ 
+static matlab_communication_error_t _applyFrameFormat(matlab_communication_t* matlabCom, uint32_t format)
+{
+    if (format != E_MATLABCOM_FORMAT_ASCII && format != E_MATLABCOM_FORMAT_BINARY)
+    {
+        return E_MATLABCOMERROR_NOK;
+    }
+
+    matlab_communication_data_t answer;
+    answer.linkData.frameFormat = (uint8_t)format;
+    _sendMessage(matlabCom, matlabCom->frameFormat, E_MATLABCOM_MSG_FRAME_FORMAT, &answer);
+
+    matlabCommunication_setFrameFormat(matlabCom, (matlab_communication_frame_format_t)format);
+    return E_MATLABCOMERROR_OK;
+}
+
+/***************************************************************************
+ * Switch a confirmed baud rate, fall back if the host never arrived
+ **************************************************************************/ 
+static void _serviceBaudRate(matlab_communication_t* matlabCom)
+{
+    if (matlabCom->baudPending != 0 && uart_isTxIdle(matlabCom->communication))
+    {
+        uint32_t oldRate = uart_getBaudRate(matlabCom->communication);
+
+        if (uart_setBaudRate(matlabCom->communication, matlabCom->baudPending))
+        {
+            matlabCom->baudFallback = oldRate;
+            matlabCom->baudSwitchTick = HAL_GetTick();
+        }
+        matlabCom->baudPending = 0;
+    }
+    else if (matlabCom->baudFallback != 0 &&
+             HAL_GetTick() - matlabCom->baudSwitchTick >= C_MATLABCOM_BAUD_TIMEOUT_MS)
+    {
+        uart_setBaudRate(matlabCom->communication, matlabCom->baudFallback);
+        matlabCom->baudFallback = 0;
+    }
+}
+
+/***************************************************************************
+ * Queue dump chunks as long as the TX ring has room for a full one plus
+ * C_MATLABCOM_DUMP_HEADROOM (answers and telemetry go on in between). Each
+ * chunk starts with a delimiter, so the host finds it in an ASCII stream
+ * as well; a chunk without records ends the dump.
+ **************************************************************************/ 
+static void _serviceDump(matlab_communication_t* matlabCom)
+{
+    static const uint8_t delimiter = C_MATLABCOM_BIN_DELIMITER;
+    const size_t needed = COBS_ENCODED_MAX(C_MATLABCOM_DUMP_CHUNK_SIZE) + 2u + C_MATLABCOM_DUMP_HEADROOM;
+    dump_chunk_t chunk;
+
+    while (matlabCom->dumpActive && uart_getTxFree(matlabCom->communication) >= needed)
+    {
+        uint32_t remaining = matlabCom->dumpEnd - matlabCom->dumpNext;
+        size_t count = flightRecorder_read(matlabCom->dumpNext, chunk.records,
+                                           (remaining < C_MATLABCOM_DUMP_RECORDS) ? remaining : C_MATLABCOM_DUMP_RECORDS);
+
+        _writeLe32(chunk.index, matlabCom->dumpNext);
+        uart_sendBufferAsync(matlabCom->communication, &delimiter, 1u);
+        _sendBinaryFrame(matlabCom, C_MATLABCOM_ID_REC_DUMP, (const uint8_t*)&chunk,
+                         sizeof(chunk.index) + count * sizeof(flight_record_t));
+
+        matlabCom->dumpNext += (uint32_t)count;
+        if (count == 0) matlabCom->dumpActive = false;
+    }
+}
+
+/***************************************************************************
+ * Dump all probes as one frame: probe count, then per probe count, min,
+ * max, mean (cycles) and the histogram buckets. Probe count is 0 when the
+ * firmware was built without C_PROBE_ENABLE.
+ **************************************************************************/ 
+static matlab_communication_error_t _sendProbeStats(matlab_communication_t* matlabCom, bool reset)
+{
+    uint8_t probeCount = C_PROBE_ENABLE ? E_PROBE_COUNT : 0;
+    matlab_communication_error_t result;
+    probe_stats_t stats;
+
+    if (matlabCom->frameFormat == E_MATLABCOM_FORMAT_BINARY)
+    {
+        uint8_t payload[C_MATLABCOM_BIN_MAX_TX_FRAME - C_MATLABCOM_BIN_OVERHEAD];
+        size_t len = 0;
+
+        payload[len++] = probeCount;
+        for (uint8_t i = 0; i < probeCount; i++)
+        {
+            probe_getStats((probe_id_t)i, &stats);
+
+            uint32_t values[4] = {stats.count, stats.minCycles, stats.maxCycles, probe_getMean(&stats)};
+            for (uint8_t v = 0; v < 4u; v++, len += 4u) _writeLe32(&payload[len], values[v]);
+            for (uint8_t b = 0; b < C_PROBE_HIST_BUCKETS; b++, len += 4u) _writeLe32(&payload[len], stats.histogram[b]);
+        }
+        result = _sendBinaryFrame(matlabCom, C_MATLABCOM_ID_PROBE_STATS, payload, len);
+    }
+    else
+    {
+        uint8_t frame[C_MATLABCOM_STATS_ASCII_SIZE];
+        frame_builder_t fb;
+
+        frameBuilder_begin(&fb, frame, sizeof(frame), C_MATLABCOM_STX, C_MATLABCOM_US, C_MATLABCOM_ETX);
+        frameBuilder_addHex(&fb, C_MATLABCOM_ID_PROBE_STATS);
+        frameBuilder_addHex(&fb, probeCount);
+        for (uint8_t i = 0; i < probeCount; i++)
+        {
+            probe_getStats((probe_id_t)i, &stats);
+
+            frameBuilder_addHex(&fb, stats.count);
+            frameBuilder_addHex(&fb, stats.minCycles);
+            frameBuilder_addHex(&fb, stats.maxCycles);
+            frameBuilder_addHex(&fb, probe_getMean(&stats));
+            for (uint8_t b = 0; b < C_PROBE_HIST_BUCKETS; b++) frameBuilder_addHex(&fb, stats.histogram[b]);
+        }
+
+        size_t len = frameBuilder_finish(&fb);
+        result = (len > 0 && uart_sendBufferAsync(matlabCom->communication, frame, len) == UART_TX_OK)
+                 ? E_MATLABCOMERROR_OK : E_MATLABCOMERROR_SEND;
+    }
+
+    if (reset) probe_reset();
+    return result;
+}
+
+static inline bool _isFrameEnd(uint8_t byte)
+{
+    return byte == C_MATLABCOM_ETX || byte == C_MATLABCOM_BIN_DELIMITER;
+}
+
+/***************************************************************************
+ * UART RX wrappers (interrupt context): only queue the bytes, parsing is
+ * done in matlabCommunication_poll(). Frame end bytes get the time of the
+ * ISR (ping, time sync).
+ **************************************************************************/ 
+static inline void _queueRxByte(matlab_communication_t* matlabCom, uint8_t byte, uint32_t nowUs)
+{
+    if (ringBuffer_put(&matlabCom->rxRing, byte) && _isFrameEnd(byte))
+    {
+        matlabCom->rxEndStamp[matlabCom->rxEndCount & (C_MATLABCOM_RX_STAMPS - 1u)] = nowUs;
+        matlabCom->rxEndCount++;
+    }
+}
+
+static void _uartRxWrapper(void* context, uint8_t byte)
+{
+    matlab_communication_t* matlabCom = (matlab_communication_t*) context;
+
+    if (matlabCom && matlabCom->isInUse)
+    {
+        _queueRxByte(matlabCom, byte, timebase_nowUs());
+    }
+}
+
+static void _uartRxSpanWrapper(void* context, const uint8_t* data, size_t len)
+{
+    matlab_communication_t* matlabCom = (matlab_communication_t*) context;
+
+    if (matlabCom && matlabCom->isInUse)
+    {
+        uint32_t nowUs = timebase_nowUs();
+        for (size_t i = 0; i < len; i++)
+        {
+            _queueRxByte(matlabCom, data[i], nowUs);
+        }
+    }
+}
+
+/***************************************************************************
+ * Run the parser over all queued bytes (main loop context)
+ **************************************************************************/ 
+void matlabCommunication_poll(matlab_communication_t* matlabCom)
+{
+    if (!matlabCom || !matlabCom->isInUse) return;
+
+    const uint8_t* data;
+    size_t len;
+
+    while ((len = ringBuffer_peekContiguous(&matlabCom->rxRing, &data)) > 0)
+    {
+        matlabCommunication_parse(matlabCom, data, len);
+        ringBuffer_advance(&matlabCom->rxRing, len);
+    }
+
+    _serviceBaudRate(matlabCom);
+    _serviceDump(matlabCom);
+}
+
+/***************************************************************************
+ * Run bytes straight through the parser, bypassing the RX ring
+ * (benchmarks, host tests)
+ **************************************************************************/ 
+void matlabCommunication_parse(matlab_communication_t* matlabCom, const uint8_t* data, size_t len)
+{
+    if (!matlabCom || !matlabCom->isInUse || !data) return;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        PROBE_START(E_PROBE_PARSER_BYTE);
+        if (_isFrameEnd(data[i])) matlabCom->rxEndParsed++;
+        matlabCom->currentState(matlabCom, data[i]);
+        PROBE_STOP(E_PROBE_PARSER_BYTE);
+    }
+}
+
+/***************************************************************************
+ * Return RX ring statistics (for sizing C_MATLABCOM_RX_RING_SIZE)
+ **************************************************************************/ 
+void matlabCommunication_getRxStats(matlab_communication_t* matlabCom, matlab_communication_rx_stats_t* stats)
+{
+    if (!matlabCom || !stats) return;
+
+    stats->size      = C_MATLABCOM_RX_RING_SIZE;
+    stats->highWater = matlabCom->rxRing.highWater;
+    stats->overflows = matlabCom->rxRing.overflows;
+}
+
+/***************************************************************************
+ * Return the link counters (also over the link: C_MATLABCOM_ID_LINK_STATS)
+ **************************************************************************/ 
+void matlabCommunication_getLinkStats(matlab_communication_t* matlabCom, matlab_communication_link_stats_t* stats)
+{
+    if (!matlabCom || !stats) return;
+
+    *stats = matlabCom->linkStats;
+}
+
+/***************************************************************************
+ * Send MATLAB parameters
+ **************************************************************************/ 
+/*
+matlab_communication_error_t matlabCommunication_sendParameter(matlab_communication_t* matlabCom, matlab_communication_data_t* data)
+{
+    if(matlabCom == NULL || data == NULL) return E_MATLABCOMERROR_INVALID_POINTER;
+
+    char datagram[C_MATLABCOM_MAX_BUFFER_SIZE] = {0};
+    char readyToSend[C_MATLABCOM_MAX_BUFFER_SIZE] = {0};
+
+    if(data->parameter1 && data->parameter2 && data->parameter3)
+    {
+        snprintf(datagram, sizeof(datagram), "%hu%c%hu%c%hu%c%hu",
+                 data->command, C_MATLABCOM_US,
+                 *data->parameter1, C_MATLABCOM_US,
+                 *data->parameter2, C_MATLABCOM_US,
+                 *data->parameter3);
+
+        crc16_insertIntoDatagram(matlabCom->checksum, sizeof(readyToSend), datagram, readyToSend);
+        uart_sendBuffer(matlabCom->communication, (uint8_t*)readyToSend, strlen(readyToSend));
+    }
+    else
+    {
+        matlabCom->error = E_MATLABCOMERROR_NOK;
+        return matlabCom->error;
+    }
+
+    return E_MATLABCOMERROR_OK;
+}
+*/
+/***************************************************************************
+ * Return parser error
+ **************************************************************************/
+matlab_communication_error_t matlabCommunication_getParserError(matlab_communication_t* matlabCom)
+{
+    if (!matlabCom) return E_MATLABCOMERROR_INVALID_POINTER;
+    if (!matlabCom->isInUse) return E_MATLABCOMERROR_INVALID_INSTANCE;
+
+    return matlabCom->error;
+}
+/***************************************************************************
+ * 
+ **************************************************************************/
+void matlabCommunication_registerDataCallback(matlab_communication_t* matlabCom, matlabData_cb_t cb) 
+{
+    if (matlabCom) {matlabCom->dataCallback = cb;}
+}
+/***************************************************************************
+ * Select the frame format locally (no confirmation is sent)
+ **************************************************************************/
+void matlabCommunication_setFrameFormat(matlab_communication_t* matlabCom, matlab_communication_frame_format_t format)
+{
+    if (!matlabCom || !matlabCom->isInUse) return;
+
+    matlabCom->frameFormat = format;
+    matlabCom->binRxLen = 0;
+    matlabCom->binRxOverflow = false;
+    matlabCom->currentState = (format == E_MATLABCOM_FORMAT_BINARY) ? _parserState_binary : _parserState_idle;
+}
+
+matlab_communication_frame_format_t matlabCommunication_getFrameFormat(matlab_communication_t* matlabCom)
+{
+    if (!matlabCom) return E_MATLABCOM_FORMAT_ASCII;
+    return matlabCom->frameFormat;
+}
+/***************************************************************************
+ * Send IMU data; timestampUs: sample time (timebase_nowUs()), the host maps
+ * it to its own clock (matlab/mcuToHostTime.m)
+ **************************************************************************/ 
+void matlabCommunication_sendImuData(matlab_communication_t* matlabCom, uint32_t timestampUs, int16_t x, int16_t y, int16_t z)
+{
+    if(matlabCom == NULL) return;
+
+    PROBE_START(E_PROBE_SEND_IMU);
+
+    matlab_communication_data_t imu;
+    imu.imuData.timestampUs = timestampUs;
+    imu.imuData.x = x;
+    imu.imuData.y = y;
+    imu.imuData.z = z;
+
+    // only a copy of the exact frame into the UART TX ring, drained by DMA/IT
+    _sendMessage(matlabCom, matlabCom->frameFormat, E_MATLABCOM_MSG_IMU_DATA, &imu);
+
+    PROBE_STOP(E_PROBE_SEND_IMU);
+}
+
+/***************************************************************************
+ * Check a field list, return its size in a binary and an ASCII frame
+ **************************************************************************/ 
+static bool _checkFields(const matlab_communication_field_t* fields, uint8_t count, size_t* binarySize, size_t* asciiSize)
+{
+    if (count > C_MATLABCOM_MAX_FIELDS || (count > 0 && fields == NULL)) return false;
+
+    *binarySize = 0;
+    *asciiSize = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (fields[i].type >= E_MATLABCOM_FIELD_TYPE_COUNT) return false;
+        if (fields[i].type == E_MATLABCOM_FIELD_Q16_16 && fields[i].scale == 0) return false;
+        if (fields[i].offset + _fieldWidth(&fields[i]) > sizeof(matlab_communication_data_t)) return false;
+
+        *binarySize += _fieldWidth(&fields[i]);
+        *asciiSize += _asciiWidth[fields[i].type];
+    }
+    return true;
+}
+
+/***************************************************************************
+ * Check a command descriptor; headerSize: sequence number (+ sub command)
+ * in front of the fields, all of it has to fit into one binary frame
+ **************************************************************************/ 
+static bool _checkCommand(const matlab_communication_command_t* command, size_t headerSize, size_t* binarySize)
+{
+    size_t asciiSize, responseSize, responseAscii;
+
+    if (!command) return false;
+    if (!_checkFields(command->fields, command->fieldCount, binarySize, &asciiSize)) return false;
+    if (!_checkFields(command->response, command->responseCount, &responseSize, &responseAscii)) return false;
+
+    // answer: cmd | fields
+    return C_MATLABCOM_BIN_OVERHEAD + headerSize + *binarySize <= C_MATLABCOM_BIN_MAX_FRAME &&
+           C_MATLABCOM_BIN_OVERHEAD + responseSize <= C_MATLABCOM_BIN_MAX_TX_FRAME &&
+           C_MATLABCOM_ASCII_OVERHEAD + C_MATLABCOM_ASCII_WIDTH_U8 + responseAscii <= C_MATLABCOM_ASCII_MAX_TX;
+}
+
+static command_entry_t* _newEntry(uint8_t cmd)
+{
+    if (_commandCount >= C_MATLABCOM_MAX_COMMANDS) return NULL;
+
+    command_entry_t* entry = &_commandPool[_commandCount++];
+    memset(entry, 0, sizeof(*entry));
+    entry->id = cmd;
+    entry->subTable = -1;
+    entry->subscribers = -1;
+    return entry;
+}
+
+/***************************************************************************
+ * Register a command (or replace one without sub commands)
+ **************************************************************************/ 
+bool matlabCommunication_registerCommand(uint8_t cmd, const matlab_communication_command_t* command)
+{
+    size_t binarySize;
+
+    if (cmd > C_MATLABCOM_MAX_COMMAND_ID || !_checkCommand(command, 1u, &binarySize)) return false;
+
+    command_entry_t* entry = _commands[cmd];
+    if (entry == NULL)
+    {
+        if ((entry = _newEntry(cmd)) == NULL) return false;
+        _commands[cmd] = entry;
+    }
+    else if (entry->subTable >= 0)
+    {
+        return false;
+    }
+
+    entry->command = *command;
+    entry->binarySize = (uint8_t)binarySize;
+    return true;
+}
+
+/***************************************************************************
+ * Register a sub command, the command gets a sub table on its first one
+ **************************************************************************/ 
+bool matlabCommunication_registerSubCommand(uint8_t cmd, uint8_t subCmd, const matlab_communication_command_t* command)
+{
+    size_t binarySize;
+
+    if (cmd > C_MATLABCOM_MAX_COMMAND_ID || subCmd > C_MATLABCOM_MAX_SUB_ID) return false;
+    if (!_checkCommand(command, 2u, &binarySize)) return false;
+
+    command_entry_t* parent = _commands[cmd];
+    if (parent == NULL)
+    {
+        if (_subTableCount >= C_MATLABCOM_MAX_SUB_TABLES || _commandCount + 2u > C_MATLABCOM_MAX_COMMANDS) return false;
+
+        parent = _newEntry(cmd);
+        parent->subTable = (int8_t)_subTableCount++;
+        _commands[cmd] = parent;
+    }
+    else if (parent->subTable < 0)
+    {
+        return false;   // plain command with fields of its own
+    }
+
+    command_entry_t** slot = &_subCommands[parent->subTable][subCmd];
+    if (*slot == NULL && (*slot = _newEntry(cmd)) == NULL) return false;
+
+    (*slot)->command = *command;
+    (*slot)->binarySize = (uint8_t)binarySize;
+    return true;
+}
+
+/***************************************************************************
+ * Registry entry of a command, or of its sub command if it has a sub table
+ **************************************************************************/ 
+static command_entry_t* _entryOf(uint8_t cmd, uint8_t subCmd)
+{
+    command_entry_t* entry = (cmd <= C_MATLABCOM_MAX_COMMAND_ID) ? _commands[cmd] : NULL;
+
+    if (entry != NULL && entry->subTable >= 0)
+    {
+        entry = (subCmd <= C_MATLABCOM_MAX_SUB_ID) ? _subCommands[entry->subTable][subCmd] : NULL;
+    }
+    return entry;
+}
+
+/***************************************************************************
+ * Replace the handler of a registered command
+ **************************************************************************/ 
+bool matlabCommunication_setHandler(uint8_t cmd, uint8_t subCmd, matlab_communication_handler_t handler, void* context)
+{
+    command_entry_t* entry = _entryOf(cmd, subCmd);
+
+    if (entry == NULL) return false;
+
+    entry->command.handler = handler;
+    entry->command.context = context;
+    return true;
+}
+
+/***************************************************************************
+ * Subscribe to a registered command on one instance; appended to the chain
+ * of its entry, so the dispatch only walks the subscribers of the frame
+ **************************************************************************/ 
+bool matlabCommunication_subscribe(matlab_communication_t* matlabCom, uint8_t cmd, uint8_t subCmd, matlab_communication_subscriber_t handler, void* context)
+{
+    command_entry_t* entry = _entryOf(cmd, subCmd);
+
+    if (!matlabCom || !matlabCom->isInUse || !handler || entry == NULL) return false;
+    if (_subscriberCount >= C_MATLABCOM_MAX_SUBSCRIBERS) return false;
+
+    int8_t index = (int8_t)_subscriberCount++;
+    _subscriberPool[index] = (subscriber_t){ matlabCom, handler, context, -1 };
+
+    int8_t* link = &entry->subscribers;
+    while (*link >= 0) link = &_subscriberPool[*link].next;
+    *link = index;
+    return true;
+}
+
+/***************************************************************************
+ * Built-in commands: request and answer from matlab_protocol.h
+ **************************************************************************/ 
+static const builtin_command_t _builtinCommands[] =
+{
+    { E_MATLABCOM_MSG_MOTOR_VALUES,     E_MATLABCOM_MSG_COUNT,               _handleData },
+    { E_MATLABCOM_MSG_ROLL_PITCH_GAINS, E_MATLABCOM_MSG_COUNT,               _handleData },
+    { E_MATLABCOM_MSG_YAW_GAINS,        E_MATLABCOM_MSG_COUNT,               _handleData },
+    { E_MATLABCOM_MSG_TARGET_ANGLES,    E_MATLABCOM_MSG_COUNT,               _handleData },
+    { E_MATLABCOM_MSG_PID_ANGLE_VALUES, E_MATLABCOM_MSG_COUNT,               _handleData },
+    { E_MATLABCOM_MSG_PID_ANGLE_READ,   E_MATLABCOM_MSG_PID_ANGLE_READ_BACK, _handlePidAngleRead },
+    { E_MATLABCOM_MSG_FRAME_FORMAT,     E_MATLABCOM_MSG_COUNT,               _handleFrameFormat },
+    { E_MATLABCOM_MSG_PROBE_STATS,      E_MATLABCOM_MSG_COUNT,               _handleProbeStats },
+    { E_MATLABCOM_MSG_BAUD_RATE,        E_MATLABCOM_MSG_BAUD_RATE_ANSWER,    _handleBaudRate },
+    { E_MATLABCOM_MSG_LINK_STATS,       E_MATLABCOM_MSG_LINK_STATS_ANSWER,   _handleLinkStats },
+    { E_MATLABCOM_MSG_TIME_SYNC,        E_MATLABCOM_MSG_TIME_SYNC_ANSWER,    _handleTimeSync },
+    { E_MATLABCOM_MSG_PING_0,           E_MATLABCOM_MSG_PING_ANSWER_0,       _handlePing },
+    { E_MATLABCOM_MSG_PING_4,           E_MATLABCOM_MSG_PING_ANSWER_4,       _handlePing },
+    { E_MATLABCOM_MSG_PING_8,           E_MATLABCOM_MSG_PING_ANSWER_8,       _handlePing },
+    { E_MATLABCOM_MSG_REC_CONTROL,      E_MATLABCOM_MSG_REC_STATUS,          _handleRecorderControl },
+    { E_MATLABCOM_MSG_REC_DUMP,         E_MATLABCOM_MSG_COUNT,               _handleRecorderDump }
+};
+
+static void _registerBuiltins(void)
+{
+    memset(_commands, 0, sizeof(_commands));
+    memset(_subCommands, 0, sizeof(_subCommands));
+    _commandCount = 0;
+    _subTableCount = 0;
+    _subscriberCount = 0;
+
+    for (size_t i = 0; i < sizeof(_builtinCommands) / sizeof(_builtinCommands[0]); i++)
+    {
+        const builtin_command_t* builtin = &_builtinCommands[i];
+        const message_t* request = &_messages[builtin->request];
+        matlab_communication_command_t command = { request->fields, request->fieldCount, NULL, 0, builtin->handler, NULL };
+
+        if (builtin->response < E_MATLABCOM_MSG_COUNT)
+        {
+            command.response = _messages[builtin->response].fields;
+            command.responseCount = _messages[builtin->response].fieldCount;
+        }
+
+        if (request->subCmd == C_MATLABCOM_NO_SUB_CMD) matlabCommunication_registerCommand(request->cmd, &command);
+        else matlabCommunication_registerSubCommand(request->cmd, request->subCmd, &command);
+    }
 }
 
 /***************************************************************************
@@ -406,12 +1643,25 @@ matlab_communication_t* matlabCommunication_new(uart_t* uart)
             matlabCom->checksum = crc16_new(C_MATLABCOM_STX, C_MATLABCOM_US, C_MATLABCOM_ETX);
             matlabCom->fieldIndex = 0;
             matlabCom->numContainer = 0;
+            matlabCom->numDigits = 0;
             matlabCom->currentState = _parserState_idle;
+            matlabCom->frameFormat = E_MATLABCOM_FORMAT_ASCII;
+            matlabCom->binRxLen = 0;
+            matlabCom->binRxOverflow = false;
+            matlabCom->hasSequence = false;
+            matlabCom->baudPending = 0;
+            matlabCom->baudFallback = 0;
+            matlabCom->dumpActive = false;
             matlabCom->error = E_MATLABCOMERROR_OK;
+            memset(&matlabCom->linkStats, 0, sizeof(matlabCom->linkStats));
+            matlabCom->rxEndCount = 0;
+            matlabCom->rxEndParsed = 0;
+            ringBuffer_init(&matlabCom->rxRing, matlabCom->rxStorage, sizeof(matlabCom->rxStorage));
             matlabCom->isInUse = true;
 
-            // Register UART RX callback with context
+            // Register UART RX callbacks with context (per byte and DMA spans)
             uart_registerRxCallback(uart, _uartRxWrapper, matlabCom);
+            uart_registerRxSpanCallback(uart, _uartRxSpanWrapper, matlabCom);
             return matlabCom;
         }
     }
@@ -432,6 +1682,8 @@ void matlabCommunication_init()
         }
         uart_init();
         crc16_init();
+        timebase_init();
+        _registerBuiltins();
         _initialised = true;
     }
 }
@@ -10,11 +10,23 @@
 /*** includes ************************************************************/
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 #include "uart.h"
+#include "fixed_point.h"
+#include "flight_recorder.h"
+#include "matlab_protocol.h"
 /*** definitions ********************************************************/
-#define C_MATLABCOM_ROLL_PITCH_DATA  (0x04)
-#define C_MATLABCOM_YAW_DATA   (0x06)
-#define C_MATLABCOM_ANGLE_DATA (0x07)
+// PID/angle sub commands, see matlab_protocol.h
+#define C_MATLABCOM_ROLL_PITCH_DATA  C_MATLABCOM_SUB_ROLL_PITCH_GAINS
+#define C_MATLABCOM_YAW_DATA   C_MATLABCOM_SUB_YAW_GAINS
+#define C_MATLABCOM_ANGLE_DATA C_MATLABCOM_SUB_TARGET_ANGLES
+#define C_MATLABCOM_ALL_DATA   C_MATLABCOM_SUB_PID_ANGLE_VALUES   // roll/pitch PID, yaw PID and angles in one frame
+
+// command registry limits
+#define C_MATLABCOM_MAX_COMMAND_ID  (0x3F)  // 0x40: sequence flag, 0x80: MCU -> host
+#define C_MATLABCOM_MAX_SUB_ID      (0x0F)
+#define C_MATLABCOM_MAX_FIELDS      (12u)   // per request / answer
+#define C_MATLABCOM_MAX_SUBSCRIBERS (16u)   // all instances and commands together
 
 typedef struct matlab_communication_s matlab_communication_t;
 
@@ -28,16 +40,24 @@ typedef enum
     E_MATLABCOMERROR_INVALID_INSTANCE,
     E_MATLABCOMERROR_SEND,
     E_MATLABCOMERROR_UNK_CMD,
-    E_MATLABCOMERROR_CHECKSUM_ERROR
+    E_MATLABCOMERROR_CHECKSUM_ERROR,
+    E_MATLABCOMERROR_BAD_LENGTH         // binary payload does not fit the command
 } matlab_communication_error_t;
 
 typedef enum
 {
     E_MATLABCOM_CMD_INITIAL = 0,    // save initialisation in QCSF_API.c
-    E_MATLABCOM_CMD_SET_MOTOR_VALUE   = 0x01,
-    E_MATLABCOM_CMD_SET_PID_ANGLE_VALUES = 0x02
+    E_MATLABCOM_CMD_SET_MOTOR_VALUE   = C_MATLABCOM_ID_MOTOR_VALUES,
+    E_MATLABCOM_CMD_SET_PID_ANGLE_VALUES = C_MATLABCOM_ID_PID_ANGLE_VALUES,
+    E_MATLABCOM_CMD_GET_PID_ANGLE_VALUES = C_MATLABCOM_ID_PID_ANGLE_READ   // callback fills pidAngleData, sent back after return
 } matlab_communication_practical_cmd_t;
 
+typedef enum
+{
+    E_MATLABCOM_FORMAT_ASCII  = 0,   // STX | ascii hex fields separated by US | crc | ETX
+    E_MATLABCOM_FORMAT_BINARY = 1    // COBS( cmd | little endian payload | crc16 ) 0x00
+} matlab_communication_frame_format_t;
+
 typedef struct
 {
     uint16_t* parameter1;
@@ -54,43 +74,192 @@ typedef struct
     unsigned char motor4;
 }matlab_communication_motor_data_t;
 
+// PID/angle values in Q16.16, the wire carries value * scale (exact
+// integers); the field descriptors convert in both directions
 typedef struct 
 {
-    volatile double pPitch_Roll;
-    volatile double iPitch_Roll;
-    volatile double dPitch_Roll;
+    q16_16_t pPitch_Roll;        // C_MATLABCOM_SCALE_ROLL_PITCH
+    q16_16_t iPitch_Roll;
+    q16_16_t dPitch_Roll;
 
-    volatile double pYaw;
-    volatile double iYaw;
-    volatile double dYaw;
+    q16_16_t pYaw;               // C_MATLABCOM_SCALE_YAW
+    q16_16_t iYaw;
+    q16_16_t dYaw;
 
-    volatile double targetAngleRoll;
-    volatile double targetAnglePitch;
-    volatile double targetAngleYaw;
+    q16_16_t targetAngleRoll;    // C_MATLABCOM_SCALE_ANGLE
+    q16_16_t targetAnglePitch;
+    q16_16_t targetAngleYaw;
 
 } matlab_communication_Pid_Angle_data_t;
 
+// arguments and answers of the link commands (frame format, probe stats,
+// baud rate)
+typedef struct
+{
+    uint32_t baudRate;
+    uint8_t frameFormat;
+    uint8_t resetStats;
+    uint8_t accepted;
+} matlab_communication_link_data_t;
+
+// link health per instance (answer of C_MATLABCOM_ID_LINK_STATS)
+typedef struct
+{
+    uint32_t framesOk;          // executed frames, ASCII and binary
+    uint32_t crcErrors;
+    uint32_t invalidSigns;      // bad sign, frame too short, undecodable
+    uint32_t unknownCommands;
+    uint32_t resyncs;           // frame restarted on STX / oversized binary frame dropped
+    uint32_t bytesDiscarded;    // outside a frame or after a frame error
+    uint32_t badLength;         // binary payload too short or wrong size for the command
+} matlab_communication_link_stats_t;
+
+// frames the controller sends on its own (ACK/NACK, IMU)
+typedef struct
+{
+    uint8_t sequence;
+    uint8_t error;      // matlab_communication_error_t
+} matlab_communication_ack_data_t;
+
+typedef struct
+{
+    uint32_t timestampUs;   // sample time, timebase_nowUs()
+    int16_t x;
+    int16_t y;
+    int16_t z;
+} matlab_communication_imu_data_t;
+
+// clock sync exchange (C_MATLABCOM_ID_TIME_SYNC), NTP style: t1 is the
+// host clock (opaque, echoed), t2/t3 are timebase_nowUs() of the controller
+typedef struct
+{
+    uint32_t hostSend;      // t1
+    uint32_t mcuReceive;    // t2: request received (RX ISR of its last byte)
+    uint32_t mcuSend;       // t3: answer queued
+} matlab_communication_time_sync_t;
+
+// ping (C_MATLABCOM_ID_PING_0): payload is echoed, times in timebase_nowUs()
+typedef struct
+{
+    uint32_t tag;           // host sequence number, echoed
+    uint32_t isrUs;         // RX ISR that queued the last byte of the request
+    uint32_t queuedUs;      // answer queued (after parser and dispatch)
+    uint32_t payload[8];
+} matlab_communication_ping_data_t;
+
+// flight recorder (C_MATLABCOM_ID_REC_CONTROL / C_MATLABCOM_ID_REC_DUMP),
+// the answer of REC_CONTROL is flight_recorder_status_t
+typedef enum
+{
+    E_MATLABCOM_REC_STATUS,
+    E_MATLABCOM_REC_ARM,        // new recording, drops the old one
+    E_MATLABCOM_REC_TRIGGER,
+    E_MATLABCOM_REC_STOP
+} matlab_communication_recorder_action_t;
+
+typedef struct
+{
+    uint8_t action;          // matlab_communication_recorder_action_t
+    uint8_t triggerEvents;   // flight_recorder_event_t bits, 0: command only
+    uint32_t postTrigger;    // records after the trigger
+    uint32_t first;          // dump: first record (0: oldest)
+    uint32_t count;          // dump: records, clipped to the recording
+} matlab_communication_recorder_control_t;
+
  typedef struct
  {
     matlab_communication_practical_cmd_t cmd;
-    uint8_t currentPidAngleCmd;
+    uint8_t currentPidAngleCmd;   // sub command of the frame, 0 if none
     union
     {
         matlab_communication_send_data_t sendData;
         matlab_communication_motor_data_t motorData;
         matlab_communication_Pid_Angle_data_t pidAngleData;
+        matlab_communication_link_data_t linkData;
+        matlab_communication_link_stats_t linkStats;
+        matlab_communication_ack_data_t ackData;
+        matlab_communication_imu_data_t imuData;
+        matlab_communication_time_sync_t timeSync;
+        matlab_communication_ping_data_t pingData;
+        matlab_communication_recorder_control_t recorderControl;
+        flight_recorder_status_t recorderStatus;
+        int32_t raw[C_MATLABCOM_MAX_FIELDS];   // free for application commands
     };
    
  } matlab_communication_data_t;
 
 typedef void (*matlabData_cb_t)(matlab_communication_data_t*);
 
+typedef enum
+{
+    E_MATLABCOM_FIELD_U8,       // uint8_t, binary 1 byte
+    E_MATLABCOM_FIELD_U32,      // uint32_t, binary 4 bytes
+    E_MATLABCOM_FIELD_I32,      // int32_t, binary 4 bytes, ASCII with optional '-'
+    E_MATLABCOM_FIELD_Q16_16,   // q16_16_t, on the wire like I32 as value * scale
+    E_MATLABCOM_FIELD_I16,      // int16_t, binary 2 bytes
+    E_MATLABCOM_FIELD_TYPE_COUNT
+} matlab_communication_field_type_t;
+
+// one field of a request or an answer, offset into matlab_communication_data_t
+typedef struct
+{
+    uint8_t type;       // matlab_communication_field_type_t
+    uint16_t scale;     // E_MATLABCOM_FIELD_Q16_16 only
+    uint16_t offset;
+} matlab_communication_field_t;
+
+// runs in matlabCommunication_poll() once a frame passed its crc; the
+// result is what a sequenced frame gets as ACK (OK) or NACK
+typedef matlab_communication_error_t (*matlab_communication_handler_t)(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context);
+
+// subscriber of one command on one instance (matlabCommunication_subscribe);
+// runs after the handler, only if it succeeded, with the decoded frame as
+// it is in the parser (read only, valid during the call)
+typedef void (*matlab_communication_subscriber_t)(matlab_communication_t* matlabCom, const matlab_communication_data_t* data, void* context);
+
+typedef struct
+{
+    const matlab_communication_field_t* fields;     // after command (and sub command)
+    uint8_t fieldCount;
+    const matlab_communication_field_t* response;   // cmd | response fields, sent after the handler; NULL: no answer
+    uint8_t responseCount;
+    matlab_communication_handler_t handler;
+    void* context;
+} matlab_communication_command_t;
+
+typedef struct
+{
+    uint32_t size;        // capacity of the RX ring
+    uint32_t highWater;   // max. fill level seen
+    uint32_t overflows;   // bytes lost because the ring was full
+} matlab_communication_rx_stats_t;
+
 /*** macros *************************************************************/
+#define MATLABCOM_FIELD(type, member)          { (type), 1u, offsetof(matlab_communication_data_t, member) }
+#define MATLABCOM_FIELD_SCALED(member, scale)  { E_MATLABCOM_FIELD_Q16_16, (scale), offsetof(matlab_communication_data_t, member) }
  /*** functions ************************************************************/
 matlab_communication_error_t matlabCommunication_sendParameter(matlab_communication_t* matlabCom, matlab_communication_data_t* data);
 matlab_communication_error_t matlabCommunication_getParserError(matlab_communication_t* matlabCom);
 void matlabCommunication_registerDataCallback(matlab_communication_t* matlabCom, matlabData_cb_t cb);
-void matlabCommunication_sendImuData(matlab_communication_t* matlabCom, int16_t x, int16_t y, int16_t z);
+void matlabCommunication_sendImuData(matlab_communication_t* matlabCom, uint32_t timestampUs, int16_t x, int16_t y, int16_t z);
+void matlabCommunication_poll(matlab_communication_t* matlabCom);
+void matlabCommunication_parse(matlab_communication_t* matlabCom, const uint8_t* data, size_t len);
+void matlabCommunication_setFrameFormat(matlab_communication_t* matlabCom, matlab_communication_frame_format_t format);
+matlab_communication_frame_format_t matlabCommunication_getFrameFormat(matlab_communication_t* matlabCom);
+void matlabCommunication_getRxStats(matlab_communication_t* matlabCom, matlab_communication_rx_stats_t* stats);
+void matlabCommunication_getLinkStats(matlab_communication_t* matlabCom, matlab_communication_link_stats_t* stats);
+
+// command registry, shared by all instances; register before the first poll.
+// A command with sub commands takes the sub command id as its first field.
+// Frames are limited to the largest of matlab_protocol.h, new commands
+// belong there.
+bool matlabCommunication_registerCommand(uint8_t cmd, const matlab_communication_command_t* command);
+bool matlabCommunication_registerSubCommand(uint8_t cmd, uint8_t subCmd, const matlab_communication_command_t* command);
+// replace the handler of a registered (e.g. built-in) command, subCmd 0 if it has none
+bool matlabCommunication_setHandler(uint8_t cmd, uint8_t subCmd, matlab_communication_handler_t handler, void* context);
+// add a subscriber of a registered command on this instance, subCmd 0 if it
+// has none; several per command, called in the order they subscribed
+bool matlabCommunication_subscribe(matlab_communication_t* matlabCom, uint8_t cmd, uint8_t subCmd, matlab_communication_subscriber_t handler, void* context);
 
 matlab_communication_t* matlabCommunication_new(uart_t* uart);
 void matlabCommunication_init(void);
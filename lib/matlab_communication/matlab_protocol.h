@@ -0,0 +1,247 @@
+/***************************************************************************
+ * matlab_protocol.h
+ * Created on: 21-Oct-2026 09:00:00
+ * M. Schermutzki
+ * Single description of every frame between MATLAB and the controller.
+ * matlab_communication.c expands it into the field tables of the command
+ * registry and exact buffer sizes; tools/gen_matlab_protocol.py (run by
+ * every pio build) turns it into matlab/matlabProtocol.m for the host codec
+ * (protocolEncode.m / protocolDecode.m).
+ * The generator does not run the preprocessor: use literals and the
+ * C_MATLABCOM_ defines of this file only.
+ *
+ * ASCII:  STX | cmd | [sub] | fields (hex, signed with '-') | US | crc | ETX
+ * binary: COBS( cmd | [sub] | fields (little endian) | crc16 ) 0x00
+ * A frame to the controller may carry cmd | C_MATLABCOM_SEQ_FLAG and a
+ * sequence number in front of [sub], it is answered with ACK or NACK.
+ ***************************************************************************/
+#ifndef MATLAB_PROTOCOL_H
+#define MATLAB_PROTOCOL_H
+
+/*** definitions ********************************************************/
+// framing
+#define C_MATLABCOM_STX             (0x02) // start sign
+#define C_MATLABCOM_US              (0x1F) // separator
+#define C_MATLABCOM_ETX             (0x03) // end sign
+#define C_MATLABCOM_BIN_DELIMITER   (0x00)
+#define C_MATLABCOM_SEQ_FLAG        (0x40)
+#define C_MATLABCOM_NO_SUB_CMD      (0xFF)
+
+// wire scale per PID/angle group: gains in 1/10, angles in whole degrees
+#define C_MATLABCOM_SCALE_ROLL_PITCH  (10)
+#define C_MATLABCOM_SCALE_YAW         (10)
+#define C_MATLABCOM_SCALE_ANGLE       (1)
+
+// direction of a message
+#define C_MATLABCOM_TO_MCU    (1)
+#define C_MATLABCOM_TO_HOST   (2)
+#define C_MATLABCOM_BOTH      (3)
+
+/*** field lists: F(type, member of matlab_communication_data_t, scale) ***/
+// type: U8, I16, U32, I32, Q16_16 (on the wire value * scale like I32)
+#define MATLABCOM_FIELDS_NONE(F)
+
+#define MATLABCOM_FIELDS_MOTOR(F) \
+    F(U8, motorData.motor1, 1) \
+    F(U8, motorData.motor2, 1) \
+    F(U8, motorData.motor3, 1) \
+    F(U8, motorData.motor4, 1)
+
+#define MATLABCOM_FIELDS_ROLL_PITCH(F) \
+    F(Q16_16, pidAngleData.pPitch_Roll, C_MATLABCOM_SCALE_ROLL_PITCH) \
+    F(Q16_16, pidAngleData.iPitch_Roll, C_MATLABCOM_SCALE_ROLL_PITCH) \
+    F(Q16_16, pidAngleData.dPitch_Roll, C_MATLABCOM_SCALE_ROLL_PITCH)
+
+#define MATLABCOM_FIELDS_YAW(F) \
+    F(Q16_16, pidAngleData.pYaw, C_MATLABCOM_SCALE_YAW) \
+    F(Q16_16, pidAngleData.iYaw, C_MATLABCOM_SCALE_YAW) \
+    F(Q16_16, pidAngleData.dYaw, C_MATLABCOM_SCALE_YAW)
+
+#define MATLABCOM_FIELDS_ANGLES(F) \
+    F(Q16_16, pidAngleData.targetAngleRoll, C_MATLABCOM_SCALE_ANGLE) \
+    F(Q16_16, pidAngleData.targetAnglePitch, C_MATLABCOM_SCALE_ANGLE) \
+    F(Q16_16, pidAngleData.targetAngleYaw, C_MATLABCOM_SCALE_ANGLE)
+
+#define MATLABCOM_FIELDS_PID_ANGLE(F) \
+    MATLABCOM_FIELDS_ROLL_PITCH(F) \
+    MATLABCOM_FIELDS_YAW(F) \
+    MATLABCOM_FIELDS_ANGLES(F)
+
+#define MATLABCOM_FIELDS_FRAME_FORMAT(F) \
+    F(U8, linkData.frameFormat, 1)
+
+#define MATLABCOM_FIELDS_PROBE_STATS(F) \
+    F(U8, linkData.resetStats, 1)
+
+#define MATLABCOM_FIELDS_BAUD_RATE(F) \
+    F(U32, linkData.baudRate, 1)
+
+#define MATLABCOM_FIELDS_BAUD_ANSWER(F) \
+    F(U32, linkData.baudRate, 1) \
+    F(U8, linkData.accepted, 1)
+
+#define MATLABCOM_FIELDS_LINK_STATS(F) \
+    F(U8, linkData.resetStats, 1)
+
+#define MATLABCOM_FIELDS_LINK_COUNTERS(F) \
+    F(U32, linkStats.framesOk, 1) \
+    F(U32, linkStats.crcErrors, 1) \
+    F(U32, linkStats.invalidSigns, 1) \
+    F(U32, linkStats.unknownCommands, 1) \
+    F(U32, linkStats.resyncs, 1) \
+    F(U32, linkStats.bytesDiscarded, 1) \
+    F(U32, linkStats.badLength, 1)
+
+#define MATLABCOM_FIELDS_TIME_SYNC(F) \
+    F(U32, timeSync.hostSend, 1)
+
+#define MATLABCOM_FIELDS_TIME_SYNC_ANSWER(F) \
+    F(U32, timeSync.hostSend, 1) \
+    F(U32, timeSync.mcuReceive, 1) \
+    F(U32, timeSync.mcuSend, 1)
+
+// ping: request tag | payload, answer tag | ISR | queued | payload
+#define MATLABCOM_FIELDS_PING_PAYLOAD_4(F) \
+    F(U32, pingData.payload[0], 1) \
+    F(U32, pingData.payload[1], 1) \
+    F(U32, pingData.payload[2], 1) \
+    F(U32, pingData.payload[3], 1)
+
+#define MATLABCOM_FIELDS_PING_PAYLOAD_8(F) \
+    MATLABCOM_FIELDS_PING_PAYLOAD_4(F) \
+    F(U32, pingData.payload[4], 1) \
+    F(U32, pingData.payload[5], 1) \
+    F(U32, pingData.payload[6], 1) \
+    F(U32, pingData.payload[7], 1)
+
+#define MATLABCOM_FIELDS_PING_0(F) \
+    F(U32, pingData.tag, 1)
+
+#define MATLABCOM_FIELDS_PING_4(F) \
+    MATLABCOM_FIELDS_PING_0(F) \
+    MATLABCOM_FIELDS_PING_PAYLOAD_4(F)
+
+#define MATLABCOM_FIELDS_PING_8(F) \
+    MATLABCOM_FIELDS_PING_0(F) \
+    MATLABCOM_FIELDS_PING_PAYLOAD_8(F)
+
+#define MATLABCOM_FIELDS_PONG_0(F) \
+    F(U32, pingData.tag, 1) \
+    F(U32, pingData.isrUs, 1) \
+    F(U32, pingData.queuedUs, 1)
+
+#define MATLABCOM_FIELDS_PONG_4(F) \
+    MATLABCOM_FIELDS_PONG_0(F) \
+    MATLABCOM_FIELDS_PING_PAYLOAD_4(F)
+
+#define MATLABCOM_FIELDS_PONG_8(F) \
+    MATLABCOM_FIELDS_PONG_0(F) \
+    MATLABCOM_FIELDS_PING_PAYLOAD_8(F)
+
+// flight recorder: action | post trigger records | trigger events, answer:
+// the recorder status; dump: first record (0: oldest) | count
+#define MATLABCOM_FIELDS_REC_CONTROL(F) \
+    F(U8, recorderControl.action, 1) \
+    F(U32, recorderControl.postTrigger, 1) \
+    F(U8, recorderControl.triggerEvents, 1)
+
+#define MATLABCOM_FIELDS_REC_STATUS(F) \
+    F(U8, recorderStatus.state, 1) \
+    F(U8, recorderStatus.recordSize, 1) \
+    F(U32, recorderStatus.capacity, 1) \
+    F(U32, recorderStatus.count, 1) \
+    F(U32, recorderStatus.triggerIndex, 1) \
+    F(U32, recorderStatus.sequence, 1)
+
+#define MATLABCOM_FIELDS_REC_DUMP(F) \
+    F(U32, recorderControl.first, 1) \
+    F(U32, recorderControl.count, 1)
+
+#define MATLABCOM_FIELDS_ACK(F) \
+    F(U8, ackData.sequence, 1) \
+    F(U8, ackData.error, 1)
+
+#define MATLABCOM_FIELDS_IMU(F) \
+    F(U32, imuData.timestampUs, 1) \
+    F(I16, imuData.x, 1) \
+    F(I16, imuData.y, 1) \
+    F(I16, imuData.z, 1)
+
+/*** messages: X(name, cmd, sub, direction, fields, ASCII with cmd) *******/
+// FRAME_FORMAT: the answer is sent in the old format, then it switches
+// PROBE_STATS:  answer of variable length, built in _sendProbeStats()
+// LINK_STATS:   reset flag, answer: counters, reset afterwards on request
+// TIME_SYNC:    host time t1 (echoed), answer t1 | t2 | t3 in MCU microseconds
+// PING_<n>:     echo with n payload words (sub command = n), answer stamped
+//               with the RX ISR of the frame end and the time it was queued
+// REC_CONTROL:  action 0 status, 1 arm, 2 trigger, 3 stop; answer REC_STATUS
+// REC_DUMP:     answer in binary chunks whatever the frame format,
+//               0x00 | COBS(0x0C | U32 index | records | crc16) | 0x00, records
+//               as flight_record_t (flight_recorder.h); no records: end
+// IMU_DATA:     ASCII frame without the cmd field (timestamp | x | y | z)
+#define MATLABCOM_MESSAGES(X) \
+    X(MOTOR_VALUES,        0x01, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_MCU,  MATLABCOM_FIELDS_MOTOR,        1) \
+    X(ROLL_PITCH_GAINS,    0x02, 0x04,                   C_MATLABCOM_TO_MCU,  MATLABCOM_FIELDS_ROLL_PITCH,   1) \
+    X(YAW_GAINS,           0x02, 0x06,                   C_MATLABCOM_TO_MCU,  MATLABCOM_FIELDS_YAW,          1) \
+    X(TARGET_ANGLES,       0x02, 0x07,                   C_MATLABCOM_TO_MCU,  MATLABCOM_FIELDS_ANGLES,       1) \
+    X(PID_ANGLE_VALUES,    0x02, 0x08,                   C_MATLABCOM_TO_MCU,  MATLABCOM_FIELDS_PID_ANGLE,    1) \
+    X(FRAME_FORMAT,        0x03, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_BOTH,    MATLABCOM_FIELDS_FRAME_FORMAT, 1) \
+    X(PROBE_STATS,         0x04, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_MCU,  MATLABCOM_FIELDS_PROBE_STATS,  1) \
+    X(PID_ANGLE_READ,      0x05, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_MCU,  MATLABCOM_FIELDS_NONE,         1) \
+    X(PID_ANGLE_READ_BACK, 0x05, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_HOST, MATLABCOM_FIELDS_PID_ANGLE,    1) \
+    X(ACK,                 0x06, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_HOST, MATLABCOM_FIELDS_ACK,          1) \
+    X(BAUD_RATE,           0x07, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_MCU,  MATLABCOM_FIELDS_BAUD_RATE,    1) \
+    X(BAUD_RATE_ANSWER,    0x07, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_HOST, MATLABCOM_FIELDS_BAUD_ANSWER,  1) \
+    X(LINK_STATS,          0x08, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_MCU,  MATLABCOM_FIELDS_LINK_STATS,   1) \
+    X(LINK_STATS_ANSWER,   0x08, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_HOST, MATLABCOM_FIELDS_LINK_COUNTERS, 1) \
+    X(TIME_SYNC,           0x09, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_MCU,  MATLABCOM_FIELDS_TIME_SYNC,    1) \
+    X(TIME_SYNC_ANSWER,    0x09, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_HOST, MATLABCOM_FIELDS_TIME_SYNC_ANSWER, 1) \
+    X(PING_0,              0x0A, 0x00,                   C_MATLABCOM_TO_MCU,  MATLABCOM_FIELDS_PING_0,       1) \
+    X(PING_4,              0x0A, 0x04,                   C_MATLABCOM_TO_MCU,  MATLABCOM_FIELDS_PING_4,       1) \
+    X(PING_8,              0x0A, 0x08,                   C_MATLABCOM_TO_MCU,  MATLABCOM_FIELDS_PING_8,       1) \
+    X(PING_ANSWER_0,       0x0A, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_HOST, MATLABCOM_FIELDS_PONG_0,       1) \
+    X(PING_ANSWER_4,       0x0A, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_HOST, MATLABCOM_FIELDS_PONG_4,       1) \
+    X(PING_ANSWER_8,       0x0A, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_HOST, MATLABCOM_FIELDS_PONG_8,       1) \
+    X(REC_CONTROL,         0x0B, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_MCU,  MATLABCOM_FIELDS_REC_CONTROL,  1) \
+    X(REC_STATUS,          0x0B, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_HOST, MATLABCOM_FIELDS_REC_STATUS,   1) \
+    X(REC_DUMP,            0x0C, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_MCU,  MATLABCOM_FIELDS_REC_DUMP,     1) \
+    X(NACK,                0x15, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_HOST, MATLABCOM_FIELDS_ACK,          1) \
+    X(IMU_DATA,            0x81, C_MATLABCOM_NO_SUB_CMD, C_MATLABCOM_TO_HOST, MATLABCOM_FIELDS_IMU,          0)
+
+/*** derived at compile time *********************************************/
+// max. signs of an ASCII field incl. its separator
+#define C_MATLABCOM_ASCII_WIDTH_U8      (3u)    // "FF" US
+#define C_MATLABCOM_ASCII_WIDTH_I16     (6u)    // "-8000" US
+#define C_MATLABCOM_ASCII_WIDTH_U32     (9u)    // "FFFFFFFF" US
+#define C_MATLABCOM_ASCII_WIDTH_I32     (10u)   // "-80000000" US
+#define C_MATLABCOM_ASCII_WIDTH_Q16_16  (10u)
+#define C_MATLABCOM_ASCII_OVERHEAD      (6u)    // STX, crc, ETX
+
+#define C_MATLABCOM_BINARY_WIDTH_U8     (1u)
+#define C_MATLABCOM_BINARY_WIDTH_I16    (2u)
+#define C_MATLABCOM_BINARY_WIDTH_U32    (4u)
+#define C_MATLABCOM_BINARY_WIDTH_I32    (4u)
+#define C_MATLABCOM_BINARY_WIDTH_Q16_16 (4u)
+#define C_MATLABCOM_BIN_OVERHEAD        (3u)    // cmd + crc16
+
+#define MATLABCOM_GEN_COUNT(type, member, scale)   + 1u
+#define MATLABCOM_GEN_ASCII(type, member, scale)   + C_MATLABCOM_ASCII_WIDTH_##type
+#define MATLABCOM_GEN_BINARY(type, member, scale)  + C_MATLABCOM_BINARY_WIDTH_##type
+#define MATLABCOM_GEN_HAS_SUB(sub)                 ((sub) != C_MATLABCOM_NO_SUB_CMD)
+
+// per message: C_MATLABCOM_ID_/SUB_<name>, field count, binary payload
+// (fields only), largest ASCII frame and binary frame (without sequence)
+#define MATLABCOM_GEN_CONSTANTS(name, cmd, sub, direction, fields, asciiCmd) \
+    C_MATLABCOM_ID_##name = (cmd), \
+    C_MATLABCOM_SUB_##name = (sub), \
+    C_MATLABCOM_FIELD_COUNT_##name = 0u fields(MATLABCOM_GEN_COUNT), \
+    C_MATLABCOM_PAYLOAD_SIZE_##name = 0u fields(MATLABCOM_GEN_BINARY), \
+    C_MATLABCOM_ASCII_SIZE_##name = C_MATLABCOM_ASCII_OVERHEAD \
+        + ((asciiCmd) ? C_MATLABCOM_ASCII_WIDTH_U8 : 0u) \
+        + (MATLABCOM_GEN_HAS_SUB(sub) ? C_MATLABCOM_ASCII_WIDTH_U8 : 0u) fields(MATLABCOM_GEN_ASCII), \
+    C_MATLABCOM_BINARY_SIZE_##name = C_MATLABCOM_BIN_OVERHEAD \
+        + (MATLABCOM_GEN_HAS_SUB(sub) ? 1u : 0u) fields(MATLABCOM_GEN_BINARY),
+
+enum { MATLABCOM_MESSAGES(MATLABCOM_GEN_CONSTANTS) };
+
+#endif // MATLAB_PROTOCOL_H
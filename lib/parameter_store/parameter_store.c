@@ -0,0 +1,188 @@
+/***************************************************************************
+ * parameter_store.c
+ * Created on: 19-Oct-2026 16:00:00
+ * M. Schermutzki
+ ***************************************************************************/
+
+/*** includes **************************************************************/
+#include <stddef.h>
+
+#include "parameter_store.h"
+
+/*** macros ***************************************************************/
+#define C_PARAMSTORE_VALUES  (3u)
+
+// orders the counter against the copies (compiler and CPU, DMB on the M3)
+#define PARAMETER_STORE_BARRIER()  __sync_synchronize()
+
+/*** definitions **********************************************************/
+typedef struct
+{
+    volatile uint32_t sequence;    // odd: copy 0 is being written, read copy 1
+    volatile q16_16_t copy[2][E_PARAMSTORE_GROUP_COUNT][C_PARAMSTORE_VALUES];
+} parameter_store_slot_t;
+
+/*** local variables ******************************************************/
+// one latch for all groups: a single counter selects the copy for every
+// group, so whole-set readers need no agreement between group counters
+static parameter_store_slot_t _slot;
+static volatile uint32_t _versions[E_PARAMSTORE_GROUP_COUNT];
+static volatile uint32_t _retries = 0;
+
+/*** prototypes ***********************************************************/
+static void _publish(uint8_t first, uint8_t count, const q16_16_t values[][C_PARAMSTORE_VALUES]);
+static void _read(uint8_t first, uint8_t count, q16_16_t values[][C_PARAMSTORE_VALUES]);
+
+/*** functions ************************************************************/
+
+/***************************************************************************
+ * Writer for groups first .. first + count - 1: copy 0 while readers are
+ * sent to copy 1, then the other way. Both copies hold the complete set
+ * afterwards, the other groups stay as they are
+ **************************************************************************/ 
+static void _publish(uint8_t first, uint8_t count, const q16_16_t values[][C_PARAMSTORE_VALUES])
+{
+    for (uint8_t copy = 0; copy < 2u; copy++)
+    {
+        _slot.sequence++;
+        PARAMETER_STORE_BARRIER();
+
+        for (uint8_t group = 0; group < count; group++)
+        {
+            for (uint8_t i = 0; i < C_PARAMSTORE_VALUES; i++)
+            {
+                _slot.copy[copy][first + group][i] = values[group][i];
+            }
+        }
+        PARAMETER_STORE_BARRIER();
+    }
+
+    for (uint8_t group = 0; group < count; group++)
+    {
+        _versions[first + group]++;
+    }
+}
+
+/***************************************************************************
+ * Reader: copy the groups from the copy the counter points to, retry only
+ * if a publish ran in between. A reader that interrupts the writer sees
+ * no change of the counter and never retries
+ **************************************************************************/ 
+static void _read(uint8_t first, uint8_t count, q16_16_t values[][C_PARAMSTORE_VALUES])
+{
+    uint32_t sequence;
+
+    while (true)
+    {
+        sequence = _slot.sequence;
+        PARAMETER_STORE_BARRIER();
+
+        for (uint8_t group = 0; group < count; group++)
+        {
+            const volatile q16_16_t* copy = _slot.copy[sequence & 1u][first + group];
+            for (uint8_t i = 0; i < C_PARAMSTORE_VALUES; i++)
+            {
+                values[group][i] = copy[i];
+            }
+        }
+        PARAMETER_STORE_BARRIER();
+
+        if (_slot.sequence == sequence) return;
+        _retries++;
+    }
+}
+
+void parameterStore_init(void)
+{
+    static const q16_16_t zero[E_PARAMSTORE_GROUP_COUNT][C_PARAMSTORE_VALUES] = {{0}};
+
+    _publish(0, E_PARAMSTORE_GROUP_COUNT, zero);
+    _slot.sequence = 0;
+    for (uint8_t group = 0; group < E_PARAMSTORE_GROUP_COUNT; group++)
+    {
+        _versions[group] = 0;
+    }
+    _retries = 0;
+}
+
+bool parameterStore_publishGains(parameter_store_group_t group, const parameter_store_gains_t* gains)
+{
+    if (!gains || (uint32_t)group >= E_PARAMSTORE_ANGLE) return false;
+
+    const q16_16_t values[1][C_PARAMSTORE_VALUES] = {{gains->p, gains->i, gains->d}};
+    _publish((uint8_t)group, 1u, values);
+    return true;
+}
+
+bool parameterStore_publishAngles(const parameter_store_angles_t* angles)
+{
+    if (!angles) return false;
+
+    const q16_16_t values[1][C_PARAMSTORE_VALUES] = {{angles->roll, angles->pitch, angles->yaw}};
+    _publish(E_PARAMSTORE_ANGLE, 1u, values);
+    return true;
+}
+
+bool parameterStore_readGains(parameter_store_group_t group, parameter_store_gains_t* gains)
+{
+    q16_16_t values[1][C_PARAMSTORE_VALUES];
+
+    if (!gains || (uint32_t)group >= E_PARAMSTORE_ANGLE) return false;
+    _read((uint8_t)group, 1u, values);
+
+    gains->p = values[0][0];
+    gains->i = values[0][1];
+    gains->d = values[0][2];
+    return true;
+}
+
+bool parameterStore_readAngles(parameter_store_angles_t* angles)
+{
+    q16_16_t values[1][C_PARAMSTORE_VALUES];
+
+    if (!angles) return false;
+    _read(E_PARAMSTORE_ANGLE, 1u, values);
+
+    angles->roll  = values[0][0];
+    angles->pitch = values[0][1];
+    angles->yaw   = values[0][2];
+    return true;
+}
+
+bool parameterStore_publishSet(const parameter_store_set_t* set)
+{
+    if (!set) return false;
+
+    const q16_16_t values[E_PARAMSTORE_GROUP_COUNT][C_PARAMSTORE_VALUES] =
+    {
+        [E_PARAMSTORE_ROLL_PITCH] = {set->rollPitch.p, set->rollPitch.i, set->rollPitch.d},
+        [E_PARAMSTORE_YAW]        = {set->yaw.p, set->yaw.i, set->yaw.d},
+        [E_PARAMSTORE_ANGLE]      = {set->angles.roll, set->angles.pitch, set->angles.yaw}
+    };
+    _publish(0, E_PARAMSTORE_GROUP_COUNT, values);
+    return true;
+}
+
+bool parameterStore_readSet(parameter_store_set_t* set)
+{
+    q16_16_t values[E_PARAMSTORE_GROUP_COUNT][C_PARAMSTORE_VALUES];
+
+    if (!set) return false;
+    _read(0, E_PARAMSTORE_GROUP_COUNT, values);
+
+    set->rollPitch = (parameter_store_gains_t){values[E_PARAMSTORE_ROLL_PITCH][0], values[E_PARAMSTORE_ROLL_PITCH][1], values[E_PARAMSTORE_ROLL_PITCH][2]};
+    set->yaw       = (parameter_store_gains_t){values[E_PARAMSTORE_YAW][0], values[E_PARAMSTORE_YAW][1], values[E_PARAMSTORE_YAW][2]};
+    set->angles    = (parameter_store_angles_t){values[E_PARAMSTORE_ANGLE][0], values[E_PARAMSTORE_ANGLE][1], values[E_PARAMSTORE_ANGLE][2]};
+    return true;
+}
+
+uint32_t parameterStore_getVersion(parameter_store_group_t group)
+{
+    if ((uint32_t)group >= E_PARAMSTORE_GROUP_COUNT) return 0;
+    return _versions[group];
+}
+
+uint32_t parameterStore_getRetries(void)
+{
+    return _retries;
+}
@@ -0,0 +1,70 @@
+/*************************************************************************
+ * parameter_store.h
+ * Headerfile for parameter_store.c
+ * Created on: 19-Oct-2026 16:00:00
+ * M. Schermutzki
+ * PID gains and set points published as whole groups. All groups share
+ * one sequence counter and two copies of the full set (latch): the writer
+ * updates one copy while readers use the other, so a reader always gets
+ * complete groups, never waits for the writer and never has to disable
+ * interrupts - also when it interrupts the writer. One writer (context)
+ * for the whole store.
+ * publishSet/readSet move all groups as one transaction: a reader of the
+ * whole set never sees gains of one upload with set points of another.
+ *************************************************************************/
+#ifndef PARAMETER_STORE_H
+#define PARAMETER_STORE_H
+
+/*** includes ************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed_point.h"
+
+/*** definitions ********************************************************/
+typedef enum
+{
+    E_PARAMSTORE_ROLL_PITCH,    // gains
+    E_PARAMSTORE_YAW,           // gains
+    E_PARAMSTORE_ANGLE,         // set points
+    E_PARAMSTORE_GROUP_COUNT
+} parameter_store_group_t;
+
+typedef struct
+{
+    q16_16_t p;
+    q16_16_t i;
+    q16_16_t d;
+} parameter_store_gains_t;
+
+typedef struct
+{
+    q16_16_t roll;
+    q16_16_t pitch;
+    q16_16_t yaw;
+} parameter_store_angles_t;
+
+typedef struct
+{
+    parameter_store_gains_t rollPitch;
+    parameter_store_gains_t yaw;
+    parameter_store_angles_t angles;
+} parameter_store_set_t;
+
+/*** functions ***********************************************************/
+void parameterStore_init(void);
+
+bool parameterStore_publishGains(parameter_store_group_t group, const parameter_store_gains_t* gains);
+bool parameterStore_publishAngles(const parameter_store_angles_t* angles);
+
+bool parameterStore_readGains(parameter_store_group_t group, parameter_store_gains_t* gains);
+bool parameterStore_readAngles(parameter_store_angles_t* angles);
+
+// all groups at once
+bool parameterStore_publishSet(const parameter_store_set_t* set);
+bool parameterStore_readSet(parameter_store_set_t* set);
+
+// incremented by every publish, lets the control loop see changes cheaply
+uint32_t parameterStore_getVersion(parameter_store_group_t group);
+uint32_t parameterStore_getRetries(void);   // reads repeated because of a concurrent publish
+
+#endif // PARAMETER_STORE_H
@@ -0,0 +1,69 @@
+/***************************************************************************
+ * probe.c
+ * Created on: 19-Oct-2026 13:00:00
+ * M. Schermutzki
+ ***************************************************************************/
+
+/*** includes **************************************************************/
+#include <string.h>
+
+#include "probe.h"
+#include "stm32f2xx_hal.h"
+
+/*** local variables ******************************************************/
+static probe_stats_t _probes[E_PROBE_COUNT];
+
+/*** functions ************************************************************/
+
+/***************************************************************************
+ * log2 bucket of a measurement
+ **************************************************************************/ 
+static inline uint32_t _bucket(uint32_t cycles)
+{
+    uint32_t bits = (cycles == 0) ? 0 : 32u - (uint32_t)__builtin_clz(cycles);
+
+    if (bits <= C_PROBE_HIST_SHIFT) return 0;
+    bits -= C_PROBE_HIST_SHIFT;
+    return (bits < C_PROBE_HIST_BUCKETS) ? bits : C_PROBE_HIST_BUCKETS - 1u;
+}
+
+void probe_record(probe_id_t id, uint32_t cycles)
+{
+    if ((uint32_t)id >= E_PROBE_COUNT) return;
+
+    probe_stats_t* probe = &_probes[id];
+
+    if (probe->count == 0 || cycles < probe->minCycles) probe->minCycles = cycles;
+    if (cycles > probe->maxCycles) probe->maxCycles = cycles;
+    probe->sumCycles += cycles;
+    probe->histogram[_bucket(cycles)]++;
+    probe->count++;
+}
+
+/***************************************************************************
+ * Consistent copy of one probe (ISR probes can fire during the copy)
+ **************************************************************************/ 
+bool probe_getStats(probe_id_t id, probe_stats_t* stats)
+{
+    if ((uint32_t)id >= E_PROBE_COUNT || !stats) return false;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = _probes[id];
+    __set_PRIMASK(primask);
+    return true;
+}
+
+uint32_t probe_getMean(const probe_stats_t* stats)
+{
+    if (!stats || stats->count == 0) return 0;
+    return (uint32_t)(stats->sumCycles / stats->count);
+}
+
+void probe_reset(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memset(_probes, 0, sizeof(_probes));
+    __set_PRIMASK(primask);
+}
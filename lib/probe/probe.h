@@ -0,0 +1,62 @@
+/*************************************************************************
+ * probe.h
+ * Headerfile for probe.c
+ * Created on: 19-Oct-2026 13:00:00
+ * M. Schermutzki
+ * Hot path timing. PROBE_START/PROBE_STOP measure the cycles between the
+ * two points with cycleCounter_now() and keep count, min, max, sum and a
+ * log2 histogram per probe. With C_PROBE_ENABLE = 0 (default) the macros
+ * compile to nothing. A probe must only be used from one context (ISR or
+ * main loop), the statistics are not locked.
+ *************************************************************************/
+#ifndef PROBE_H
+#define PROBE_H
+
+/*** includes ************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*** macros *************************************************************/
+#ifndef C_PROBE_ENABLE
+#define C_PROBE_ENABLE  (0)
+#endif
+
+// bucket 0: < 16 cycles, bucket n: [2^(n+3), 2^(n+4)), last bucket open
+#define C_PROBE_HIST_BUCKETS  (12u)
+#define C_PROBE_HIST_SHIFT    (4u)
+
+/*** definitions ********************************************************/
+typedef enum
+{
+    E_PROBE_UART_RX_CPLT,       // HAL_UART_RxCpltCallback
+    E_PROBE_PARSER_BYTE,        // one parser state call
+    E_PROBE_DATA_CALLBACK,      // command handler (matlab_communication registry)
+    E_PROBE_SEND_IMU,           // matlabCommunication_sendImuData
+    E_PROBE_COUNT
+} probe_id_t;
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t sumCycles;
+    uint32_t histogram[C_PROBE_HIST_BUCKETS];
+} probe_stats_t;
+
+#if C_PROBE_ENABLE
+#include "cycle_counter.h"
+#define PROBE_START(id)  uint32_t _probeStart_##id = cycleCounter_now()
+#define PROBE_STOP(id)   probe_record((id), cycleCounter_now() - _probeStart_##id)
+#else
+#define PROBE_START(id)  ((void)0)
+#define PROBE_STOP(id)   ((void)0)
+#endif
+
+/*** functions ***********************************************************/
+void probe_record(probe_id_t id, uint32_t cycles);
+bool probe_getStats(probe_id_t id, probe_stats_t* stats);
+uint32_t probe_getMean(const probe_stats_t* stats);
+void probe_reset(void);
+
+#endif // PROBE_H
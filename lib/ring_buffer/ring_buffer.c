@@ -0,0 +1,143 @@
+/***************************************************************************
+ * ring_buffer.c
+ * Created on: 17-Oct-2026 10:30:00
+ * M. Schermutzki
+ ***************************************************************************/
+
+/*** includes **************************************************************/
+#include <string.h>
+#include "ring_buffer.h"
+
+/*** macros ***************************************************************/
+// data must be visible before the index that publishes it (DMB on Cortex-M)
+#define RING_BUFFER_BARRIER()  __sync_synchronize()
+
+/*** functions ************************************************************/
+
+/***************************************************************************
+ * Attach storage; size has to be a power of two
+ **************************************************************************/ 
+bool ringBuffer_init(ring_buffer_t* rb, uint8_t* storage, uint32_t size)
+{
+    if (!rb || !storage || size == 0 || (size & (size - 1u)) != 0) return false;
+
+    rb->buffer = storage;
+    rb->mask = size - 1u;
+    rb->head = 0;
+    rb->tail = 0;
+    rb->highWater = 0;
+    rb->overflows = 0;
+    return true;
+}
+
+/***************************************************************************
+ * Append a single byte (ISR fast path)
+ **************************************************************************/ 
+bool ringBuffer_put(ring_buffer_t* rb, uint8_t data)
+{
+    uint32_t head = rb->head;
+    uint32_t count = head - rb->tail;
+
+    if (count > rb->mask)
+    {
+        rb->overflows++;
+        return false;
+    }
+
+    rb->buffer[head & rb->mask] = data;
+    if (count + 1u > rb->highWater) rb->highWater = count + 1u;
+
+    RING_BUFFER_BARRIER();
+    rb->head = head + 1u;
+    return true;
+}
+
+/***************************************************************************
+ * Copy a complete block into the ring (all or nothing)
+ **************************************************************************/ 
+bool ringBuffer_write(ring_buffer_t* rb, const uint8_t* data, size_t len)
+{
+    if (!rb || !data) return false;
+    if (len > ringBuffer_free(rb))
+    {
+        rb->overflows += (uint32_t)len;
+        return false;
+    }
+
+    uint32_t head = rb->head;
+    uint32_t offset = head & rb->mask;
+    size_t first = (rb->mask + 1u) - offset;
+
+    if (first > len) first = len;
+    memcpy(&rb->buffer[offset], data, first);
+    memcpy(rb->buffer, data + first, len - first);
+
+    uint32_t count = (head - rb->tail) + (uint32_t)len;
+    if (count > rb->highWater) rb->highWater = count;
+
+    RING_BUFFER_BARRIER();
+    rb->head = head + (uint32_t)len;
+    return true;
+}
+
+/***************************************************************************
+ * Take a single byte
+ **************************************************************************/ 
+bool ringBuffer_get(ring_buffer_t* rb, uint8_t* data)
+{
+    uint32_t tail = rb->tail;
+    if (rb->head == tail) return false;
+
+    RING_BUFFER_BARRIER();
+    *data = rb->buffer[tail & rb->mask];
+
+    RING_BUFFER_BARRIER();
+    rb->tail = tail + 1u;
+    return true;
+}
+
+/***************************************************************************
+ * Longest readable block without wrap-around (for DMA/IT transfers)
+ **************************************************************************/ 
+size_t ringBuffer_peekContiguous(const ring_buffer_t* rb, const uint8_t** data)
+{
+    if (!rb || !data) return 0;
+
+    uint32_t tail = rb->tail;
+    size_t count = rb->head - tail;
+    uint32_t offset = tail & rb->mask;
+    size_t toEnd = (rb->mask + 1u) - offset;
+
+    RING_BUFFER_BARRIER();
+    *data = &rb->buffer[offset];
+    return (count < toEnd) ? count : toEnd;
+}
+
+/***************************************************************************
+ * Release bytes that have been consumed
+ **************************************************************************/ 
+void ringBuffer_advance(ring_buffer_t* rb, size_t len)
+{
+    if (!rb) return;
+
+    size_t count = rb->head - rb->tail;
+    if (len > count) len = count;
+
+    RING_BUFFER_BARRIER();
+    rb->tail += (uint32_t)len;
+}
+
+/***************************************************************************
+ * Fill level
+ **************************************************************************/ 
+size_t ringBuffer_count(const ring_buffer_t* rb)
+{
+    if (!rb) return 0;
+    return rb->head - rb->tail;
+}
+
+size_t ringBuffer_free(const ring_buffer_t* rb)
+{
+    if (!rb) return 0;
+    return (rb->mask + 1u) - (rb->head - rb->tail);
+}
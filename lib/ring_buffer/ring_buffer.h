@@ -0,0 +1,44 @@
+/*************************************************************************
+ * ring_buffer.h
+ * Headerfile for ring_buffer.c
+ * Created on: 17-Oct-2026 10:30:00
+ * M. Schermutzki
+ * Lock-free byte ring for exactly one producer and one consumer (e.g.
+ * main loop -> ISR or ISR -> main loop). The storage size must be a
+ * power of two; head and tail run freely and are masked on access.
+ *************************************************************************/
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+/*** includes ************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*** definitions ********************************************************/
+typedef struct
+{
+    uint8_t* buffer;
+    uint32_t mask;
+    volatile uint32_t head;   // nur vom Producer geschrieben
+    volatile uint32_t tail;   // nur vom Consumer geschrieben
+    uint32_t highWater;       // max. Füllstand seit init (Producer)
+    uint32_t overflows;       // abgewiesene Bytes (Producer)
+} ring_buffer_t;
+
+/*** functions ***********************************************************/
+bool ringBuffer_init(ring_buffer_t* rb, uint8_t* storage, uint32_t size);
+
+// producer side
+bool ringBuffer_put(ring_buffer_t* rb, uint8_t data);
+bool ringBuffer_write(ring_buffer_t* rb, const uint8_t* data, size_t len);
+
+// consumer side
+bool ringBuffer_get(ring_buffer_t* rb, uint8_t* data);
+size_t ringBuffer_peekContiguous(const ring_buffer_t* rb, const uint8_t** data);
+void ringBuffer_advance(ring_buffer_t* rb, size_t len);
+
+size_t ringBuffer_count(const ring_buffer_t* rb);
+size_t ringBuffer_free(const ring_buffer_t* rb);
+
+#endif // RING_BUFFER_H
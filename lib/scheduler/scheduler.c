@@ -0,0 +1,271 @@
+/***************************************************************************
+ * scheduler.c
+ * Created on: 19-Oct-2026 09:00:00
+ * M. Schermutzki
+ ***************************************************************************/
+
+/*** includes **************************************************************/
+#include <stddef.h>
+
+#include "scheduler.h"
+#include "cycle_counter.h"
+#include "stm32f2xx_hal.h"
+
+/*** macros ***************************************************************/
+#define C_SCHEDULER_MAX_TASKS  (8u)
+
+/*** definitions **********************************************************/
+struct scheduler_task_s
+{
+    const char* name;
+    scheduler_task_cb_t cb;
+    void* context;
+    uint32_t periodTicks;
+    uint8_t priority;
+    bool isInUse;
+
+    // written by scheduler_tick()
+    uint32_t countdown;
+    volatile bool pending;
+    volatile uint32_t releaseCycles;
+    volatile uint32_t overruns;
+
+    // written by the dispatcher
+    uint32_t runs;
+    uint32_t lastCycles;
+    uint32_t maxCycles;
+    uint32_t maxJitterCycles;
+    uint64_t busyCycles;
+};
+
+/*** local variables ******************************************************/
+static struct scheduler_task_s _tasks[C_SCHEDULER_MAX_TASKS];
+static scheduler_task_t* _order[C_SCHEDULER_MAX_TASKS];   // sorted by priority
+static volatile uint8_t _taskCount = 0;
+static volatile uint32_t _ticks = 0;
+static uint32_t _statsStartTick = 0;
+static bool _initialised = false;
+
+/*** functions ************************************************************/
+
+/***************************************************************************
+ * HAL time base and task release
+ **************************************************************************/ 
+void SysTick_Handler(void)
+{
+    HAL_IncTick();
+    scheduler_tick();
+}
+
+void scheduler_init(void)
+{
+    if (_initialised) return;
+
+    for (uint8_t i = 0; i < C_SCHEDULER_MAX_TASKS; i++)
+    {
+        _tasks[i].isInUse = false;
+    }
+    _taskCount = 0;
+    cycleCounter_init();
+    _initialised = true;
+}
+
+/***************************************************************************
+ * Create a periodic task; equal priorities run in creation order
+ **************************************************************************/ 
+scheduler_task_t* scheduler_newTask(const char* name, uint32_t periodTicks, uint8_t priority,
+                                    scheduler_task_cb_t cb, void* context)
+{
+    if (!_initialised || !cb || periodTicks == 0 || _taskCount >= C_SCHEDULER_MAX_TASKS) return NULL;
+
+    for (uint8_t i = 0; i < C_SCHEDULER_MAX_TASKS; i++)
+    {
+        if (!_tasks[i].isInUse)
+        {
+            scheduler_task_t* task = &_tasks[i];
+
+            task->name = name;
+            task->cb = cb;
+            task->context = context;
+            task->periodTicks = periodTicks;
+            task->priority = priority;
+            task->countdown = periodTicks;
+            task->pending = false;
+            task->overruns = 0;
+            task->runs = 0;
+            task->lastCycles = 0;
+            task->maxCycles = 0;
+            task->maxJitterCycles = 0;
+            task->busyCycles = 0;
+
+            uint32_t primask = __get_PRIMASK();
+            __disable_irq();
+
+            uint8_t pos = _taskCount;
+            while (pos > 0 && _order[pos - 1u]->priority > priority)
+            {
+                _order[pos] = _order[pos - 1u];
+                pos--;
+            }
+            _order[pos] = task;
+            task->isInUse = true;
+            _taskCount++;
+
+            __set_PRIMASK(primask);
+            return task;
+        }
+    }
+
+    return NULL;
+}
+
+/***************************************************************************
+ * Tick (SysTick context): release every task whose period has elapsed
+ **************************************************************************/ 
+void scheduler_tick(void)
+{
+    uint32_t now = cycleCounter_now();
+    _ticks++;
+
+    for (uint8_t i = 0; i < _taskCount; i++)
+    {
+        scheduler_task_t* task = _order[i];
+
+        if (--task->countdown != 0) continue;
+        task->countdown = task->periodTicks;
+
+        if (task->pending)
+        {
+            // previous release not served yet: drop this one
+            task->overruns++;
+        }
+        else
+        {
+            task->releaseCycles = now;
+            task->pending = true;
+        }
+    }
+}
+
+/***************************************************************************
+ * Run the highest priority released task, false if none was released
+ **************************************************************************/ 
+bool scheduler_runOnce(void)
+{
+    for (uint8_t i = 0; i < _taskCount; i++)
+    {
+        scheduler_task_t* task = _order[i];
+
+        if (!task->pending) continue;
+
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        uint32_t release = task->releaseCycles;
+        task->pending = false;
+        __set_PRIMASK(primask);
+
+        uint32_t start = cycleCounter_now();
+        task->cb(task->context);
+        uint32_t cycles = cycleCounter_now() - start;
+
+        uint32_t jitter = start - release;
+        task->runs++;
+        task->lastCycles = cycles;
+        task->busyCycles += cycles;
+        if (cycles > task->maxCycles) task->maxCycles = cycles;
+        if (jitter > task->maxJitterCycles) task->maxJitterCycles = jitter;
+        return true;
+    }
+
+    return false;
+}
+
+/***************************************************************************
+ * Scheduler main loop, never returns
+ **************************************************************************/ 
+void scheduler_run(void)
+{
+    while (1)
+    {
+        if (scheduler_runOnce()) continue;
+
+        // WFI also wakes with PRIMASK set, so no release is missed between
+        // the check and the sleep
+        __disable_irq();
+        bool released = false;
+        for (uint8_t i = 0; i < _taskCount && !released; i++)
+        {
+            released = _order[i]->pending;
+        }
+        if (!released) __WFI();
+        __enable_irq();
+    }
+}
+
+uint8_t scheduler_getTaskCount(void)
+{
+    return _taskCount;
+}
+
+scheduler_task_t* scheduler_getTask(uint8_t index)
+{
+    return (index < _taskCount) ? _order[index] : NULL;
+}
+
+/***************************************************************************
+ * Statistics (main context)
+ **************************************************************************/ 
+static uint32_t _loadPermille(uint64_t busyCycles)
+{
+    uint64_t window = (uint64_t)(_ticks - _statsStartTick) * cycleCounter_perTick();
+    if (window == 0) return 0;
+
+    uint64_t permille = busyCycles * 1000u / window;
+    return (permille > 1000u) ? 1000u : (uint32_t)permille;
+}
+
+bool scheduler_getTaskStats(const scheduler_task_t* task, scheduler_task_stats_t* stats)
+{
+    if (!task || !task->isInUse || !stats) return false;
+
+    stats->name = task->name;
+    stats->periodTicks = task->periodTicks;
+    stats->priority = task->priority;
+    stats->runs = task->runs;
+    stats->overruns = task->overruns;
+    stats->lastCycles = task->lastCycles;
+    stats->maxCycles = task->maxCycles;
+    stats->maxJitterCycles = task->maxJitterCycles;
+    stats->loadPermille = _loadPermille(task->busyCycles);
+    return true;
+}
+
+uint32_t scheduler_getLoad(void)
+{
+    uint64_t busyCycles = 0;
+
+    for (uint8_t i = 0; i < _taskCount; i++)
+    {
+        busyCycles += _order[i]->busyCycles;
+    }
+    return _loadPermille(busyCycles);
+}
+
+void scheduler_resetStats(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (uint8_t i = 0; i < _taskCount; i++)
+    {
+        scheduler_task_t* task = _order[i];
+        task->runs = 0;
+        task->overruns = 0;
+        task->maxCycles = 0;
+        task->maxJitterCycles = 0;
+        task->busyCycles = 0;
+    }
+    _statsStartTick = _ticks;
+
+    __set_PRIMASK(primask);
+}
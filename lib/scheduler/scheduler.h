@@ -0,0 +1,58 @@
+/*************************************************************************
+ * scheduler.h
+ * Headerfile for scheduler.c
+ * Created on: 19-Oct-2026 09:00:00
+ * M. Schermutzki
+ * Cooperative fixed-rate scheduler. SysTick (1 kHz HAL tick) releases
+ * the periodic tasks, scheduler_run() executes released tasks to
+ * completion in priority order (0 = highest) and sleeps otherwise.
+ * Per task: runs, overruns (release while the previous one was still
+ * pending), execution time, release jitter and CPU share.
+ *************************************************************************/
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/*** includes ************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*** macros *************************************************************/
+#define C_SCHEDULER_TICK_HZ    (1000u)
+#define SCHEDULER_PERIOD_HZ(hz) (C_SCHEDULER_TICK_HZ / (hz))   // period in ticks for a rate
+
+/*** definitions ********************************************************/
+typedef struct scheduler_task_s scheduler_task_t;
+typedef void (*scheduler_task_cb_t)(void* context);
+
+typedef struct
+{
+    const char* name;
+    uint32_t periodTicks;
+    uint8_t priority;
+    uint32_t runs;
+    uint32_t overruns;          // releases dropped because the last one was still pending
+    uint32_t lastCycles;        // execution time of the last run
+    uint32_t maxCycles;
+    uint32_t maxJitterCycles;   // release -> start, worst case
+    uint32_t loadPermille;      // CPU share since scheduler_resetStats()
+} scheduler_task_stats_t;
+
+/*** functions ***********************************************************/
+void scheduler_init(void);
+scheduler_task_t* scheduler_newTask(const char* name, uint32_t periodTicks, uint8_t priority,
+                                    scheduler_task_cb_t cb, void* context);
+
+// SysTick context
+void scheduler_tick(void);
+
+// main context
+bool scheduler_runOnce(void);
+void scheduler_run(void);
+
+uint8_t scheduler_getTaskCount(void);
+scheduler_task_t* scheduler_getTask(uint8_t index);   // in priority order
+bool scheduler_getTaskStats(const scheduler_task_t* task, scheduler_task_stats_t* stats);
+uint32_t scheduler_getLoad(void);                     // all tasks, permille
+void scheduler_resetStats(void);
+
+#endif // SCHEDULER_H
@@ -0,0 +1,57 @@
+/***************************************************************************
+ * timebase.c
+ * Created on: 22-Oct-2026 09:00:00
+ * M. Schermutzki
+ ***************************************************************************/
+#if defined(HAL_NATIVE)
+#define _POSIX_C_SOURCE 200809L   // clock_gettime
+#endif
+
+/*** includes **************************************************************/
+#include <stdbool.h>
+
+#include "timebase.h"
+#include "stm32f2xx_hal.h"
+
+#if defined(HAL_NATIVE)
+#include <time.h>
+#endif
+
+/*** local variables ******************************************************/
+static bool _initialised = false;
+
+/*** functions ************************************************************/
+
+/***************************************************************************
+ * Start TIM2 (32 bit) as a free running 1 MHz counter. Its clock is PCLK1,
+ * doubled if the APB1 prescaler is not 1. Safe to call more than once.
+ **************************************************************************/ 
+void timebase_init(void)
+{
+    if (_initialised) return;
+    _initialised = true;
+
+#if !defined(HAL_NATIVE)
+    uint32_t timerClock = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) timerClock *= 2u;
+
+    __HAL_RCC_TIM2_CLK_ENABLE();
+    TIM2->CR1 = 0;
+    TIM2->PSC = timerClock / 1000000u - 1u;
+    TIM2->ARR = 0xFFFFFFFFu;
+    TIM2->CNT = 0;
+    TIM2->EGR = TIM_EGR_UG;   // load the prescaler now, not at the first overflow
+    TIM2->CR1 = TIM_CR1_CEN;
+#endif
+}
+
+uint32_t timebase_nowUs(void)
+{
+#if defined(HAL_NATIVE)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000u);
+#else
+    return TIM2->CNT;
+#endif
+}
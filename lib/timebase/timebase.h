@@ -0,0 +1,21 @@
+/*************************************************************************
+ * timebase.h
+ * Headerfile for timebase.c
+ * Created on: 22-Oct-2026 09:00:00
+ * M. Schermutzki
+ * Free running 32 bit microsecond clock for timestamps on the link (TIM2
+ * at 1 MHz on the target, CLOCK_MONOTONIC in the native build). Wraps
+ * after ~71.6 min, differences of two readings are valid across one wrap;
+ * the host unwraps (matlab/mcuToHostTime.m).
+ *************************************************************************/
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+/*** includes ************************************************************/
+#include <stdint.h>
+
+/*** functions ***********************************************************/
+void timebase_init(void);
+uint32_t timebase_nowUs(void);
+
+#endif // TIMEBASE_H
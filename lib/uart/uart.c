@@ -7,10 +7,16 @@
 #include <stdbool.h>
 #include <stddef.h>  
 #include "uart.h"
+#include "uart_dma_ring.h"
+#include "ring_buffer.h"
+#include "probe.h"
 #include "stm32f2xx_hal.h"
 
 /*** macros ***************************************************************/
 #define C_UART_MAX_INSTANCES  (6u)   
+#define C_UART_PORT_COUNT     (6u)   // UART_1 .. UART_6
+#define C_UART_DMA_RX_BUFFER_SIZE  (64u)
+#define C_UART_TX_TIMEOUT_SLACK_MS (10u)   // Reserve auf die reine Übertragungszeit
 
 /*** local constants ******************************************************/
 static bool _initialised = false;
@@ -27,64 +33,153 @@ struct uart_s
     uart_port_t port;
     handler_cb_with_context_t rxCallback;
     void* context;   // optionaler Kontext für den Callback
+
+    uart_rx_mode_t rxMode;
+    handler_span_cb_with_context_t rxSpanCallback;
+    void* spanContext;
+    DMA_HandleTypeDef _hdmaRx;
+    uart_dma_ring_t dmaRing;
+    uint8_t dmaRxBuffer[C_UART_DMA_RX_BUFFER_SIZE];
+
+    // asynchrones Senden
+    DMA_HandleTypeDef _hdmaTx;
+    bool txUseDma;
+    volatile bool txActive;
+    volatile size_t txChunk;   // Bytes, die gerade an die HAL übergeben sind
+    ring_buffer_t txRing;
+    uint8_t txStorage[C_UART_TX_RING_SIZE];
+    handler_tx_cb_with_context_t txCallback;
+    void* txContext;
+    uart_stats_t stats;
 };
 
+// feste Zuordnung eines Ports: Pins, IRQ und DMA-Streams (RM0033, Tabelle 22/23)
+typedef struct
+{
+    USART_TypeDef* instance;
+    IRQn_Type irq;
+    GPIO_TypeDef* txGpio;
+    uint16_t txPin;
+    GPIO_TypeDef* rxGpio;
+    uint16_t rxPin;
+    uint8_t alternate;
+
+    bool dma2;                        // false: DMA1, true: DMA2
+    DMA_Stream_TypeDef* rxStream;
+    IRQn_Type rxDmaIrq;
+    DMA_Stream_TypeDef* txStream;
+    IRQn_Type txDmaIrq;
+    uint32_t dmaChannel;
+} uart_port_config_t;
+
 /*** local variables *****************************************************/
 static uart_t _uartInstances[C_UART_MAX_INSTANCES];
 
+// Port -> Instanz, direkt indiziert (kein Suchen im Interrupt)
+static uart_t* _uartByPort[C_UART_PORT_COUNT];
+
+static const uart_port_config_t _uartPortConfig[C_UART_PORT_COUNT] =
+{
+    // USART1: PA9/PA10, RX DMA2 S2, TX DMA2 S7
+    [UART_1] = { USART1, USART1_IRQn, GPIOA, GPIO_PIN_9,  GPIOA, GPIO_PIN_10, GPIO_AF7_USART1,
+                 true,  DMA2_Stream2, DMA2_Stream2_IRQn, DMA2_Stream7, DMA2_Stream7_IRQn, DMA_CHANNEL_4 },
+    // USART2: PD5/PD6, RX DMA1 S5, TX DMA1 S6
+    [UART_2] = { USART2, USART2_IRQn, GPIOD, GPIO_PIN_5,  GPIOD, GPIO_PIN_6,  GPIO_AF7_USART2,
+                 false, DMA1_Stream5, DMA1_Stream5_IRQn, DMA1_Stream6, DMA1_Stream6_IRQn, DMA_CHANNEL_4 },
+    // USART3: PD8/PD9 (ST-LINK VCP auf dem Nucleo), RX DMA1 S1, TX DMA1 S3
+    [UART_3] = { USART3, USART3_IRQn, GPIOD, GPIO_PIN_8,  GPIOD, GPIO_PIN_9,  GPIO_AF7_USART3,
+                 false, DMA1_Stream1, DMA1_Stream1_IRQn, DMA1_Stream3, DMA1_Stream3_IRQn, DMA_CHANNEL_4 },
+    // UART4: PC10/PC11, RX DMA1 S2, TX DMA1 S4
+    [UART_4] = { UART4,  UART4_IRQn,  GPIOC, GPIO_PIN_10, GPIOC, GPIO_PIN_11, GPIO_AF8_UART4,
+                 false, DMA1_Stream2, DMA1_Stream2_IRQn, DMA1_Stream4, DMA1_Stream4_IRQn, DMA_CHANNEL_4 },
+    // UART5: PC12/PD2, RX DMA1 S0, TX DMA1 S7
+    [UART_5] = { UART5,  UART5_IRQn,  GPIOC, GPIO_PIN_12, GPIOD, GPIO_PIN_2,  GPIO_AF8_UART5,
+                 false, DMA1_Stream0, DMA1_Stream0_IRQn, DMA1_Stream7, DMA1_Stream7_IRQn, DMA_CHANNEL_4 },
+    // USART6: PG14/PG9, RX DMA2 S1, TX DMA2 S6 (S2/S7 gehören USART1)
+    [UART_6] = { USART6, USART6_IRQn, GPIOG, GPIO_PIN_14, GPIOG, GPIO_PIN_9,  GPIO_AF8_USART6,
+                 true,  DMA2_Stream1, DMA2_Stream1_IRQn, DMA2_Stream6, DMA2_Stream6_IRQn, DMA_CHANNEL_5 },
+};
+
 /*** prototypes **********************************************************/
+static void _init_uartClocks(uart_port_t port);
 static bool _init_uartPort(uart_t* uart, uart_port_t port, uint32_t baudRate);
+static bool _init_uartDmaStream(DMA_HandleTypeDef* hdma, uint32_t direction, uint32_t mode, IRQn_Type irq);
+static bool _init_uartDma(uart_t* uart);
+static bool _init_uartDmaTx(uart_t* uart);
+static void _uartTxStart(uart_t* uart);
+static uint32_t _uartTxTimeoutMs(const uart_t* uart, size_t bytes);
+static void _uartRxComplete(UART_HandleTypeDef *huart);
+static uart_t* _uartFromHandle(UART_HandleTypeDef *huart);
+static uart_t* _uartFromPort(uart_port_t port);
+static void _uartDeliverSpan(void* context, const uint8_t* data, size_t len);
+static void _uartDmaRxEvent(uart_t* uart);
+static void _uartIrq(uart_port_t port);
+static void _uartDmaRxIrq(uart_port_t port);
+static void _uartDmaTxIrq(uart_port_t port);
 
 /*** functions ***********************************************************/
 
 /*************************************************************************
- * Low-level Init eines Ports
+ * Takte für Peripherie und GPIO-Ports eines UARTs einschalten
  ************************************************************************/ 
-static bool _init_uartPort(uart_t* uart, uart_port_t port, uint32_t baudRate)
+static void _init_uartClocks(uart_port_t port)
 {
-    GPIO_InitTypeDef GPIO_InitStruct = {0};
-
     switch (port)
     {
         case UART_1:
             __HAL_RCC_USART1_CLK_ENABLE();
             __HAL_RCC_GPIOA_CLK_ENABLE();
-
-            GPIO_InitStruct.Pin       = GPIO_PIN_9;  // TX
-            GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;
-            GPIO_InitStruct.Pull      = GPIO_NOPULL;
-            GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
-            GPIO_InitStruct.Alternate = GPIO_AF7_USART1;
-            HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
-
-            GPIO_InitStruct.Pin       = GPIO_PIN_10; // RX
-            GPIO_InitStruct.Pull      = GPIO_PULLUP;
-            HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
-
-            uart->_huart.Instance = USART1;
             break;
-
+        case UART_2:
+            __HAL_RCC_USART2_CLK_ENABLE();
+            __HAL_RCC_GPIOD_CLK_ENABLE();
+            break;
+        case UART_3:
+            __HAL_RCC_USART3_CLK_ENABLE();
+            __HAL_RCC_GPIOD_CLK_ENABLE();
+            break;
         case UART_4:
             __HAL_RCC_UART4_CLK_ENABLE();
             __HAL_RCC_GPIOC_CLK_ENABLE();
+            break;
+        case UART_5:
+            __HAL_RCC_UART5_CLK_ENABLE();
+            __HAL_RCC_GPIOC_CLK_ENABLE();
+            __HAL_RCC_GPIOD_CLK_ENABLE();
+            break;
+        case UART_6:
+            __HAL_RCC_USART6_CLK_ENABLE();
+            __HAL_RCC_GPIOG_CLK_ENABLE();
+            break;
+    }
+}
 
-            GPIO_InitStruct.Pin       = GPIO_PIN_10; // TX
-            GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;
-            GPIO_InitStruct.Pull      = GPIO_NOPULL;
-            GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
-            GPIO_InitStruct.Alternate = GPIO_AF8_UART4;
-            HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
+/*************************************************************************
+ * Low-level Init eines Ports
+ ************************************************************************/ 
+static bool _init_uartPort(uart_t* uart, uart_port_t port, uint32_t baudRate)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
 
-            GPIO_InitStruct.Pin       = GPIO_PIN_11; // RX
-            GPIO_InitStruct.Pull      = GPIO_PULLUP;
-            HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
+    if ((unsigned)port >= C_UART_PORT_COUNT)
+        return false; // ungültiger Port
 
-            uart->_huart.Instance = UART4;
-            break;
+    const uart_port_config_t* config = &_uartPortConfig[port];
 
-        default:
-            return false; // ungültiger Port
-    }
+    _init_uartClocks(port);
+
+    GPIO_InitStruct.Pin       = config->txPin;  // TX
+    GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull      = GPIO_NOPULL;
+    GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
+    GPIO_InitStruct.Alternate = config->alternate;
+    HAL_GPIO_Init(config->txGpio, &GPIO_InitStruct);
+
+    GPIO_InitStruct.Pin       = config->rxPin;  // RX
+    GPIO_InitStruct.Pull      = GPIO_PULLUP;
+    HAL_GPIO_Init(config->rxGpio, &GPIO_InitStruct);
+
+    uart->_huart.Instance = config->instance;
 
     uart->_huart.Init.BaudRate     = baudRate;
     uart->_huart.Init.WordLength   = UART_WORDLENGTH_8B;
@@ -98,19 +193,8 @@ static bool _init_uartPort(uart_t* uart, uart_port_t port, uint32_t baudRate)
         return false;
 
     // NVIC aktivieren
-    switch (port)
-    {
-        case UART_1:
-            HAL_NVIC_SetPriority(USART1_IRQn, 0, 0);
-            HAL_NVIC_EnableIRQ(USART1_IRQn);
-            break;
-        case UART_4:
-            HAL_NVIC_SetPriority(UART4_IRQn, 0, 0);
-            HAL_NVIC_EnableIRQ(UART4_IRQn);
-            break;
-        default:
-            return false;
-    }
+    HAL_NVIC_SetPriority(config->irq, 0, 0);
+    HAL_NVIC_EnableIRQ(config->irq);
 
     // ersten RX-Interrupt starten
     HAL_UART_Receive_IT(&uart->_huart, &uart->rxByte, 1);
@@ -119,38 +203,342 @@ static bool _init_uartPort(uart_t* uart, uart_port_t port, uint32_t baudRate)
 }
 
 /*************************************************************************
- * HAL Callback, wenn ein Byte empfangen wurde
+ * Gemeinsame Konfiguration eines DMA-Streams (Instance/Channel gesetzt)
+ ************************************************************************/ 
+static bool _init_uartDmaStream(DMA_HandleTypeDef* hdma, uint32_t direction, uint32_t mode, IRQn_Type irq)
+{
+    hdma->Init.Direction           = direction;
+    hdma->Init.PeriphInc           = DMA_PINC_DISABLE;
+    hdma->Init.MemInc              = DMA_MINC_ENABLE;
+    hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma->Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    hdma->Init.Mode                = mode;
+    hdma->Init.Priority            = DMA_PRIORITY_HIGH;
+    hdma->Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+    if (HAL_DMA_Init(hdma) != HAL_OK)
+        return false;
+
+    HAL_NVIC_SetPriority(irq, 0, 0);
+    HAL_NVIC_EnableIRQ(irq);
+
+    return true;
+}
+
+/*************************************************************************
+ * RX-DMA eines Ports konfigurieren (zirkulär, Peripherie -> Speicher)
  ************************************************************************/ 
+static bool _init_uartDma(uart_t* uart)
+{
+    DMA_HandleTypeDef* hdma = &uart->_hdmaRx;
+    const uart_port_config_t* config = &_uartPortConfig[uart->port];
+
+    if (config->dma2) __HAL_RCC_DMA2_CLK_ENABLE();
+    else              __HAL_RCC_DMA1_CLK_ENABLE();
+
+    hdma->Instance     = config->rxStream;
+    hdma->Init.Channel = config->dmaChannel;
+
+    if (!_init_uartDmaStream(hdma, DMA_PERIPH_TO_MEMORY, DMA_CIRCULAR, config->rxDmaIrq))
+        return false;
+
+    __HAL_LINKDMA(&uart->_huart, hdmarx, uart->_hdmaRx);
+    return true;
+}
+
+/*************************************************************************
+ * TX-DMA eines Ports konfigurieren (Speicher -> Peripherie)
+ * false: Fallback auf Interrupt-Betrieb
+ ************************************************************************/ 
+static bool _init_uartDmaTx(uart_t* uart)
+{
+    DMA_HandleTypeDef* hdma = &uart->_hdmaTx;
+    const uart_port_config_t* config = &_uartPortConfig[uart->port];
+
+    if (config->dma2) __HAL_RCC_DMA2_CLK_ENABLE();
+    else              __HAL_RCC_DMA1_CLK_ENABLE();
+
+    hdma->Instance     = config->txStream;
+    hdma->Init.Channel = config->dmaChannel;
+
+    if (!_init_uartDmaStream(hdma, DMA_MEMORY_TO_PERIPH, DMA_NORMAL, config->txDmaIrq))
+        return false;
+
+    __HAL_LINKDMA(&uart->_huart, hdmatx, uart->_hdmaTx);
+    return true;
+}
+
+/*************************************************************************
+ * Instanz zu HAL-Handle bzw. Port, O(1): das Handle liegt in der Instanz,
+ * der Port indiziert _uartByPort
+ ************************************************************************/ 
+static uart_t* _uartFromHandle(UART_HandleTypeDef *huart)
+{
+    uart_t* uart = (uart_t*)((uint8_t*)huart - offsetof(uart_t, _huart));
+
+    // Handles, die nicht aus dem Pool stammen, ignorieren
+    if (uart < &_uartInstances[0] || uart >= &_uartInstances[C_UART_MAX_INSTANCES]) return NULL;
+    if (!uart->isInUse) return NULL;
+
+    return uart;
+}
+
+static uart_t* _uartFromPort(uart_port_t port)
+{
+    if ((unsigned)port >= C_UART_PORT_COUNT) return NULL;
+    return _uartByPort[port];
+}
+
+/*************************************************************************
+ * Empfangenen Block an den Span-Callback geben, sonst byteweise an den
+ * klassischen Callback (Kompatibilitätspfad)
+ ************************************************************************/ 
+static void _uartDeliverSpan(void* context, const uint8_t* data, size_t len)
+{
+    uart_t* uart = (uart_t*)context;
+
+    if (uart->rxSpanCallback)
+    {
+        uart->rxSpanCallback(uart->spanContext, data, len);
+    }
+    else if (uart->rxCallback)
+    {
+        for (size_t i = 0; i < len; i++)
+            uart->rxCallback(uart->context, data[i]);
+    }
+}
+
+/*************************************************************************
+ * DMA-Ereignis (Half-/Full-Transfer oder IDLE): neue Bytes ausliefern
+ ************************************************************************/ 
+static void _uartDmaRxEvent(uart_t* uart)
+{
+    size_t remaining = __HAL_DMA_GET_COUNTER(uart->_huart.hdmarx);
+    uartDmaRing_process(&uart->dmaRing, remaining, _uartDeliverSpan, uart);
+}
+
+/*************************************************************************
+ * HAL Callback, wenn ein Byte empfangen wurde bzw. der DMA-Puffer voll ist
+ ************************************************************************/ 
+static void _uartRxComplete(UART_HandleTypeDef *huart)
+{
+    uart_t* uart = _uartFromHandle(huart);
+    if (!uart) return;
+
+    if (uart->rxMode == UART_RX_MODE_DMA)
+    {
+        _uartDmaRxEvent(uart);
+        return;
+    }
+
+    // User-Callback aufrufen, falls vorhanden
+    _uartDeliverSpan(uart, &uart->rxByte, 1);
+
+    // neuen RX-Interrupt starten
+    HAL_UART_Receive_IT(&uart->_huart, &uart->rxByte, 1);
+}
+
 void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 {
-    for (uint8_t i = 0; i < C_UART_MAX_INSTANCES; i++)
+    PROBE_START(E_PROBE_UART_RX_CPLT);
+    _uartRxComplete(huart);
+    PROBE_STOP(E_PROBE_UART_RX_CPLT);
+}
+
+/*************************************************************************
+ * HAL Callback, DMA-Puffer halb voll
+ ************************************************************************/ 
+void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef *huart)
+{
+    uart_t* uart = _uartFromHandle(huart);
+    if (!uart || uart->rxMode != UART_RX_MODE_DMA) return;
+
+    _uartDmaRxEvent(uart);
+}
+
+/*************************************************************************
+ * HAL Callback bei Empfangsfehlern (ORE/NE/FE/PE): zählen und den Empfang
+ * sofort neu starten. Bei ORE und im DMA-Betrieb bricht die HAL den
+ * Empfang ab, sonst läuft er weiter (Byte wurde trotzdem ausgeliefert).
+ ************************************************************************/ 
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    uart_t* uart = _uartFromHandle(huart);
+    if (!uart) return;
+
+    uint32_t error = HAL_UART_GetError(huart);
+    if (error & HAL_UART_ERROR_ORE) uart->stats.rxOverrun++;
+    if (error & HAL_UART_ERROR_NE)  uart->stats.rxNoise++;
+    if (error & HAL_UART_ERROR_FE)  uart->stats.rxFraming++;
+    if (error & HAL_UART_ERROR_PE)  uart->stats.rxParity++;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+
+    if (huart->RxState != HAL_UART_STATE_READY) return;
+
+    uart->stats.rxRestarts++;
+
+    if (uart->rxMode == UART_RX_MODE_DMA)
+    {
+        // bis zum Abbruch empfangene Bytes noch ausliefern, dann von vorn
+        _uartDmaRxEvent(uart);
+        uartDmaRing_init(&uart->dmaRing, uart->dmaRxBuffer, sizeof(uart->dmaRxBuffer));
+
+        if (HAL_UART_Receive_DMA(&uart->_huart, uart->dmaRxBuffer, sizeof(uart->dmaRxBuffer)) == HAL_OK)
+            return;
+
+        // DMA lässt sich nicht neu starten -> Interrupt-Betrieb
+        __HAL_UART_DISABLE_IT(&uart->_huart, UART_IT_IDLE);
+        uart->rxMode = UART_RX_MODE_IT;
+    }
+
+    HAL_UART_Receive_IT(&uart->_huart, &uart->rxByte, 1);
+}
+
+/*************************************************************************
+ * Nächsten zusammenhängenden Block aus dem TX-Ring starten
+ * (aus dem TX-Interrupt oder mit gesperrten Interrupts aufrufen)
+ ************************************************************************/ 
+static void _uartTxStart(uart_t* uart)
+{
+    const uint8_t* data;
+    size_t len = ringBuffer_peekContiguous(&uart->txRing, &data);
+
+    if (len == 0)
     {
-        uart_t* uart = &_uartInstances[i];
+        uart->txActive = false;
+        return;
+    }
 
-        if (!uart->isInUse) continue;
-        if (&uart->_huart != huart) continue;
+    HAL_StatusTypeDef status;
+    uart->txChunk = len;
+    uart->txActive = true;
 
-        // User-Callback aufrufen, falls vorhanden
-        if (uart->rxCallback)
-            uart->rxCallback(uart->context, uart->rxByte);
+    if (uart->txUseDma) status = HAL_UART_Transmit_DMA(&uart->_huart, data, (uint16_t)len);
+    else                status = HAL_UART_Transmit_IT(&uart->_huart, data, (uint16_t)len);
 
-        // neuen RX-Interrupt starten
-        HAL_UART_Receive_IT(&uart->_huart, &uart->rxByte, 1);
-        break;
+    if (status != HAL_OK)
+    {
+        uart->txChunk = 0;
+        uart->txActive = false;
     }
 }
 
 /*************************************************************************
- * Daten senden
+ * HAL Callback, Block gesendet
  ************************************************************************/ 
-void uart_sendByte(uart_t* uart, uint8_t data)
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
 {
-    HAL_UART_Transmit(&uart->_huart, &data, 1, HAL_MAX_DELAY);
+    uart_t* uart = _uartFromHandle(huart);
+    if (!uart) return;
+
+    ringBuffer_advance(&uart->txRing, uart->txChunk);
+    uart->txChunk = 0;
+    _uartTxStart(uart);
+
+    if (!uart->txActive && uart->txCallback)
+        uart->txCallback(uart->txContext);
 }
 
-void uart_sendBuffer(uart_t* uart, const uint8_t *buffer, size_t len)
+/*************************************************************************
+ * Zeit für bytes bei der aktuellen Baudrate (8N1 = 10 Bit) plus Reserve
+ ************************************************************************/ 
+static uint32_t _uartTxTimeoutMs(const uart_t* uart, size_t bytes)
 {
-    HAL_UART_Transmit(&uart->_huart, buffer, len, HAL_MAX_DELAY);
+    return (uint32_t)((bytes * 10u * 1000u) / uart->baudRate) + 1u + C_UART_TX_TIMEOUT_SLACK_MS;
+}
+
+/*************************************************************************
+ * Daten senden (blockierend), nur aus dem Hauptkontext: der TX-Ring wird
+ * nur vom TC-Interrupt geleert. In einer ISR oder mit gesperrten
+ * Interrupts käme der nie, dann sofort UART_TX_BUSY statt zu hängen.
+ * Sonst ist die Wartezeit begrenzt (voller Ring bzw. len Bytes).
+ ************************************************************************/ 
+uart_tx_status_t uart_sendByte(uart_t* uart, uint8_t data)
+{
+    return uart_sendBuffer(uart, &data, 1);
+}
+
+uart_tx_status_t uart_sendBuffer(uart_t* uart, const uint8_t *buffer, size_t len)
+{
+    if (!uart || !uart->isInUse || (!buffer && len > 0) || len > UINT16_MAX) return UART_TX_INVALID;
+    if (len == 0) return UART_TX_OK;
+
+    // laufende asynchrone Übertragung zuerst abschließen (Reihenfolge)
+    if (uart->txActive)
+    {
+        if (__get_IPSR() != 0u || __get_PRIMASK() != 0u) return UART_TX_BUSY;
+
+        uint32_t start = HAL_GetTick();
+        uint32_t timeout = _uartTxTimeoutMs(uart, C_UART_TX_RING_SIZE);
+        while (uart->txActive)
+        {
+            if ((HAL_GetTick() - start) >= timeout) return UART_TX_TIMEOUT;
+        }
+    }
+
+    switch (HAL_UART_Transmit(&uart->_huart, buffer, (uint16_t)len, _uartTxTimeoutMs(uart, len)))
+    {
+        case HAL_OK:      return UART_TX_OK;
+        case HAL_TIMEOUT: return UART_TX_TIMEOUT;
+        default:          return UART_TX_BUSY;
+    }
+}
+
+/*************************************************************************
+ * Daten senden (nicht blockierend): nur Kopie in den TX-Ring
+ ************************************************************************/ 
+uart_tx_status_t uart_sendBufferAsync(uart_t* uart, const uint8_t *buffer, size_t len)
+{
+    if (!uart || !uart->isInUse || (!buffer && len > 0)) return UART_TX_INVALID;
+    if (len == 0) return UART_TX_OK;
+
+    // nur vollständige Blöcke einreihen, halbe Frames nützen keinem Parser
+    if (!ringBuffer_write(&uart->txRing, buffer, len))
+    {
+        uart->stats.txQueueFull++;
+        uart->stats.txBytesDropped += len;
+        return UART_TX_QUEUE_FULL;
+    }
+
+    uart->stats.txBytesQueued += len;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (!uart->txActive) _uartTxStart(uart);
+    __set_PRIMASK(primask);
+
+    return UART_TX_OK;
+}
+
+bool uart_isTxIdle(uart_t* uart)
+{
+    if (!uart) return true;
+    return !uart->txActive;
+}
+
+/*************************************************************************
+ * Freier Platz im TX-Ring, z.B. um große Datenmengen ohne verworfene
+ * Blöcke nachzuschieben
+ ************************************************************************/ 
+size_t uart_getTxFree(uart_t* uart)
+{
+    if (!uart || !uart->isInUse) return 0;
+    return ringBuffer_free(&uart->txRing);
+}
+
+void uart_registerTxCallback(uart_t* uart, handler_tx_cb_with_context_t cb, void* context)
+{
+    uart->txCallback = cb;
+    uart->txContext = context;
+}
+
+/*************************************************************************
+ * Statistik abfragen
+ ************************************************************************/ 
+void uart_getStats(uart_t* uart, uart_stats_t* stats)
+{
+    if (!uart || !stats) return;
+    *stats = uart->stats;
 }
 
 /*************************************************************************
@@ -162,43 +550,172 @@ void uart_registerRxCallback(uart_t* uart, handler_cb_with_context_t cb, void* c
     uart->context = context;
 }
 
+void uart_registerRxSpanCallback(uart_t* uart, handler_span_cb_with_context_t cb, void* context)
+{
+    uart->rxSpanCallback = cb;
+    uart->spanContext = context;
+}
+
 /*************************************************************************
- * IRQ Handler für alle Ports dynamisch
+ * Empfangsmodus umschalten
  ************************************************************************/ 
-void USART1_IRQHandler(void)
+bool uart_setRxMode(uart_t* uart, uart_rx_mode_t mode)
 {
-    for (uint8_t i = 0; i < C_UART_MAX_INSTANCES; i++)
+    if (!uart || !uart->isInUse) return false;
+    if (uart->rxMode == mode) return true;
+
+    if (mode == UART_RX_MODE_DMA)
     {
-        uart_t* uart = &_uartInstances[i];
+        if (!_init_uartDma(uart)) return false;
 
-        if (!uart->isInUse) continue;
-        if (uart->port != UART_1) continue;
+        HAL_UART_AbortReceive(&uart->_huart);
+        uartDmaRing_init(&uart->dmaRing, uart->dmaRxBuffer, sizeof(uart->dmaRxBuffer));
+        uart->rxMode = UART_RX_MODE_DMA;
 
-        HAL_UART_IRQHandler(&uart->_huart);
-        break;
+        if (HAL_UART_Receive_DMA(&uart->_huart, uart->dmaRxBuffer, sizeof(uart->dmaRxBuffer)) != HAL_OK)
+        {
+            uart->rxMode = UART_RX_MODE_IT;
+            HAL_UART_Receive_IT(&uart->_huart, &uart->rxByte, 1);
+            return false;
+        }
+
+        __HAL_UART_CLEAR_IDLEFLAG(&uart->_huart);
+        __HAL_UART_ENABLE_IT(&uart->_huart, UART_IT_IDLE);
+    }
+    else
+    {
+        __HAL_UART_DISABLE_IT(&uart->_huart, UART_IT_IDLE);
+        HAL_UART_DMAStop(&uart->_huart);
+        uart->rxMode = UART_RX_MODE_IT;
+        HAL_UART_Receive_IT(&uart->_huart, &uart->rxByte, 1);
     }
+
+    return true;
 }
 
-void UART4_IRQHandler(void)
+/*************************************************************************
+ * Baudrate prüfen: Oversampling 16 -> max. PCLK/16, BRR-Mantisse 12 Bit
+ ************************************************************************/ 
+bool uart_isBaudRateSupported(uart_t* uart, uint32_t baudRate)
 {
-    for (uint8_t i = 0; i < C_UART_MAX_INSTANCES; i++)
+    if (!uart || !uart->isInUse || baudRate == 0) return false;
+
+    uint32_t pclk = (uart->port == UART_1 || uart->port == UART_6) ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+
+    return baudRate <= pclk / 16u && baudRate >= pclk / (16u * 4096u);
+}
+
+/*************************************************************************
+ * Baudrate umschalten: Empfang stoppen, Peripherie neu konfigurieren,
+ * Empfang im bisherigen Modus wieder starten
+ ************************************************************************/ 
+bool uart_setBaudRate(uart_t* uart, uint32_t baudRate)
+{
+    if (!uart || !uart->isInUse) return false;
+    if (!uart_isBaudRateSupported(uart, baudRate)) return false;
+    if (baudRate == uart->baudRate) return true;
+
+    // Bytes in der Warteschlange würden sonst mit der neuen Rate gesendet
+    if (uart->txActive) return false;
+
+    uart_rx_mode_t mode = uart->rxMode;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (mode == UART_RX_MODE_DMA) uart_setRxMode(uart, UART_RX_MODE_IT);
+
+    HAL_UART_AbortReceive(&uart->_huart);
+    uart->_huart.Init.BaudRate = baudRate;
+
+    bool success = (HAL_UART_Init(&uart->_huart) == HAL_OK);
+    if (success)
+    {
+        uart->baudRate = baudRate;
+    }
+    else
     {
-        uart_t* uart = &_uartInstances[i];
+        // alte Rate wiederherstellen
+        uart->_huart.Init.BaudRate = uart->baudRate;
+        HAL_UART_Init(&uart->_huart);
+    }
+
+    HAL_UART_Receive_IT(&uart->_huart, &uart->rxByte, 1);
+    if (mode == UART_RX_MODE_DMA) uart_setRxMode(uart, UART_RX_MODE_DMA);
+
+    __set_PRIMASK(primask);
+    return success;
+}
 
-        if (!uart->isInUse) continue;
-        if (uart->port != UART_4) continue;
+uint32_t uart_getBaudRate(uart_t* uart)
+{
+    if (!uart || !uart->isInUse) return 0;
+    return uart->baudRate;
+}
+
+/*************************************************************************
+ * IRQ Handler für alle Ports dynamisch
+ ************************************************************************/ 
+static void _uartIrq(uart_port_t port)
+{
+    uart_t* uart = _uartFromPort(port);
+    if (!uart) return;
 
-        HAL_UART_IRQHandler(&uart->_huart);
-        break;
+    // Leitung ruhig -> angefangenen DMA-Block sofort ausliefern
+    if (uart->rxMode == UART_RX_MODE_DMA && __HAL_UART_GET_FLAG(&uart->_huart, UART_FLAG_IDLE))
+    {
+        __HAL_UART_CLEAR_IDLEFLAG(&uart->_huart);
+        _uartDmaRxEvent(uart);
     }
+
+    HAL_UART_IRQHandler(&uart->_huart);
 }
 
+/*************************************************************************
+ * DMA-Stream-Interrupts an das Handle des zugeordneten Ports
+ ************************************************************************/ 
+static void _uartDmaRxIrq(uart_port_t port)
+{
+    uart_t* uart = _uartFromPort(port);
+    if (uart) HAL_DMA_IRQHandler(&uart->_hdmaRx);
+}
+
+static void _uartDmaTxIrq(uart_port_t port)
+{
+    uart_t* uart = _uartFromPort(port);
+    if (uart) HAL_DMA_IRQHandler(&uart->_hdmaTx);
+}
+
+void USART1_IRQHandler(void) { _uartIrq(UART_1); }
+void USART2_IRQHandler(void) { _uartIrq(UART_2); }
+void USART3_IRQHandler(void) { _uartIrq(UART_3); }
+void UART4_IRQHandler(void)  { _uartIrq(UART_4); }
+void UART5_IRQHandler(void)  { _uartIrq(UART_5); }
+void USART6_IRQHandler(void) { _uartIrq(UART_6); }
+
+// RX-Streams
+void DMA2_Stream2_IRQHandler(void) { _uartDmaRxIrq(UART_1); }
+void DMA1_Stream5_IRQHandler(void) { _uartDmaRxIrq(UART_2); }
+void DMA1_Stream1_IRQHandler(void) { _uartDmaRxIrq(UART_3); }
+void DMA1_Stream2_IRQHandler(void) { _uartDmaRxIrq(UART_4); }
+void DMA1_Stream0_IRQHandler(void) { _uartDmaRxIrq(UART_5); }
+void DMA2_Stream1_IRQHandler(void) { _uartDmaRxIrq(UART_6); }
+
+// TX-Streams
+void DMA2_Stream7_IRQHandler(void) { _uartDmaTxIrq(UART_1); }
+void DMA1_Stream6_IRQHandler(void) { _uartDmaTxIrq(UART_2); }
+void DMA1_Stream3_IRQHandler(void) { _uartDmaTxIrq(UART_3); }
+void DMA1_Stream4_IRQHandler(void) { _uartDmaTxIrq(UART_4); }
+void DMA1_Stream7_IRQHandler(void) { _uartDmaTxIrq(UART_5); }
+void DMA2_Stream6_IRQHandler(void) { _uartDmaTxIrq(UART_6); }
+
 /*************************************************************************
  * UART initialisieren
  ************************************************************************/ 
 uart_t* uart_new(uart_port_t port, uint32_t baudRate)
 {
     if (!_initialised) return NULL;
+    if ((unsigned)port >= C_UART_PORT_COUNT) return NULL;
+    if (_uartByPort[port] != NULL) return NULL;  // Port bereits vergeben
 
     for (uint8_t i = 0; i < C_UART_MAX_INSTANCES; i++) 
     {
@@ -212,14 +729,30 @@ uart_t* uart_new(uart_port_t port, uint32_t baudRate)
             uart->rxByte = 0;
             uart->rxCallback = NULL;
             uart->context = NULL;
-
-            uart->isInUse = _init_uartPort(uart, port, baudRate);
-            if (!uart->isInUse)
+            uart->rxMode = UART_RX_MODE_IT;
+            uart->rxSpanCallback = NULL;
+            uart->spanContext = NULL;
+            uart->txActive = false;
+            uart->txChunk = 0;
+            uart->txCallback = NULL;
+            uart->txContext = NULL;
+            uart->stats = (uart_stats_t){0};
+            ringBuffer_init(&uart->txRing, uart->txStorage, sizeof(uart->txStorage));
+
+            // vor dem Freischalten des Interrupts eintragen: der erste
+            // RX-Interrupt kann schon während _init_uartPort kommen
+            uart->isInUse = true;
+            _uartByPort[port] = uart;
+
+            if (!_init_uartPort(uart, port, baudRate))
             {
+                _uartByPort[port] = NULL;
                 *uart = (uart_t){0};
                 return NULL;
             }
 
+            uart->txUseDma = _init_uartDmaTx(uart);
+
             return uart;
         }
     }
@@ -235,6 +768,10 @@ void uart_init(void)
         {
             _uartInstances[i].isInUse = false;
         }
+        for (uint8_t i = 0; i < C_UART_PORT_COUNT; i++)
+        {
+            _uartByPort[i] = NULL;
+        }
         _initialised = true;
     }
 }
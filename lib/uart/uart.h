@@ -11,6 +11,12 @@
 /*** includes ************************************************************/
 #include <stdint.h>
 #include <stddef.h>  // für size_t
+#include <stdbool.h>
+
+/*** macros **************************************************************/
+// TX-Ring pro Port, Zweierpotenz; ein Block muss am Stück hineinpassen
+// (größter Frame: Probe-Statistik im ASCII-Format, 588 Bytes)
+#define C_UART_TX_RING_SIZE  (1024u)
 
 /*** definitions ********************************************************/
 typedef struct uart_s uart_t;
@@ -18,6 +24,12 @@ typedef struct uart_s uart_t;
 // Callback-Typ mit optionalem Kontext
 typedef void (*handler_cb_with_context_t)(void* context, uint8_t byte);
 
+// Callback-Typ für zusammenhängende Byte-Blöcke (DMA-Empfang)
+typedef void (*handler_span_cb_with_context_t)(void* context, const uint8_t* data, size_t len);
+
+// Callback-Typ, wenn die TX-Warteschlange leer gelaufen ist
+typedef void (*handler_tx_cb_with_context_t)(void* context);
+
 typedef enum
 {
     UART_1,
@@ -28,12 +40,59 @@ typedef enum
     UART_6
 } uart_port_t;
 
+typedef enum
+{
+    UART_RX_MODE_IT,    // ein Interrupt pro Byte
+    UART_RX_MODE_DMA    // zirkulärer DMA-Puffer + IDLE-Erkennung
+} uart_rx_mode_t;
+
+typedef enum
+{
+    UART_TX_OK,
+    UART_TX_QUEUE_FULL,  // Block verworfen (Gegendruck)
+    UART_TX_INVALID,
+    UART_TX_BUSY,        // blockierend: aus ISR/mit gesperrten Interrupts bei laufender Übertragung
+    UART_TX_TIMEOUT      // blockierend: Übertragung nicht in der erwarteten Zeit fertig
+} uart_tx_status_t;
+
+typedef struct
+{
+    uint32_t txBytesQueued;
+    uint32_t txBytesDropped;
+    uint32_t txQueueFull;
+
+    // Empfangsfehler der Hardware (HAL_UART_ErrorCallback)
+    uint32_t rxOverrun;     // ORE: Byte verloren, RX-Interrupt kam zu spät
+    uint32_t rxNoise;       // NE
+    uint32_t rxFraming;     // FE: Störung oder falsche Baudrate
+    uint32_t rxParity;      // PE
+    uint32_t rxRestarts;    // Empfang nach Abbruch durch die HAL neu gestartet
+} uart_stats_t;
+
 /*** functions ***********************************************************/
-void uart_sendBuffer(uart_t* uart, const uint8_t *buffer, size_t len);
-void uart_sendByte(uart_t* uart, uint8_t data);
+// blockierend, nur Hauptkontext; Wartezeit aus Baudrate und Länge begrenzt
+uart_tx_status_t uart_sendBuffer(uart_t* uart, const uint8_t *buffer, size_t len);
+uart_tx_status_t uart_sendByte(uart_t* uart, uint8_t data);
+
+// nicht blockierend: Block wird in den TX-Ring kopiert und per DMA/IT gesendet
+uart_tx_status_t uart_sendBufferAsync(uart_t* uart, const uint8_t *buffer, size_t len);
+bool uart_isTxIdle(uart_t* uart);
+size_t uart_getTxFree(uart_t* uart);   // freier Platz im TX-Ring (Bytes)
+void uart_registerTxCallback(uart_t* uart, handler_tx_cb_with_context_t cb, void* context);
+void uart_getStats(uart_t* uart, uart_stats_t* stats);   // TX-Warteschlange und RX-Fehler
 
 // Callback mit Kontext registrieren
 void uart_registerRxCallback(uart_t* uart, handler_cb_with_context_t cb, void* context);
+void uart_registerRxSpanCallback(uart_t* uart, handler_span_cb_with_context_t cb, void* context);
+
+// Empfangsmodus umschalten (Standard: UART_RX_MODE_IT)
+bool uart_setRxMode(uart_t* uart, uart_rx_mode_t mode);
+
+// Baudrate zur Laufzeit ändern; nur bei leerer TX-Warteschlange, der
+// Empfangsmodus bleibt erhalten. Grenze: PCLK/16 (APB2: USART1/6, sonst APB1)
+bool uart_isBaudRateSupported(uart_t* uart, uint32_t baudRate);
+bool uart_setBaudRate(uart_t* uart, uint32_t baudRate);
+uint32_t uart_getBaudRate(uart_t* uart);
 
 uart_t* uart_new(uart_port_t port, uint32_t baudRate);
 void uart_init(void);
@@ -0,0 +1,58 @@
+/**************************************************************************
+ * uart_dma_ring.c
+ * Created on: 17-Oct-2026 09:00:00
+ * M. Schermutzki
+ **************************************************************************/
+
+/*** includes *************************************************************/
+#include "uart_dma_ring.h"
+
+/*** functions ***********************************************************/
+
+/*************************************************************************
+ * Ring auf einen (DMA-)Puffer setzen
+ ************************************************************************/ 
+void uartDmaRing_init(uart_dma_ring_t* ring, uint8_t* buffer, size_t size)
+{
+    if (!ring) return;
+
+    ring->buffer = buffer;
+    ring->size = size;
+    ring->readPos = 0;
+}
+
+/*************************************************************************
+ * Neue Bytes seit dem letzten Aufruf als max. zwei Blöcke ausliefern.
+ * remaining = DMA-Zähler (NDTR), d.h. Schreibposition = size - remaining.
+ * Rückgabe: Anzahl ausgelieferter Bytes
+ ************************************************************************/ 
+size_t uartDmaRing_process(uart_dma_ring_t* ring, size_t remaining, handler_span_cb_with_context_t cb, void* context)
+{
+    if (!ring || !ring->buffer || ring->size == 0 || remaining > ring->size) return 0;
+
+    size_t writePos = ring->size - remaining;
+    size_t delivered = 0;
+
+    // NDTR == size direkt nach dem Reload entspricht Position 0
+    if (writePos == ring->size) writePos = 0;
+    if (writePos == ring->readPos) return 0;
+
+    if (writePos < ring->readPos)
+    {
+        // Umlauf: erst bis Pufferende, dann ab Anfang
+        size_t len = ring->size - ring->readPos;
+        if (cb) cb(context, &ring->buffer[ring->readPos], len);
+        delivered += len;
+        ring->readPos = 0;
+    }
+
+    if (writePos > ring->readPos)
+    {
+        size_t len = writePos - ring->readPos;
+        if (cb) cb(context, &ring->buffer[ring->readPos], len);
+        delivered += len;
+        ring->readPos = writePos;
+    }
+
+    return delivered;
+}
@@ -0,0 +1,31 @@
+/*************************************************************************
+ * uart_dma_ring.h
+ * Headerfile for uart_dma_ring.c
+ * Created on: 17-Oct-2026 09:00:00
+ * M. Schermutzki
+ * This module keeps track of the read position inside a circular DMA
+ * receive buffer. It has no HAL dependency: the caller passes the DMA
+ * "remaining transfers" counter (NDTR), so the bookkeeping can be
+ * compiled and checked on a host.
+ *************************************************************************/
+#ifndef UART_DMA_RING_H
+#define UART_DMA_RING_H
+
+/*** includes ************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "uart.h"
+
+/*** definitions ********************************************************/
+typedef struct
+{
+    uint8_t* buffer;
+    size_t size;
+    size_t readPos;
+} uart_dma_ring_t;
+
+/*** functions ***********************************************************/
+void uartDmaRing_init(uart_dma_ring_t* ring, uint8_t* buffer, size_t size);
+size_t uartDmaRing_process(uart_dma_ring_t* ring, size_t remaining, handler_span_cb_with_context_t cb, void* context);
+
+#endif // UART_DMA_RING_H
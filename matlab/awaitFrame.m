@@ -0,0 +1,43 @@
+function [values, ok, frame, age] = awaitFrame(s, name, accept)
+    % Auf eine Antwort der Firmware warten (ASCII-Protokoll), IMU-Frames und
+    % andere Nachrichten dazwischen werden uebersprungen
+    % s:      offener serialport, Timeout je Frame setzt der Aufrufer
+    % name:   erwartete Nachricht aus matlabProtocol.m, z.B. "REC_STATUS";
+    %         bei einer Anfrage ohne Antwort im Schema (PROBE_STATS, variable
+    %         Laenge) deren Name -> values = rohe Felder nach dem cmd-Feld
+    % accept: optional @(values) -> false verwirft eine Antwort, z.B. eine
+    %         alte mit falschem t1 (syncMcuClock.m)
+    % values: Feldwerte wie bei protocolDecode, leer wenn keine Antwort kam
+    % frame:  empfangenes Frame (ohne ETX), age: Sekunden seit dessen Empfang
+    if nargin < 3, accept = @(values) true; end
+
+    p = matlabProtocol();
+    m = p.msg.(name);
+    configureTerminator(s, p.ETX);
+    values = [];
+    ok = false;
+    age = 0;
+
+    for attempt = 1:10
+        frame = uint8(char(readline(s)));
+        received = tic;
+        if isempty(frame)
+            return;   % Timeout
+        end
+
+        [decoded, fields, valid, raw] = protocolDecode(frame);
+        if m.toHost
+            match = valid && decoded == name;
+        else
+            match = ~isempty(raw) && raw(1) == m.id;
+            if match
+                fields = raw(2:end);
+            end
+        end
+
+        if match && accept(fields)
+            [values, ok, age] = deal(fields, true, toc(received));
+            return;
+        end
+    end
+end
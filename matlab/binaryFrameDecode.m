@@ -0,0 +1,29 @@
+function [cmd, payload, ok] = binaryFrameDecode(frame)
+    % Gegenstueck zu binaryFrameEncode; frame mit oder ohne 0x00-Trenner
+    cmd = uint8(0);
+    payload = zeros(1, 0, 'uint8');
+    ok = false;
+
+    frame = uint8(frame(:).');
+    if ~isempty(frame) && frame(end) == 0
+        frame = frame(1:end - 1);
+    end
+
+    try
+        raw = cobsDecode(frame);
+    catch
+        return;
+    end
+    if length(raw) < 3
+        return;
+    end
+
+    crcRx = uint16(raw(end - 1)) + bitshift(uint16(raw(end)), 8);
+    if crcRx ~= crc16Ccitt(raw(1:end - 2))
+        return;
+    end
+
+    cmd = raw(1);
+    payload = raw(2:end - 2);
+    ok = true;
+end
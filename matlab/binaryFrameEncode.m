@@ -0,0 +1,10 @@
+function frame = binaryFrameEncode(cmd, payload)
+    % Binaerframe: COBS( cmd | payload | crc16 (little endian) ) 0x00
+    % payload bereits als uint8-Bytes in little endian, z.B.
+    % typecast(int32(wert), 'uint8') auf einem little-endian Host
+    raw = [uint8(cmd), uint8(payload(:).')];
+    crc = crc16Ccitt(raw);
+
+    raw = [raw, uint8(bitand(crc, 255)), uint8(bitshift(crc, -8))];
+    frame = [cobsEncode(raw), uint8(0)];
+end
@@ -0,0 +1,22 @@
+function out = cobsDecode(data)
+    % COBS-Dekodierung wie cobs.c (Eingabe ohne 0x00-Trenner)
+    data = uint8(data(:).');
+    out = zeros(1, 0, 'uint8');
+
+    i = 1;
+    n = length(data);
+    while i <= n
+        code = double(data(i));
+        if code == 0 || i + code - 1 > n
+            error('cobsDecode:invalid', 'Ungueltiger COBS-Block an Position %d', i);
+        end
+
+        out = [out, data(i + 1 : i + code - 1)]; %#ok<AGROW>
+        i = i + code;
+
+        % implizite Null, ausser nach vollem Block und am Ende
+        if code ~= 255 && i <= n
+            out(end + 1) = 0; %#ok<AGROW>
+        end
+    end
+end
@@ -0,0 +1,27 @@
+function out = cobsEncode(data)
+    % COBS-Kodierung wie cobs.c (ohne abschliessendes 0x00)
+    data = uint8(data(:).');
+    out = zeros(1, length(data) + floor(length(data) / 254) + 1, 'uint8');
+
+    codeIdx = 1;
+    outIdx  = 2;
+    code    = uint8(1);
+
+    for i = 1:length(data)
+        if data(i) ~= 0
+            out(outIdx) = data(i);
+            outIdx = outIdx + 1;
+            code = code + 1;
+        end
+
+        if data(i) == 0 || code == 255
+            out(codeIdx) = code;
+            codeIdx = outIdx;
+            outIdx = outIdx + 1;
+            code = uint8(1);
+        end
+    end
+
+    out(codeIdx) = code;
+    out = out(1:outIdx - 1);
+end
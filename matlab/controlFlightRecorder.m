@@ -0,0 +1,32 @@
+function status = controlFlightRecorder(s, action, postTrigger, triggerEvents)
+    % Flugdatenschreiber im SRAM des Controllers steuern (ASCII-Protokoll, CMD 0x0B)
+    % s:             offener serialport
+    % action:        "status" (Standard), "arm", "trigger" oder "stop"
+    % postTrigger:   "arm": Datensaetze nach dem Trigger (Standard 500 = 1 s)
+    % triggerEvents: "arm": Ereignisse, die selbst ausloesen (Bits wie
+    %                flight_recorder.h, z.B. 2 = CRC-Fehler), 0 = nur per Befehl
+    % status:        struct mit state (0 idle, 1 armed, 2 triggered, 3 stopped),
+    %                recordSize, capacity, count, triggerIndex (ab 0, 2^32-1 =
+    %                keiner), sequence (leer, wenn keine Antwort kam)
+    % Auslesen: readFlightRecorder.m
+    if nargin < 2, action = "status"; end
+    if nargin < 3, postTrigger = 500; end
+    if nargin < 4, triggerEvents = 0; end
+
+    actions = ["status", "arm", "trigger", "stop"];
+    code = find(actions == action, 1) - 1;
+    if isempty(code)
+        error('controlFlightRecorder: unbekannte Aktion %s', action);
+    end
+
+    p = matlabProtocol();
+    write(s, protocolEncode("REC_CONTROL", [code, postTrigger, triggerEvents]), "uint8");
+
+    status = struct([]);
+    [values, ok] = awaitFrame(s, "REC_STATUS");
+    if ok
+        status = cell2struct(num2cell(values(:)), p.msg.REC_STATUS.names(:), 1);
+    else
+        disp('controlFlightRecorder: keine Antwort');
+    end
+end
@@ -0,0 +1,18 @@
+function crc = crc16Ccitt(data)
+    % CRC16-CCITT (Polynom 0x1021, Startwert 0xFFFF) wie crc16.c
+    % bitweise berechnet, liefert dieselben Werte wie die Tabelle in C
+    crc = uint16(hex2dec('FFFF'));
+    poly = uint16(hex2dec('1021'));
+
+    data = uint8(data(:).');
+    for i = 1:length(data)
+        crc = bitxor(crc, bitshift(uint16(data(i)), 8));
+        for b = 1:8
+            if bitand(crc, uint16(hex2dec('8000')))
+                crc = bitxor(bitshift(crc, 1), poly);
+            else
+                crc = bitshift(crc, 1);
+            end
+        end
+    end
+end
@@ -0,0 +1,200 @@
+function p = matlabProtocol()
+    % GENERIERT aus lib/matlab_communication/matlab_protocol.h durch
+    % tools/gen_matlab_protocol.py (jeder pio-Build) - nicht von Hand aendern
+    % p.msg.<NAME>: id, sub ([] = ohne), toMcu/toHost, asciiCmd (false: ASCII-Frame
+    % ohne cmd-Feld), je Feld names/types/classes/bytes/scales
+    % (Wert auf der Leitung = round(Wert * scale))
+    p.STX = uint8(2);
+    p.US = uint8(31);
+    p.ETX = uint8(3);
+    p.SEQ_FLAG = 64;
+
+    p.msg.MOTOR_VALUES = struct('id', 1, 'sub', [], 'toMcu', true, 'toHost', false, 'asciiCmd', true, ...
+        'names', {{'motor1', 'motor2', 'motor3', 'motor4'}}, ...
+        'types', {{'U8', 'U8', 'U8', 'U8'}}, ...
+        'classes', {{'uint8', 'uint8', 'uint8', 'uint8'}}, ...
+        'bytes', [1 1 1 1], ...
+        'scales', [1 1 1 1]);
+
+    p.msg.ROLL_PITCH_GAINS = struct('id', 2, 'sub', 4, 'toMcu', true, 'toHost', false, 'asciiCmd', true, ...
+        'names', {{'pPitch_Roll', 'iPitch_Roll', 'dPitch_Roll'}}, ...
+        'types', {{'Q16_16', 'Q16_16', 'Q16_16'}}, ...
+        'classes', {{'int32', 'int32', 'int32'}}, ...
+        'bytes', [4 4 4], ...
+        'scales', [10 10 10]);
+
+    p.msg.YAW_GAINS = struct('id', 2, 'sub', 6, 'toMcu', true, 'toHost', false, 'asciiCmd', true, ...
+        'names', {{'pYaw', 'iYaw', 'dYaw'}}, ...
+        'types', {{'Q16_16', 'Q16_16', 'Q16_16'}}, ...
+        'classes', {{'int32', 'int32', 'int32'}}, ...
+        'bytes', [4 4 4], ...
+        'scales', [10 10 10]);
+
+    p.msg.TARGET_ANGLES = struct('id', 2, 'sub', 7, 'toMcu', true, 'toHost', false, 'asciiCmd', true, ...
+        'names', {{'targetAngleRoll', 'targetAnglePitch', 'targetAngleYaw'}}, ...
+        'types', {{'Q16_16', 'Q16_16', 'Q16_16'}}, ...
+        'classes', {{'int32', 'int32', 'int32'}}, ...
+        'bytes', [4 4 4], ...
+        'scales', [1 1 1]);
+
+    p.msg.PID_ANGLE_VALUES = struct('id', 2, 'sub', 8, 'toMcu', true, 'toHost', false, 'asciiCmd', true, ...
+        'names', {{'pPitch_Roll', 'iPitch_Roll', 'dPitch_Roll', 'pYaw', 'iYaw', 'dYaw', 'targetAngleRoll', 'targetAnglePitch', 'targetAngleYaw'}}, ...
+        'types', {{'Q16_16', 'Q16_16', 'Q16_16', 'Q16_16', 'Q16_16', 'Q16_16', 'Q16_16', 'Q16_16', 'Q16_16'}}, ...
+        'classes', {{'int32', 'int32', 'int32', 'int32', 'int32', 'int32', 'int32', 'int32', 'int32'}}, ...
+        'bytes', [4 4 4 4 4 4 4 4 4], ...
+        'scales', [10 10 10 10 10 10 1 1 1]);
+
+    p.msg.FRAME_FORMAT = struct('id', 3, 'sub', [], 'toMcu', true, 'toHost', true, 'asciiCmd', true, ...
+        'names', {{'frameFormat'}}, ...
+        'types', {{'U8'}}, ...
+        'classes', {{'uint8'}}, ...
+        'bytes', [1], ...
+        'scales', [1]);
+
+    p.msg.PROBE_STATS = struct('id', 4, 'sub', [], 'toMcu', true, 'toHost', false, 'asciiCmd', true, ...
+        'names', {{'resetStats'}}, ...
+        'types', {{'U8'}}, ...
+        'classes', {{'uint8'}}, ...
+        'bytes', [1], ...
+        'scales', [1]);
+
+    p.msg.PID_ANGLE_READ = struct('id', 5, 'sub', [], 'toMcu', true, 'toHost', false, 'asciiCmd', true, ...
+        'names', {{}}, ...
+        'types', {{}}, ...
+        'classes', {{}}, ...
+        'bytes', [], ...
+        'scales', []);
+
+    p.msg.PID_ANGLE_READ_BACK = struct('id', 5, 'sub', [], 'toMcu', false, 'toHost', true, 'asciiCmd', true, ...
+        'names', {{'pPitch_Roll', 'iPitch_Roll', 'dPitch_Roll', 'pYaw', 'iYaw', 'dYaw', 'targetAngleRoll', 'targetAnglePitch', 'targetAngleYaw'}}, ...
+        'types', {{'Q16_16', 'Q16_16', 'Q16_16', 'Q16_16', 'Q16_16', 'Q16_16', 'Q16_16', 'Q16_16', 'Q16_16'}}, ...
+        'classes', {{'int32', 'int32', 'int32', 'int32', 'int32', 'int32', 'int32', 'int32', 'int32'}}, ...
+        'bytes', [4 4 4 4 4 4 4 4 4], ...
+        'scales', [10 10 10 10 10 10 1 1 1]);
+
+    p.msg.ACK = struct('id', 6, 'sub', [], 'toMcu', false, 'toHost', true, 'asciiCmd', true, ...
+        'names', {{'sequence', 'error'}}, ...
+        'types', {{'U8', 'U8'}}, ...
+        'classes', {{'uint8', 'uint8'}}, ...
+        'bytes', [1 1], ...
+        'scales', [1 1]);
+
+    p.msg.BAUD_RATE = struct('id', 7, 'sub', [], 'toMcu', true, 'toHost', false, 'asciiCmd', true, ...
+        'names', {{'baudRate'}}, ...
+        'types', {{'U32'}}, ...
+        'classes', {{'uint32'}}, ...
+        'bytes', [4], ...
+        'scales', [1]);
+
+    p.msg.BAUD_RATE_ANSWER = struct('id', 7, 'sub', [], 'toMcu', false, 'toHost', true, 'asciiCmd', true, ...
+        'names', {{'baudRate', 'accepted'}}, ...
+        'types', {{'U32', 'U8'}}, ...
+        'classes', {{'uint32', 'uint8'}}, ...
+        'bytes', [4 1], ...
+        'scales', [1 1]);
+
+    p.msg.LINK_STATS = struct('id', 8, 'sub', [], 'toMcu', true, 'toHost', false, 'asciiCmd', true, ...
+        'names', {{'resetStats'}}, ...
+        'types', {{'U8'}}, ...
+        'classes', {{'uint8'}}, ...
+        'bytes', [1], ...
+        'scales', [1]);
+
+    p.msg.LINK_STATS_ANSWER = struct('id', 8, 'sub', [], 'toMcu', false, 'toHost', true, 'asciiCmd', true, ...
+        'names', {{'framesOk', 'crcErrors', 'invalidSigns', 'unknownCommands', 'resyncs', 'bytesDiscarded', 'badLength'}}, ...
+        'types', {{'U32', 'U32', 'U32', 'U32', 'U32', 'U32', 'U32'}}, ...
+        'classes', {{'uint32', 'uint32', 'uint32', 'uint32', 'uint32', 'uint32', 'uint32'}}, ...
+        'bytes', [4 4 4 4 4 4 4], ...
+        'scales', [1 1 1 1 1 1 1]);
+
+    p.msg.TIME_SYNC = struct('id', 9, 'sub', [], 'toMcu', true, 'toHost', false, 'asciiCmd', true, ...
+        'names', {{'hostSend'}}, ...
+        'types', {{'U32'}}, ...
+        'classes', {{'uint32'}}, ...
+        'bytes', [4], ...
+        'scales', [1]);
+
+    p.msg.TIME_SYNC_ANSWER = struct('id', 9, 'sub', [], 'toMcu', false, 'toHost', true, 'asciiCmd', true, ...
+        'names', {{'hostSend', 'mcuReceive', 'mcuSend'}}, ...
+        'types', {{'U32', 'U32', 'U32'}}, ...
+        'classes', {{'uint32', 'uint32', 'uint32'}}, ...
+        'bytes', [4 4 4], ...
+        'scales', [1 1 1]);
+
+    p.msg.PING_0 = struct('id', 10, 'sub', 0, 'toMcu', true, 'toHost', false, 'asciiCmd', true, ...
+        'names', {{'tag'}}, ...
+        'types', {{'U32'}}, ...
+        'classes', {{'uint32'}}, ...
+        'bytes', [4], ...
+        'scales', [1]);
+
+    p.msg.PING_4 = struct('id', 10, 'sub', 4, 'toMcu', true, 'toHost', false, 'asciiCmd', true, ...
+        'names', {{'tag', 'payload0', 'payload1', 'payload2', 'payload3'}}, ...
+        'types', {{'U32', 'U32', 'U32', 'U32', 'U32'}}, ...
+        'classes', {{'uint32', 'uint32', 'uint32', 'uint32', 'uint32'}}, ...
+        'bytes', [4 4 4 4 4], ...
+        'scales', [1 1 1 1 1]);
+
+    p.msg.PING_8 = struct('id', 10, 'sub', 8, 'toMcu', true, 'toHost', false, 'asciiCmd', true, ...
+        'names', {{'tag', 'payload0', 'payload1', 'payload2', 'payload3', 'payload4', 'payload5', 'payload6', 'payload7'}}, ...
+        'types', {{'U32', 'U32', 'U32', 'U32', 'U32', 'U32', 'U32', 'U32', 'U32'}}, ...
+        'classes', {{'uint32', 'uint32', 'uint32', 'uint32', 'uint32', 'uint32', 'uint32', 'uint32', 'uint32'}}, ...
+        'bytes', [4 4 4 4 4 4 4 4 4], ...
+        'scales', [1 1 1 1 1 1 1 1 1]);
+
+    p.msg.PING_ANSWER_0 = struct('id', 10, 'sub', [], 'toMcu', false, 'toHost', true, 'asciiCmd', true, ...
+        'names', {{'tag', 'isrUs', 'queuedUs'}}, ...
+        'types', {{'U32', 'U32', 'U32'}}, ...
+        'classes', {{'uint32', 'uint32', 'uint32'}}, ...
+        'bytes', [4 4 4], ...
+        'scales', [1 1 1]);
+
+    p.msg.PING_ANSWER_4 = struct('id', 10, 'sub', [], 'toMcu', false, 'toHost', true, 'asciiCmd', true, ...
+        'names', {{'tag', 'isrUs', 'queuedUs', 'payload0', 'payload1', 'payload2', 'payload3'}}, ...
+        'types', {{'U32', 'U32', 'U32', 'U32', 'U32', 'U32', 'U32'}}, ...
+        'classes', {{'uint32', 'uint32', 'uint32', 'uint32', 'uint32', 'uint32', 'uint32'}}, ...
+        'bytes', [4 4 4 4 4 4 4], ...
+        'scales', [1 1 1 1 1 1 1]);
+
+    p.msg.PING_ANSWER_8 = struct('id', 10, 'sub', [], 'toMcu', false, 'toHost', true, 'asciiCmd', true, ...
+        'names', {{'tag', 'isrUs', 'queuedUs', 'payload0', 'payload1', 'payload2', 'payload3', 'payload4', 'payload5', 'payload6', 'payload7'}}, ...
+        'types', {{'U32', 'U32', 'U32', 'U32', 'U32', 'U32', 'U32', 'U32', 'U32', 'U32', 'U32'}}, ...
+        'classes', {{'uint32', 'uint32', 'uint32', 'uint32', 'uint32', 'uint32', 'uint32', 'uint32', 'uint32', 'uint32', 'uint32'}}, ...
+        'bytes', [4 4 4 4 4 4 4 4 4 4 4], ...
+        'scales', [1 1 1 1 1 1 1 1 1 1 1]);
+
+    p.msg.REC_CONTROL = struct('id', 11, 'sub', [], 'toMcu', true, 'toHost', false, 'asciiCmd', true, ...
+        'names', {{'action', 'postTrigger', 'triggerEvents'}}, ...
+        'types', {{'U8', 'U32', 'U8'}}, ...
+        'classes', {{'uint8', 'uint32', 'uint8'}}, ...
+        'bytes', [1 4 1], ...
+        'scales', [1 1 1]);
+
+    p.msg.REC_STATUS = struct('id', 11, 'sub', [], 'toMcu', false, 'toHost', true, 'asciiCmd', true, ...
+        'names', {{'state', 'recordSize', 'capacity', 'count', 'triggerIndex', 'sequence'}}, ...
+        'types', {{'U8', 'U8', 'U32', 'U32', 'U32', 'U32'}}, ...
+        'classes', {{'uint8', 'uint8', 'uint32', 'uint32', 'uint32', 'uint32'}}, ...
+        'bytes', [1 1 4 4 4 4], ...
+        'scales', [1 1 1 1 1 1]);
+
+    p.msg.REC_DUMP = struct('id', 12, 'sub', [], 'toMcu', true, 'toHost', false, 'asciiCmd', true, ...
+        'names', {{'first', 'count'}}, ...
+        'types', {{'U32', 'U32'}}, ...
+        'classes', {{'uint32', 'uint32'}}, ...
+        'bytes', [4 4], ...
+        'scales', [1 1]);
+
+    p.msg.NACK = struct('id', 21, 'sub', [], 'toMcu', false, 'toHost', true, 'asciiCmd', true, ...
+        'names', {{'sequence', 'error'}}, ...
+        'types', {{'U8', 'U8'}}, ...
+        'classes', {{'uint8', 'uint8'}}, ...
+        'bytes', [1 1], ...
+        'scales', [1 1]);
+
+    p.msg.IMU_DATA = struct('id', 129, 'sub', [], 'toMcu', false, 'toHost', true, 'asciiCmd', false, ...
+        'names', {{'timestampUs', 'x', 'y', 'z'}}, ...
+        'types', {{'U32', 'I16', 'I16', 'I16'}}, ...
+        'classes', {{'uint32', 'int16', 'int16', 'int16'}}, ...
+        'bytes', [4 2 2 2], ...
+        'scales', [1 1 1 1]);
+end
@@ -0,0 +1,18 @@
+function tHost = mcuToHostTime(sync, tMcu)
+    % Zeitstempel des Controllers (us, z.B. aus IMU_DATA) in Host-Zeit umrechnen
+    % sync:  Ergebnis von syncMcuClock.m
+    % tMcu:  ein oder mehrere Zeitstempel (uint32 von der Leitung)
+    % tHost: Sekunden seit sync.hostRef, vergleichbar mit toc(sync.hostRef)
+    %        und damit mit den Sendezeiten eigener Kommandos
+    % Der 32-Bit-Zaehler laeuft nach ~71,6 min ueber; entfaltet wird um die
+    % letzte Synchronisation herum (+-35 min), fuer lange Laeufe
+    % syncMcuClock(s, n, sync) regelmaessig wiederholen (auch wegen der Drift).
+    if isempty(sync.samples)
+        error('mcuToHostTime: sync ohne Messungen');
+    end
+
+    tMcu = double(tMcu);
+    ref = sync.samples(end, 4);
+    unwrapped = tMcu + 2^32 * round((ref - tMcu) / 2^32);
+    tHost = (unwrapped - sync.mcuAt0) / sync.rate;
+end
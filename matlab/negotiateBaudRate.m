@@ -0,0 +1,38 @@
+function ok = negotiateBaudRate(s, baudRate)
+    % Baudrate mit der Firmware aushandeln (ASCII-Protokoll, BAUD_RATE)
+    % s:        offener serialport (mit der aktuellen Rate, nach Reset 57600)
+    % baudRate: gewuenschte Rate, z.B. 460800; die Firmware nimmt hoechstens
+    %           460800 an (C_MATLABCOM_MAX_BAUD): der RX-Ring (512 Byte) wird
+    %           nur jede ms geleert und muss 10 ms ohne Abholen ueberbruecken.
+    %           Hoehere Raten (UART4 koennte bis 1875000) werden abgelehnt.
+    % Ablauf: Anfrage mit alter Rate, Bestaetigung abwarten, umschalten und
+    % innerhalb von 500 ms ein gueltiges Frame senden (hier: PID_ANGLE_READ),
+    % sonst schaltet die Firmware auf die alte Rate zurueck.
+    oldRate = s.BaudRate;
+
+    s.Timeout = 0.3;
+    write(s, protocolEncode("BAUD_RATE", baudRate), "uint8");
+
+    [answer, ok] = awaitFrame(s, "BAUD_RATE_ANSWER");
+    if ~ok || answer(1) ~= baudRate || answer(2) ~= 1
+        ok = false;
+        disp('negotiateBaudRate: Rate abgelehnt oder keine Antwort');
+        return;
+    end
+
+    % Bestaetigung ist raus -> Firmware schaltet jetzt um
+    pause(0.02);
+    s.BaudRate = baudRate;
+    flush(s);
+
+    write(s, protocolEncode("PID_ANGLE_READ"), "uint8");
+
+    [~, ok] = awaitFrame(s, "PID_ANGLE_READ_BACK");
+    if ~ok
+        % Firmware faellt nach dem Timeout selbst zurueck
+        pause(0.6);
+        s.BaudRate = oldRate;
+        flush(s);
+        disp('negotiateBaudRate: keine Verbindung mit neuer Rate, zurueck auf alte Rate');
+    end
+end
@@ -0,0 +1,83 @@
+function [name, values, ok, fields] = protocolDecode(frame, format)
+    % Empfangenes Frame mit matlabProtocol.m zerlegen (Gegenstueck zu
+    % protocolEncode, Richtung Controller -> Host)
+    % frame:  ASCII STX ... [ETX] bzw. Binaerframe (mit oder ohne 0x00)
+    % format: "ascii" (Standard) oder "binary"
+    % name:   Nachricht, z.B. "IMU_DATA", "ACK", "" wenn unbekannt
+    % values: Feldwerte in der Reihenfolge von p.msg.(name).names, Gains und
+    %         Winkel physikalisch
+    % fields: ASCII: alle Felder eines gueltigen Frames inkl. cmd, auch wenn
+    %         die Nachricht nicht im Schema steht (Probe-Statistik, variable
+    %         Laenge: readProbeStats.m), sonst leer
+    if nargin < 2, format = "ascii"; end
+
+    p = matlabProtocol();
+    name = "";
+    values = [];
+    ok = false;
+    fields = [];
+
+    if format == "binary"
+        [cmd, payload, valid] = binaryFrameDecode(frame);
+        if ~valid
+            return;
+        end
+        for n = string(fieldnames(p.msg)).'
+            m = p.msg.(n);
+            if m.toHost && m.id == cmd && sum(m.bytes) == numel(payload)
+                offset = cumsum([0, m.bytes]);
+                wire = zeros(1, numel(m.bytes));
+                for i = 1:numel(m.bytes)
+                    wire(i) = double(typecast(payload(offset(i) + 1:offset(i + 1)), m.classes{i}));
+                end
+                [name, values, ok] = deal(n, wire ./ m.scales, true);
+                return;
+            end
+        end
+        return;
+    end
+
+    % ETX darf fehlen (readline mit configureTerminator(s, p.ETX))
+    frame = uint8(frame(:).');
+    start = find(frame == p.STX, 1, 'last');
+    stop = find(frame == p.ETX, 1, 'last');
+    if isempty(stop)
+        stop = numel(frame) + 1;
+    end
+    if isempty(start) || stop < start
+        return;
+    end
+    body = frame(start + 1:stop - 1);
+    seps = find(body == p.US);
+    if isempty(seps) || crc16Ccitt(body(1:seps(end))) ~= hex2dec(char(body(seps(end) + 1:end)))
+        return;
+    end
+    fields = signedDec(split(string(char(body(1:seps(end) - 1))), char(p.US)).');
+
+    % zuerst Nachrichten mit cmd-Feld, dann die ohne (IMU)
+    for withCmd = [true, false]
+        for n = string(fieldnames(p.msg)).'
+            m = p.msg.(n);
+            if ~m.toHost || m.asciiCmd ~= withCmd
+                continue;
+            end
+            wire = fields(1 + withCmd:end);
+            if (~withCmd || fields(1) == m.id) && numel(wire) == numel(m.names)
+                [name, values, ok] = deal(n, wire ./ m.scales, true);
+                return;
+            end
+        end
+    end
+end
+
+%% Hilfsfunktion: ASCII-Hex mit optionalem '-' als Zahl
+function vals = signedDec(parts)
+    vals = zeros(1, numel(parts));
+    for i = 1:numel(parts)
+        if startsWith(parts(i), "-")
+            vals(i) = -hex2dec(extractAfter(parts(i), 1));
+        else
+            vals(i) = hex2dec(parts(i));
+        end
+    end
+end
@@ -0,0 +1,50 @@
+function frame = protocolEncode(name, values, format, seq)
+    % Frame fuer eine Nachricht aus matlabProtocol.m bauen
+    % name:   Nachricht, z.B. "MOTOR_VALUES", "PID_ANGLE_VALUES", "BAUD_RATE"
+    % values: Feldwerte in der Reihenfolge von p.msg.(name).names, Gains und
+    %         Winkel physikalisch (Skalierung macht protocolEncode)
+    % format: "ascii" (Standard) oder "binary"
+    % seq:    optionale Sequenznummer 0..255, Antwort ACK 0x06 / NACK 0x15
+    % z.B. write(s, protocolEncode("MOTOR_VALUES", [10 20 30 40]), "uint8");
+    if nargin < 2, values = []; end
+    if nargin < 3, format = "ascii"; end
+    if nargin < 4, seq = []; end
+
+    p = matlabProtocol();
+    m = p.msg.(name);
+    if ~m.toMcu || numel(values) ~= numel(m.names)
+        error('protocolEncode: %s erwartet %d Werte', name, numel(m.names));
+    end
+
+    cmd = m.id;
+    header = [];
+    if ~isempty(seq)
+        cmd = bitor(cmd, p.SEQ_FLAG);
+        header = seq;
+    end
+    header = [header, m.sub];
+    wire = round(double(values(:).') .* m.scales);
+
+    if format == "binary"
+        payload = uint8(header);
+        for i = 1:numel(wire)
+            payload = [payload, typecast(cast(wire(i), m.classes{i}), 'uint8')]; %#ok<AGROW>
+        end
+        frame = binaryFrameEncode(cmd, payload);
+    else
+        body = uint8([]);
+        for v = [cmd, header, wire]
+            body = [body, signedHex(v), p.US]; %#ok<AGROW>
+        end
+        frame = [p.STX, body, uint8(dec2hex(crc16Ccitt(body), 4)), p.ETX];
+    end
+end
+
+%% Hilfsfunktion: vorzeichenbehafteter Wert als ASCII-Hex ('-' + Betrag)
+function asciiHex = signedHex(val)
+    if val < 0
+        asciiHex = uint8(['-', dec2hex(-val)]);
+    else
+        asciiHex = uint8(dec2hex(val));
+    end
+end
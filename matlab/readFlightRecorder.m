@@ -0,0 +1,68 @@
+function rec = readFlightRecorder(s, first, count)
+    % Flugdatenschreiber auslesen (CMD 0x0C), haelt die Aufzeichnung an
+    % s:     offener serialport
+    % first: erster Datensatz (0 = aeltester, Standard 0)
+    % count: Anzahl (Standard: alle)
+    % rec:   struct mit je einer Zeile pro Datensatz:
+    %        timestampUs (Controller-Zeit, mcuToHostTime.m), sequence, events,
+    %        mode, imu [x y z], motor [1..4], pid [rollP rollI rollD pitchP ...
+    %        yawD] (Q8.8 -> double), triggerIndex (Zeile des Triggers, [] = keiner)
+    % Die Datensaetze kommen binaer in Bloecken, egal welches Frame-Format
+    % eingestellt ist: 0x00 | COBS(0x0C | index | Datensaetze | crc) | 0x00,
+    % ein Block ohne Datensaetze beendet die Uebertragung. Aufbau eines
+    % Datensatzes (36 Byte) wie flight_record_t in flight_recorder.h.
+    if nargin < 2, first = 0; end
+    if nargin < 3, count = 2^32 - 1; end
+
+    RECORD_SIZE = 36;
+    CMD_DUMP = 12;
+
+    flush(s);
+    write(s, protocolEncode("REC_DUMP", [first, count]), "uint8");
+
+    % Bloecke sammeln bis zum leeren Block (IMU-Frames und ACKs dazwischen
+    % fallen bei COBS/crc/cmd heraus)
+    s.Timeout = 1;
+    raw = zeros(0, RECORD_SIZE, 'uint8');
+    index = zeros(0, 1);
+    pending = zeros(1, 0, 'uint8');
+    done = false;
+    while ~done
+        data = read(s, max(s.NumBytesAvailable, 1), "uint8");
+        if isempty(data)
+            error('readFlightRecorder: Uebertragung abgebrochen');
+        end
+        pending = [pending, uint8(data)]; %#ok<AGROW>
+
+        ends = find(pending == 0);
+        starts = [0, ends(1:end - 1)];
+        for k = 1:numel(ends)
+            [cmd, payload, ok] = binaryFrameDecode(pending(starts(k) + 1:ends(k) - 1));
+            if ~ok || cmd ~= CMD_DUMP || numel(payload) < 4 || mod(numel(payload) - 4, RECORD_SIZE) ~= 0
+                continue;
+            end
+            n = (numel(payload) - 4) / RECORD_SIZE;
+            if n == 0
+                done = true;
+                break;
+            end
+            index(end + 1:end + n, 1) = double(typecast(payload(1:4), 'uint32')) + (0:n - 1).';
+            raw(end + 1:end + n, :) = reshape(payload(5:end), RECORD_SIZE, n).';
+        end
+        if ~isempty(ends)
+            pending = pending(ends(end) + 1:end);
+        end
+    end
+    [~, order] = sort(index);
+    raw = raw(order, :);
+
+    field = @(bytes, class) reshape(typecast(reshape(raw(:, bytes).', 1, []), class), [], size(raw, 1)).';
+    rec.timestampUs = double(field(1:4, 'uint32'));
+    rec.sequence    = double(field(5:6, 'uint16'));
+    rec.events      = double(raw(:, 7));
+    rec.mode        = double(raw(:, 8));
+    rec.imu         = double(field(9:14, 'int16'));
+    rec.motor       = double(raw(:, 15:18));
+    rec.pid         = double(field(19:36, 'int16')) / 256;
+    rec.triggerIndex = find(bitand(rec.events, 128), 1);
+end
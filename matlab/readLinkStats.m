@@ -0,0 +1,21 @@
+function stats = readLinkStats(s, reset)
+    % Zaehler der Verbindung abfragen (ASCII-Protokoll, CMD 0x08)
+    % s:     offener serialport
+    % reset: true -> Zaehler nach dem Auslesen auf dem Controller loeschen
+    % stats: struct mit framesOk, crcErrors, invalidSigns, unknownCommands,
+    %        resyncs, bytesDiscarded, badLength (leer, wenn keine Antwort kam)
+    if nargin < 2
+        reset = false;
+    end
+
+    p = matlabProtocol();
+    write(s, protocolEncode("LINK_STATS", double(reset)), "uint8");
+
+    stats = struct([]);
+    [values, ok] = awaitFrame(s, "LINK_STATS_ANSWER");
+    if ok
+        stats = cell2struct(num2cell(values(:)), p.msg.LINK_STATS_ANSWER.names(:), 1);
+    else
+        disp('readLinkStats: keine Antwort');
+    end
+end
@@ -0,0 +1,39 @@
+function stats = readProbeStats(s, reset)
+    % Probe-Statistik der Firmware abfragen (ASCII-Protokoll, PROBE_STATS)
+    % s:     offener serialport
+    % reset: true -> Statistik nach dem Auslesen auf dem Controller loeschen
+    % Zeiten in CPU-Zyklen (DWT), Firmware mit C_PROBE_ENABLE=1 bauen
+    if nargin < 2
+        reset = false;
+    end
+
+    names = ["uart_rx_cplt", "parser_byte", "data_callback", "send_imu"];
+
+    write(s, protocolEncode("PROBE_STATS", double(reset)), "uint8");
+
+    % Antwort mit variabler Laenge, nicht im Schema -> rohe Felder
+    [fields, ok] = awaitFrame(s, "PROBE_STATS");
+    if ~ok
+        error('readProbeStats: keine Antwort');
+    end
+    fields = fields.';
+
+    % Aufbau: Anzahl, je Probe count | min | max | mean | 12 Histogramm-Buckets
+    probeCount = fields(1);
+    perProbe = 16;
+    stats = struct('name', {}, 'count', {}, 'min', {}, 'max', {}, 'mean', {}, 'histogram', {});
+    for i = 1:probeCount
+        f = fields(1 + (i - 1) * perProbe + (1:perProbe));
+        stats(i).name = names(min(i, numel(names)));
+        stats(i).count = f(1);
+        stats(i).min = f(2);
+        stats(i).max = f(3);
+        stats(i).mean = f(4);
+        stats(i).histogram = f(5:end).';
+        fprintf('%-14s n=%-8d min=%-6d mean=%-6d max=%-6d\n', stats(i).name, ...
+                stats(i).count, stats(i).min, stats(i).mean, stats(i).max);
+    end
+    if probeCount == 0
+        disp('Firmware ohne C_PROBE_ENABLE gebaut');
+    end
+end
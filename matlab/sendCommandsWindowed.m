@@ -0,0 +1,105 @@
+function results = sendCommandsWindowed(s, commands, windowSize, timeout, maxRetries)
+    % Mehrere Kommandos ohne Stop-and-Wait senden (ASCII-Protokoll mit
+    % Sequenznummer, Antwort ACK 0x06 / NACK 0x15 je Frame)
+    % s:          offener serialport
+    % commands:   Cell-Array, je Kommando {Name, Werte} mit Namen aus
+    %             matlabProtocol.m und Werten wie bei protocolEncode, z.B.
+    %             {{"MOTOR_VALUES", [10 20 30 40]},
+    %              {"PID_ANGLE_VALUES", [1.5 0.2 0.3 4 0 0.7 -10 5 -90]}}
+    % windowSize: max. unbestaetigte Frames (Standard 8, hoechstens 128)
+    % timeout:    Sekunden bis zur Wiederholung ohne Antwort (Standard 0.2)
+    % maxRetries: Wiederholungen je Frame (Standard 3)
+    % results:    Fehlercode je Kommando (matlab_communication_error_t,
+    %             0 = OK), NaN wenn nie eine Antwort kam
+    if nargin < 3, windowSize = 8; end
+    if nargin < 4, timeout = 0.2; end
+    if nargin < 5, maxRetries = 3; end
+    windowSize = min(windowSize, 128);   % Sequenznummern 0..255 eindeutig
+
+    p = matlabProtocol();
+    % Uebertragungsfehler -> wiederholen, alles andere ist endgueltig
+    RETRY_CODES = [3 6 8];   % INVALID_SIGN, SEND, CHECKSUM_ERROR
+
+    n = numel(commands);
+    results = nan(1, n);
+    done = false(1, n);
+    sentAt = nan(1, n);
+    retries = zeros(1, n);
+    seqOf = mod(0:n - 1, 256);
+    rxBuffer = uint8([]);
+    base = 1;       % aeltestes unbestaetigtes Kommando
+    next = 1;       % naechstes noch nie gesendetes Kommando
+    clock = tic;
+
+    while base <= n
+        % Fenster auffuellen
+        while next <= n && next < base + windowSize
+            sendFrame(next);
+            next = next + 1;
+        end
+
+        % Antworten einsammeln
+        if s.NumBytesAvailable > 0
+            rxBuffer = [rxBuffer, read(s, s.NumBytesAvailable, "uint8")]; %#ok<AGROW>
+        end
+        ends = find(rxBuffer == p.ETX);
+        for e = ends
+            handleFrame(rxBuffer(1:e));
+        end
+        if ~isempty(ends)
+            rxBuffer = rxBuffer(ends(end) + 1:end);
+        end
+
+        % Zeitueberschreitung -> nur dieses Frame wiederholen
+        elapsed = toc(clock);
+        for i = find(~done(1:next - 1) & elapsed - sentAt(1:next - 1) > timeout)
+            retryOrGiveUp(i, NaN);
+        end
+
+        while base <= n && done(base)
+            base = base + 1;
+        end
+        pause(0.001);
+    end
+
+    function sendFrame(i)
+        command = commands{i};
+        write(s, protocolEncode(command{1}, command{2}, "ascii", seqOf(i)), "uint8");
+        sentAt(i) = toc(clock);
+    end
+
+    function retryOrGiveUp(i, code)
+        if retries(i) < maxRetries
+            retries(i) = retries(i) + 1;
+            sendFrame(i);
+        else
+            results(i) = code;
+            done(i) = true;
+        end
+    end
+
+    function handleFrame(frame)
+        [name, values, valid] = protocolDecode(frame);
+        if ~valid || (name ~= "ACK" && name ~= "NACK")
+            return;   % IMU-Daten, Antworten auf Abfragen
+        end
+
+        % Sequenznummer einem ausstehenden Kommando im Fenster zuordnen
+        window = base:next - 1;
+        i = window(~done(window) & seqOf(window) == values(1));
+        if isempty(i)
+            return;   % Antwort auf eine schon erledigte Wiederholung
+        end
+
+        code = values(2);
+        if name == "ACK"
+            results(i) = 0;
+            done(i) = true;
+        elseif any(code == RETRY_CODES)
+            retryOrGiveUp(i, code);
+        else
+            results(i) = code;
+            done(i) = true;
+        end
+    end
+end
@@ -0,0 +1,37 @@
+function sendMotorValuesBinary()
+    % UART konfigurieren
+    port = "COM13";
+    baud = 57600;
+    s = serialport(port, baud);
+
+    p = matlabProtocol();
+    FORMAT_BINARY = 1;
+
+    % 1) Binaerformat im ASCII-Protokoll anfordern
+    write(s, protocolEncode("FRAME_FORMAT", FORMAT_BINARY), "uint8");
+
+    % Bestaetigung kommt noch im alten (ASCII-)Format
+    configureTerminator(s, p.ETX);
+    disp(['Bestaetigung: ', char(readline(s))]);
+
+    % 2) Motorwerte als Binaerframe: 4 x uint8
+    frame = protocolEncode("MOTOR_VALUES", [10 20 30 40], "binary");
+    disp('Gesendetes Frame (Hex-Werte):');
+    disp(dec2hex(frame));
+    write(s, frame, "uint8");
+
+    % 3) ein IMU-Frame empfangen: Zeitstempel (uint32, us) + 3 x int16
+    rx = zeros(1, 0, 'uint8');
+    b = read(s, 1, "uint8");
+    while b ~= 0
+        rx(end + 1) = b; %#ok<AGROW>
+        b = read(s, 1, "uint8");
+    end
+    [name, imu, ok] = protocolDecode(rx, "binary");
+    if ok && name == "IMU_DATA"
+        fprintf('IMU: t=%u us x=%d y=%d z=%d\n', imu(1), imu(2), imu(3), imu(4));
+    end
+
+    % UART schließen
+    clear s;
+end
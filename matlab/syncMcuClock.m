@@ -0,0 +1,81 @@
+function sync = syncMcuClock(s, n, sync)
+    % Uhr des Controllers gegen die Host-Uhr vermessen (ASCII-Protokoll, CMD 0x09)
+    % s:    offener serialport
+    % n:    Anzahl Austausche (Standard 20, je ~10 ms)
+    % sync: optional Ergebnis eines frueheren Aufrufs; die neuen Messungen
+    %       kommen dazu (Drift ueber lange Laeufe), der Host-Bezug bleibt
+    % sync: struct mit
+    %       hostRef    tic-Bezug, Host-Zeit = toc(sync.hostRef) in s
+    %       samples    je Austausch [t1 t4 (s, Host, ohne Leitungszeit), t2 t3 (us)]
+    %       mcuAt0     Controller-Zeit (us) bei Host-Zeit 0
+    %       rate       Controller-us je Host-Sekunde (1e6 ohne Drift)
+    %       driftPpm   Gangabweichung des Controllers
+    %       delayUs    kuerzeste Laufzeit hin und zurueck
+    % Ablauf wie NTP: t1 senden, t2 (Empfang) und t3 (Antwort) vom Controller,
+    % t4 beim Empfang der Antwort. Laufzeit = (t4 - t1) - (t3 - t2); die
+    % Gerade mcu = mcuAt0 + rate * host wird nur durch die Haelfte mit der
+    % kuerzesten Laufzeit gelegt (Warteschlangen verfaelschen den Rest).
+    % t2 faellt auf das Ende der Anfrage, t3 auf den Anfang der Antwort: die
+    % Zeit auf der Leitung (10 Bit je Byte) wird vorher herausgerechnet.
+    % Umrechnen von Zeitstempeln: mcuToHostTime.m
+    if nargin < 2 || isempty(n)
+        n = 20;
+    end
+    if nargin < 3 || isempty(sync)
+        sync = struct('hostRef', tic, 'samples', zeros(0, 4), 'mcuAt0', 0, ...
+                      'rate', 1e6, 'driftPpm', 0, 'delayUs', NaN);
+    end
+
+    s.Timeout = 0.2;
+
+    for k = 1:n
+        t1 = toc(sync.hostRef);
+        t1Wire = mod(round(t1 * 1e6), 2^32);
+        request = protocolEncode("TIME_SYNC", t1Wire);
+        write(s, request, "uint8");
+
+        % alte Antworten erkennt man am falschen t1; t4 ist der Empfang,
+        % nicht das Ende der Suche
+        [values, ok, frame, age] = awaitFrame(s, "TIME_SYNC_ANSWER", @(v) v(1) == t1Wire);
+        t4 = toc(sync.hostRef) - age;
+        if ok
+            byteTime = 10 / s.BaudRate;
+            sync.samples(end + 1, :) = [t1 + numel(request) * byteTime, ...
+                                        t4 - (numel(frame) + 1) * byteTime, ...   % + ETX
+                                        unwrapMcu(values(2)), unwrapMcu(values(3))];
+        end
+        pause(0.01);
+    end
+
+    if isempty(sync.samples)
+        disp('syncMcuClock: keine Antwort');
+        return;
+    end
+
+    % Mitte jedes Austauschs auf beiden Seiten
+    hostMid = (sync.samples(:, 1) + sync.samples(:, 2)) / 2;
+    mcuMid = (sync.samples(:, 3) + sync.samples(:, 4)) / 2;
+    delay = (sync.samples(:, 2) - sync.samples(:, 1)) * 1e6 - (sync.samples(:, 4) - sync.samples(:, 3));
+    best = delay <= median(delay);
+    sync.delayUs = min(delay);
+
+    if nnz(best) >= 2 && max(hostMid(best)) - min(hostMid(best)) >= 1
+        c = polyfit(hostMid(best), mcuMid(best), 1);
+        sync.rate = c(1);
+        sync.mcuAt0 = c(2);
+    else
+        % zu kurz fuer eine Drift: nur der Offset
+        sync.rate = 1e6;
+        sync.mcuAt0 = mean(mcuMid(best) - 1e6 * hostMid(best));
+    end
+    sync.driftPpm = (sync.rate / 1e6 - 1) * 1e6;
+
+    % 32-Bit-Zaehler (Ueberlauf nach ~71,6 min) um die letzte Messung
+    % herum entfalten
+    function t = unwrapMcu(raw)
+        t = raw;
+        if ~isempty(sync.samples)
+            t = raw + 2^32 * round((sync.samples(end, 4) - raw) / 2^32);
+        end
+    end
+end
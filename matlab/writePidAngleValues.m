@@ -0,0 +1,29 @@
+function ok = writePidAngleValues(s, rollPitch, yaw, angles)
+    % Alle PID-Parameter und Sollwinkel in einem Frame senden (ASCII-Protokoll,
+    % PID_ANGLE_VALUES) und per Read-Back (PID_ANGLE_READ) pruefen
+    % s:         offener serialport
+    % rollPitch: [P I D] Roll/Pitch
+    % yaw:       [P I D] Yaw
+    % angles:    [Roll Pitch Yaw] Sollwinkel in Grad
+    % Skalierung wie in der Firmware (matlabProtocol.m): Gains in 1/10,
+    % Winkel ganzzahlig
+    p = matlabProtocol();
+    values = [rollPitch(:).', yaw(:).', angles(:).'];
+    scales = p.msg.PID_ANGLE_VALUES.scales;
+
+    write(s, protocolEncode("PID_ANGLE_VALUES", values), "uint8");
+    write(s, protocolEncode("PID_ANGLE_READ"), "uint8");
+
+    [readBack, received] = awaitFrame(s, "PID_ANGLE_READ_BACK");
+    if ~received
+        error('writePidAngleValues: keine Antwort');
+    end
+
+    % Vergleich auf der Leitung (nach der Rundung)
+    sent = round(values .* scales);
+    received = round(readBack .* scales);
+    ok = isequal(received, sent);
+    if ~ok
+        fprintf('Read-Back weicht ab:\n gesendet:  %s\n empfangen: %s\n', mat2str(sent), mat2str(received));
+    end
+end
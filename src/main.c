@@ -4,6 +4,17 @@
   #include "stm32f2xx_hal.h"
   #include "matlab_communication.h"
   #include "uart.h"
+  #include "fixed_point.h"
+  #include "scheduler.h"
+  #include "probe.h"
+  #include "parameter_store.h"
+  #include "timebase.h"
+  #include "flight_recorder.h"
+  #include "attitude_control.h"
+
+// control loop rate (scheduler task "control"), dt of the attitude PID
+#define C_CONTROL_RATE_HZ   (500u)
+#define C_CONTROL_THROTTLE  (128)   // base throttle of the attitude practical, motor units
 
 // instance pointer
 uart_t* uart4 = NULL;
@@ -15,78 +26,159 @@ volatile unsigned char b = 0;
 volatile unsigned char c = 0;
 volatile unsigned char d = 0;
 
-volatile double ap = 0;
-volatile double ai = 0;
-volatile double ad = 0;
+// PID gains and set points (Q16.16) as seen by the control loop, a
+// consistent snapshot from the parameter store
+static parameter_store_set_t _parameters;
 
-volatile double yp = 0;
-volatile double yi = 0;
-volatile double yd = 0;
+static attitude_control_t _attitude;
+static const attitude_control_config_t _attitudeConfig =
+{
+	.rateHz        = C_CONTROL_RATE_HZ,
+	.integralLimit = 40 * C_FIXEDPOINT_ONE,   // motor units
+	.outputLimit   = 100 * C_FIXEDPOINT_ONE,
+	.dFilterShift  = 2,                       // ~4 samples
+	.motorMin      = 0,
+	.motorMax      = 255
+};
 
-volatile double sr = 0;
-volatile double sp = 0;
-volatile double sy = 0;
+// roll, pitch, yaw in degrees; placeholder (level) until the attitude
+// estimation is in place
+static void _readAttitude(q16_16_t angles[E_ATTITUDE_AXIS_COUNT])
+{
+	angles[E_ATTITUDE_ROLL] = 0;
+	angles[E_ATTITUDE_PITCH] = 0;
+	angles[E_ATTITUDE_YAW] = 0;
+}
 
 
-void matlabDataCallback(matlab_communication_data_t* data)
+/*** command subscribers (matlab_communication registry) *********************/
+static void _onMotorValues(matlab_communication_t* matlabCom, const matlab_communication_data_t* data, void* context)
 {
-	if(data == NULL) {return;}
+	(void)matlabCom;
+	(void)context;
 
-	switch(data->cmd)
-	{
-		case E_MATLABCOM_CMD_INITIAL:
-			break;
-
-		case E_MATLABCOM_CMD_SET_MOTOR_VALUE:  
-		
-		_cmd = data->cmd;
-		a = data->motorData.motor1;
-		b = data->motorData.motor2;
-		c = data->motorData.motor3;
-		d = data->motorData.motor4;
-		break;
-		
-		case E_MATLABCOM_CMD_SET_PID_ANGLE_VALUES:
-      _cmd = data->cmd;
-      
-			switch(data->currentPidAngleCmd)
-			{
-			case C_MATLABCOM_ROLL_PITCH_DATA:
-			
-				ap = data->pidAngleData.pPitch_Roll / 10;
-				ai = data->pidAngleData.iPitch_Roll / 10;
-				ad = data->pidAngleData.dPitch_Roll / 10;
-				break;
-			
-			case C_MATLABCOM_YAW_DATA:
-			
-				yp = data->pidAngleData.pYaw / 10;
-				yi = data->pidAngleData.iYaw / 10;
-				yd = data->pidAngleData.dYaw / 10;
-				break;
-			
-			case C_MATLABCOM_ANGLE_DATA:
-			
-			sr = data->pidAngleData.targetAngleRoll;
-			sp = data->pidAngleData.targetAnglePitch;
-			sy = data->pidAngleData.targetAngleYaw;
-				break;
-			default:
-				//error
-				break;
-			}
-			break;
-	}
+	_cmd = E_MATLABCOM_CMD_SET_MOTOR_VALUE;
+	a = data->motorData.motor1;
+	b = data->motorData.motor2;
+	c = data->motorData.motor3;
+	d = data->motorData.motor4;
+}
+
+// PID/angle values arrive in Q16.16, converted by the field descriptors
+static void _onRollPitchGains(matlab_communication_t* matlabCom, const matlab_communication_data_t* data, void* context)
+{
+	(void)matlabCom;
+	(void)context;
+
+	parameter_store_gains_t gains = {
+		data->pidAngleData.pPitch_Roll, data->pidAngleData.iPitch_Roll, data->pidAngleData.dPitch_Roll
+	};
+	_cmd = E_MATLABCOM_CMD_SET_PID_ANGLE_VALUES;
+	parameterStore_publishGains(E_PARAMSTORE_ROLL_PITCH, &gains);
+}
+
+static void _onYawGains(matlab_communication_t* matlabCom, const matlab_communication_data_t* data, void* context)
+{
+	(void)matlabCom;
+	(void)context;
+
+	parameter_store_gains_t gains = {
+		data->pidAngleData.pYaw, data->pidAngleData.iYaw, data->pidAngleData.dYaw
+	};
+	_cmd = E_MATLABCOM_CMD_SET_PID_ANGLE_VALUES;
+	parameterStore_publishGains(E_PARAMSTORE_YAW, &gains);
+}
+
+static void _onAngles(matlab_communication_t* matlabCom, const matlab_communication_data_t* data, void* context)
+{
+	(void)matlabCom;
+	(void)context;
+
+	parameter_store_angles_t angles = {
+		data->pidAngleData.targetAngleRoll, data->pidAngleData.targetAnglePitch, data->pidAngleData.targetAngleYaw
+	};
+	_cmd = E_MATLABCOM_CMD_SET_PID_ANGLE_VALUES;
+	parameterStore_publishAngles(&angles);
+}
+
+static void _onAllValues(matlab_communication_t* matlabCom, const matlab_communication_data_t* data, void* context)
+{
+	(void)matlabCom;
+	(void)context;
+
+	// one transaction, the control loop never runs with half of it
+	const matlab_communication_Pid_Angle_data_t* pid = &data->pidAngleData;
+	parameter_store_set_t set = {
+		{ pid->pPitch_Roll, pid->iPitch_Roll, pid->dPitch_Roll },
+		{ pid->pYaw, pid->iYaw, pid->dYaw },
+		{ pid->targetAngleRoll, pid->targetAnglePitch, pid->targetAngleYaw }
+	};
+	_cmd = E_MATLABCOM_CMD_SET_PID_ANGLE_VALUES;
+	parameterStore_publishSet(&set);
+}
+
+// handler, not a subscriber: fills the answer, it reads back what the
+// controller actually uses
+static matlab_communication_error_t _onReadValues(matlab_communication_t* matlabCom, matlab_communication_data_t* data, void* context)
+{
+	(void)matlabCom;
+	(void)context;
+
+	parameter_store_set_t set;
+	parameterStore_readSet(&set);
+
+	data->pidAngleData.pPitch_Roll      = set.rollPitch.p;
+	data->pidAngleData.iPitch_Roll      = set.rollPitch.i;
+	data->pidAngleData.dPitch_Roll      = set.rollPitch.d;
+	data->pidAngleData.pYaw             = set.yaw.p;
+	data->pidAngleData.iYaw             = set.yaw.i;
+	data->pidAngleData.dYaw             = set.yaw.d;
+	data->pidAngleData.targetAngleRoll  = set.angles.roll;
+	data->pidAngleData.targetAnglePitch = set.angles.pitch;
+	data->pidAngleData.targetAngleYaw   = set.angles.yaw;
+	return E_MATLABCOMERROR_OK;
 }
 
 void QCSF_Control()
 {
-	
-	
+		static matlab_communication_practical_cmd_t _lastCmd = E_MATLABCOM_CMD_INITIAL;
+		bool entered = (_cmd != _lastCmd);
+		_lastCmd = _cmd;
+
 		// Gui practical with plot is active. USES CONTROLLER IN C
 		if(_cmd == E_MATLABCOM_CMD_SET_PID_ANGLE_VALUES)
 		{
-     		 printf("gui practical reached");
+			// one consistent set of all gains and set points, no matter
+			// where the writer runs
+			parameterStore_readSet(&_parameters);
+
+			// no integrator or filter state from an earlier run
+			if (entered) attitudeControl_reset(&_attitude);
+
+			// roll and pitch share their gains
+			attitude_control_gains_t rollPitch = { _parameters.rollPitch.p, _parameters.rollPitch.i, _parameters.rollPitch.d };
+			attitude_control_gains_t yaw = { _parameters.yaw.p, _parameters.yaw.i, _parameters.yaw.d };
+			attitudeControl_setGains(&_attitude, E_ATTITUDE_ROLL, &rollPitch);
+			attitudeControl_setGains(&_attitude, E_ATTITUDE_PITCH, &rollPitch);
+			attitudeControl_setGains(&_attitude, E_ATTITUDE_YAW, &yaw);
+			attitudeControl_setSetpoints(&_attitude, _parameters.angles.roll, _parameters.angles.pitch, _parameters.angles.yaw);
+
+			q16_16_t angles[E_ATTITUDE_AXIS_COUNT];
+			uint8_t motors[C_ATTITUDE_MOTORS];
+
+			_readAttitude(angles);
+			attitudeControl_update(&_attitude, angles, NULL, motors);   // no gyro yet: rates from the angles
+			a = motors[0];
+			b = motors[1];
+			c = motors[2];
+			d = motors[3];
+
+			for (uint8_t axis = 0; axis < E_ATTITUDE_AXIS_COUNT; axis++)
+			{
+				const attitude_control_terms_t* terms = &_attitude.terms[axis];
+				flightRecorder_setPid((flight_recorder_axis_t)axis, terms->p, terms->i, terms->d);
+			}
+			//Motors_run(&motor);
 		}
 		// Matlab controller practical is active. WON'T USE CONTROLLER IN C
 		else if(_cmd == E_MATLABCOM_CMD_SET_MOTOR_VALUE)
@@ -111,41 +203,85 @@ void QCSF_Control()
 
 
 
+// placeholder until the IMU driver is in place
+static void _readImu(int16_t* x, int16_t* y, int16_t* z)
+{
+	*x = 10;
+	*y = 23;
+	*z = 105;
+}
+
+/*** scheduler tasks ***********************************************************/
+static void _controlTask(void* context)
+{
+	(void)context;
+	int16_t x, y, z;
+
+	_readImu(&x, &y, &z);
+	flightRecorder_setImu(x, y, z);
+	QCSF_Control();
+
+	// one record per control pass, dumped over the link (matlab/readFlightRecorder.m)
+	flightRecorder_setMotors(a, b, c, d);
+	flightRecorder_setMode((uint8_t)_cmd);
+	flightRecorder_commit();
+}
+
+// parse everything the UART ISR has queued since the last pass
+static void _commTask(void* context)
+{
+	matlabCommunication_poll((matlab_communication_t*)context);
+}
+
+static void _telemetryTask(void* context)
+{
+	uint32_t timestampUs = timebase_nowUs();   // sample time, before the sensor read
+	int16_t x, y, z;
+
+	_readImu(&x, &y, &z);
+	matlabCommunication_sendImuData((matlab_communication_t*)context, timestampUs, x, y, z);
+}
+
 int main(void)
 {
 	/*** setup *******************************************************************/
 
 	HAL_Init();
+	scheduler_init();
+	parameterStore_init();
+	flightRecorder_init();
 	matlabCommunication_init();
+	attitudeControl_init(&_attitude, &_attitudeConfig);
+	attitudeControl_setThrottle(&_attitude, C_CONTROL_THROTTLE * C_FIXEDPOINT_ONE);
 
 	// initialise instances
 	if(uart4 == NULL && matlabCommunication == NULL)
 	{
+		// boot rate, the host can negotiate a faster one (matlab/negotiateBaudRate.m)
 		uart4 = uart_new(UART_4, 57600);
 		matlabCommunication = matlabCommunication_new(uart4);
-		matlabCommunication_registerDataCallback(matlabCommunication, matlabDataCallback);
 	}
 
+	// one subscriber per command, the parser dispatches by table lookup
+	matlabCommunication_subscribe(matlabCommunication, E_MATLABCOM_CMD_SET_MOTOR_VALUE, 0, _onMotorValues, NULL);
+	matlabCommunication_subscribe(matlabCommunication, E_MATLABCOM_CMD_SET_PID_ANGLE_VALUES, C_MATLABCOM_ROLL_PITCH_DATA, _onRollPitchGains, NULL);
+	matlabCommunication_subscribe(matlabCommunication, E_MATLABCOM_CMD_SET_PID_ANGLE_VALUES, C_MATLABCOM_YAW_DATA, _onYawGains, NULL);
+	matlabCommunication_subscribe(matlabCommunication, E_MATLABCOM_CMD_SET_PID_ANGLE_VALUES, C_MATLABCOM_ANGLE_DATA, _onAngles, NULL);
+	matlabCommunication_subscribe(matlabCommunication, E_MATLABCOM_CMD_SET_PID_ANGLE_VALUES, C_MATLABCOM_ALL_DATA, _onAllValues, NULL);
+	matlabCommunication_setHandler(E_MATLABCOM_CMD_GET_PID_ANGLE_VALUES, 0, _onReadValues, NULL);
+
 	volatile matlab_communication_error_t error;
 
 	error = matlabCommunication_getParserError(matlabCommunication);
 	printf("Error: %d\n", error);
 
-	QCSF_Control();
+	// priority 0 = highest; periods in ms ticks
+	scheduler_newTask("control",   SCHEDULER_PERIOD_HZ(C_CONTROL_RATE_HZ), 0, _controlTask,   NULL);
+	scheduler_newTask("comm",      SCHEDULER_PERIOD_HZ(1000),              1, _commTask,      matlabCommunication);
+	scheduler_newTask("telemetry", 3000,                                    2, _telemetryTask, matlabCommunication);
 
 	/*** main loop ***************************************************************/
-	while(1)
-  	{
-		double x = 0;
-		double y = 0;
-		double z = 0;
-
-		x = 10;
-		y = 23;
-		z = 105;
-
-		matlabCommunication_sendImuData(matlabCommunication, x, y, z);
-		HAL_Delay(3000);
-	}
+	scheduler_run();
+
   	return 0; 
 }
@@ -0,0 +1,131 @@
+/***************************************************************************
+ * test_main.c (test_attitude_control)
+ * Created on: 24-Oct-2026 11:00:00
+ * M. Schermutzki
+ * Attitude controller (pio test -e native): level hover gives the throttle
+ * on every motor, the integrator stays within its limit and freezes in
+ * saturation (anti-windup), and a 10 deg roll step on a double integrator
+ * plant settles without much overshoot.
+ ***************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <unity.h>
+
+#include "attitude_control.h"
+
+/*** macros ***************************************************************/
+#define C_TEST_RATE_HZ     (500u)
+#define C_TEST_THROTTLE    (128)
+
+#define C_TEST_PLANT_GAIN  (20.0)     // deg/s^2 per motor unit of axis output
+#define C_TEST_STEP_DEG    (10)
+#define C_TEST_STEP_S      (5u)
+
+#define Q(x)  ((q16_16_t)((x) * C_FIXEDPOINT_ONE))
+
+/*** local variables ******************************************************/
+static const attitude_control_config_t _config =
+{
+    .rateHz        = C_TEST_RATE_HZ,
+    .integralLimit = Q(40),
+    .outputLimit   = Q(100),
+    .dFilterShift  = 2,
+    .motorMin      = 0,
+    .motorMax      = 255
+};
+
+static attitude_control_t _control;
+static q16_16_t _angles[E_ATTITUDE_AXIS_COUNT];
+static q16_16_t _rates[E_ATTITUDE_AXIS_COUNT];
+static uint8_t _motors[C_ATTITUDE_MOTORS];
+
+/*** functions ************************************************************/
+
+static void _setup(double p, double i, double d)
+{
+    attitude_control_gains_t gains = { Q(p), Q(i), Q(d) };
+
+    attitudeControl_init(&_control, &_config);
+    attitudeControl_setThrottle(&_control, Q(C_TEST_THROTTLE));
+    for (uint8_t axis = 0; axis < E_ATTITUDE_AXIS_COUNT; axis++)
+    {
+        attitudeControl_setGains(&_control, (attitude_control_axis_t)axis, &gains);
+    }
+}
+
+static void _hold(uint32_t seconds)
+{
+    for (uint32_t n = 0; n < seconds * C_TEST_RATE_HZ; n++) attitudeControl_update(&_control, _angles, _rates, _motors);
+}
+
+void setUp(void)
+{
+    for (uint8_t axis = 0; axis < E_ATTITUDE_AXIS_COUNT; axis++)
+    {
+        _angles[axis] = 0;
+        _rates[axis] = 0;
+    }
+}
+
+void tearDown(void) {}
+
+// level, on the set point: throttle on every motor
+static void test_hover_mix(void)
+{
+    _setup(2.0, 0.5, 0.4);
+    attitudeControl_update(&_control, _angles, _rates, _motors);
+    for (uint8_t motor = 0; motor < C_ATTITUDE_MOTORS; motor++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(C_TEST_THROTTLE, _motors[motor]);
+    }
+}
+
+// constant error, P alone below the output limit: I ends at its limit
+static void test_integral_limit(void)
+{
+    _setup(1.0, 5.0, 0.0);
+    attitudeControl_setSetpoints(&_control, Q(20), 0, 0);
+    _hold(10u);
+    TEST_ASSERT_EQUAL_INT32(_config.integralLimit, _control.terms[E_ATTITUDE_ROLL].i);
+}
+
+// P alone saturates the output: I must not wind up behind it
+static void test_anti_windup(void)
+{
+    _setup(10.0, 5.0, 0.0);
+    attitudeControl_setSetpoints(&_control, Q(20), 0, 0);
+    _hold(10u);
+    TEST_ASSERT_EQUAL_INT32(0, _control.terms[E_ATTITUDE_ROLL].i);
+    TEST_ASSERT_EQUAL_INT32(_config.outputLimit, _control.terms[E_ATTITUDE_ROLL].output);
+}
+
+// roll step on theta'' = K * u (gyro rate to the controller)
+static void test_roll_step(void)
+{
+    double angle = 0.0, rate = 0.0, peak = 0.0, dt = 1.0 / C_TEST_RATE_HZ;
+
+    _setup(2.0, 0.5, 0.4);
+    attitudeControl_setSetpoints(&_control, Q(C_TEST_STEP_DEG), 0, 0);
+    for (uint32_t n = 0; n < C_TEST_STEP_S * C_TEST_RATE_HZ; n++)
+    {
+        _angles[E_ATTITUDE_ROLL] = Q(angle);
+        _rates[E_ATTITUDE_ROLL] = Q(rate);
+        attitudeControl_update(&_control, _angles, _rates, _motors);
+
+        rate += C_TEST_PLANT_GAIN * FIXEDPOINT_TO_DOUBLE(_control.terms[E_ATTITUDE_ROLL].output) * dt;
+        angle += rate * dt;
+        if (angle > peak) peak = angle;
+    }
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.2f, (float)C_TEST_STEP_DEG, (float)angle, "settled angle");
+    TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(1.3f * C_TEST_STEP_DEG, (float)peak, "overshoot");
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_hover_mix);
+    RUN_TEST(test_integral_limit);
+    RUN_TEST(test_anti_windup);
+    RUN_TEST(test_roll_step);
+    return UNITY_END();
+}
@@ -0,0 +1,250 @@
+/***************************************************************************
+ * test_main.c (test_baud_negotiation)
+ * Created on: 24-Oct-2026 10:00:00
+ * M. Schermutzki
+ * Baud rate handshake (CMD 0x07) over a real pty (pio test -e native): a
+ * background thread runs matlab_communication on UART4 against
+ * lib/hal_native with the baud rate model on (HAL_NATIVE_PTY_BAUD=1), the
+ * tests open the slave side and negotiate like matlab/negotiateBaudRate.m.
+ * The tests build on each other and run in the order below: switch up,
+ * stay committed, fall back after a lost host, reject unsupported rates.
+ ***************************************************************************/
+#define _GNU_SOURCE   // setenv, cfsetspeed
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <termios.h>
+#include <unity.h>
+
+#undef CR1   // termios.h vs. USART registers
+#undef CR2
+#undef CR3
+
+#include "hal_native.h"
+#include "uart.h"
+#include "matlab_communication.h"
+#include "frame_builder.h"
+#include "crc16.h"
+
+/*** macros ***************************************************************/
+#define C_TEST_START_BAUD   (57600u)
+#define C_TEST_FAST_BAUD    (460800u)    // C_MATLABCOM_MAX_BAUD
+#define C_TEST_LOST_BAUD    (115200u)
+#define C_TEST_RING_BAUD    (921600u)    // UART can, RX ring cannot
+#define C_TEST_BAD_BAUD     (4000000u)   // > PCLK1/16 for UART4
+#define C_TEST_TIMEOUT_MS   (300u)
+#define C_TEST_FALLBACK_MS  (700u)       // > C_MATLABCOM_BAUD_TIMEOUT_MS
+
+#define C_TEST_STX  (C_MATLABCOM_STX)
+#define C_TEST_US   (C_MATLABCOM_US)
+#define C_TEST_ETX  (C_MATLABCOM_ETX)
+
+#define CMD_PID_ANGLE_READ  (C_MATLABCOM_ID_PID_ANGLE_READ)
+#define CMD_BAUD_RATE       (C_MATLABCOM_ID_BAUD_RATE)
+
+/*** local variables ******************************************************/
+static volatile bool _stop = false;
+static matlab_communication_t* _matlabCom = NULL;
+static int _fd = -1;
+
+/*** functions ************************************************************/
+
+static uint64_t _nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// the firmware side: comm task and idle loop
+static void* _mcu(void* arg)
+{
+    (void)arg;
+    while (!_stop)
+    {
+        matlabCommunication_poll(_matlabCom);
+        __WFI();
+    }
+    return NULL;
+}
+
+static void _setHostBaud(speed_t speed)
+{
+    struct termios tio;
+    tcgetattr(_fd, &tio);
+    cfmakeraw(&tio);
+    cfsetspeed(&tio, speed);
+    tcsetattr(_fd, TCSANOW, &tio);
+    tcflush(_fd, TCIOFLUSH);
+}
+
+static void _sendFrame(const uint32_t* fields, size_t count)
+{
+    uint8_t frame[64];
+    frame_builder_t fb;
+
+    frameBuilder_begin(&fb, frame, sizeof(frame), C_TEST_STX, C_TEST_US, C_TEST_ETX);
+    for (size_t i = 0; i < count; i++) frameBuilder_addHex(&fb, fields[i]);
+
+    size_t len = frameBuilder_finish(&fb);
+    ssize_t written = write(_fd, frame, len);
+    (void)written;
+}
+
+/***************************************************************************
+ * Wait for a valid ASCII frame with the given command, fields after the
+ * command go to fields[]; false on timeout
+ **************************************************************************/
+static bool _awaitFrame(uint32_t cmd, uint32_t* fields, size_t maxFields, uint32_t timeoutMs)
+{
+    uint8_t frame[128];
+    size_t len = 0;
+    bool inFrame = false;
+    uint64_t endNs = _nowNs() + (uint64_t)timeoutMs * 1000000ull;
+
+    while (_nowNs() < endNs)
+    {
+        uint8_t byte;
+        if (read(_fd, &byte, 1) != 1) { usleep(200); continue; }
+
+        if (byte == C_TEST_STX) { inFrame = true; len = 0; continue; }
+        if (!inFrame) continue;
+        if (byte != C_TEST_ETX)
+        {
+            if (len < sizeof(frame) - 1u) frame[len++] = byte; else inFrame = false;
+            continue;
+        }
+        inFrame = false;
+
+        // fields | US | crc
+        size_t lastUs = len;
+        while (lastUs > 0 && frame[lastUs - 1u] != C_TEST_US) lastUs--;
+        if (lastUs == 0) continue;
+
+        frame[len] = 0;
+        if (strtoul((char*)&frame[lastUs], NULL, 16) != crc16_update(0xFFFF, frame, lastUs, 1)) continue;
+
+        uint32_t values[16];
+        size_t count = 0;
+        char* token = (char*)frame;
+        frame[lastUs - 1u] = 0;
+        while (token && count < 16u)
+        {
+            values[count++] = (uint32_t)strtoul(token, NULL, 16);
+            token = strchr(token, C_TEST_US);
+            if (token) token++;
+        }
+
+        if (values[0] != cmd) continue;
+        for (size_t i = 1; i < count && i - 1u < maxFields; i++) fields[i - 1u] = values[i];
+        return true;
+    }
+    return false;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// up to the highest rate: confirmation at the old rate, then a frame at the new one
+static void test_switch_up(void)
+{
+    uint32_t fields[2] = {0};
+
+    _setHostBaud(B57600);
+    _sendFrame((uint32_t[]){CMD_BAUD_RATE, C_TEST_FAST_BAUD}, 2);
+    TEST_ASSERT_TRUE(_awaitFrame(CMD_BAUD_RATE, fields, 2, C_TEST_TIMEOUT_MS));
+    TEST_ASSERT_EQUAL_UINT32(C_TEST_FAST_BAUD, fields[0]);
+    TEST_ASSERT_EQUAL_UINT32(1u, fields[1]);
+
+    usleep(20000);   // confirmation has left, firmware has switched
+    _setHostBaud(B460800);
+    _sendFrame((uint32_t[]){CMD_PID_ANGLE_READ}, 1);
+    TEST_ASSERT_TRUE(_awaitFrame(CMD_PID_ANGLE_READ, NULL, 0, C_TEST_TIMEOUT_MS));
+}
+
+// still there after the fallback timeout, the frame above committed the rate
+static void test_committed(void)
+{
+    usleep(C_TEST_FALLBACK_MS * 1000u);
+    _sendFrame((uint32_t[]){CMD_PID_ANGLE_READ}, 1);
+    TEST_ASSERT_TRUE(_awaitFrame(CMD_PID_ANGLE_READ, NULL, 0, C_TEST_TIMEOUT_MS));
+}
+
+// host "loses" the confirmation and stays at the fast rate -> firmware falls back
+static void test_fallback(void)
+{
+    uint32_t fields[2] = {0};
+
+    _sendFrame((uint32_t[]){CMD_BAUD_RATE, C_TEST_LOST_BAUD}, 2);
+    TEST_ASSERT_TRUE(_awaitFrame(CMD_BAUD_RATE, fields, 2, C_TEST_TIMEOUT_MS));
+    TEST_ASSERT_EQUAL_UINT32(1u, fields[1]);
+
+    usleep(C_TEST_FALLBACK_MS * 1000u);
+    tcflush(_fd, TCIOFLUSH);
+    _sendFrame((uint32_t[]){CMD_PID_ANGLE_READ}, 1);
+    TEST_ASSERT_TRUE(_awaitFrame(CMD_PID_ANGLE_READ, NULL, 0, C_TEST_TIMEOUT_MS));
+}
+
+// rates the RX ring or the UART cannot take: rejected, nothing changes
+static void test_reject(void)
+{
+    uint32_t fields[2] = {0};
+
+    _sendFrame((uint32_t[]){CMD_BAUD_RATE, C_TEST_RING_BAUD}, 2);
+    TEST_ASSERT_TRUE(_awaitFrame(CMD_BAUD_RATE, fields, 2, C_TEST_TIMEOUT_MS));
+    TEST_ASSERT_EQUAL_UINT32(0u, fields[1]);
+
+    _sendFrame((uint32_t[]){CMD_BAUD_RATE, C_TEST_BAD_BAUD}, 2);
+    TEST_ASSERT_TRUE(_awaitFrame(CMD_BAUD_RATE, fields, 2, C_TEST_TIMEOUT_MS));
+    TEST_ASSERT_EQUAL_UINT32(0u, fields[1]);
+
+    _sendFrame((uint32_t[]){CMD_PID_ANGLE_READ}, 1);
+    TEST_ASSERT_TRUE(_awaitFrame(CMD_PID_ANGLE_READ, NULL, 0, C_TEST_TIMEOUT_MS));
+}
+
+// wrong host rate really breaks the link (the model is active)
+static void test_mismatch_detected(void)
+{
+    _setHostBaud(B57600);
+    _sendFrame((uint32_t[]){CMD_PID_ANGLE_READ}, 1);
+    TEST_ASSERT_FALSE(_awaitFrame(CMD_PID_ANGLE_READ, NULL, 0, C_TEST_TIMEOUT_MS));
+}
+
+int main(void)
+{
+    pthread_t mcu;
+
+    setenv("HAL_NATIVE_PTY_BAUD", "1", 1);
+    unsetenv("HAL_NATIVE_PTY");
+
+    HAL_Init();
+    matlabCommunication_init();
+    uart_t* uart = uart_new(UART_4, C_TEST_START_BAUD);
+    _matlabCom = matlabCommunication_new(uart);
+
+    const char* ptyName = halNative_uartPtyName(UART4);
+    if (!_matlabCom || !ptyName) return 1;
+    _fd = open(ptyName, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (_fd < 0) return 1;
+
+    pthread_create(&mcu, NULL, _mcu, NULL);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_switch_up);
+    RUN_TEST(test_committed);
+    RUN_TEST(test_fallback);
+    RUN_TEST(test_reject);
+    RUN_TEST(test_mismatch_detected);
+    int failures = UNITY_END();
+
+    _stop = true;
+    pthread_join(mcu, NULL);
+    close(_fd);
+    return failures;
+}
@@ -0,0 +1,73 @@
+/***************************************************************************
+ * test_main.c (test_crc16)
+ * Created on: 24-Oct-2026 15:00:00
+ * M. Schermutzki
+ * crc16 kernels (pio test -e native): the slice tables are const, so
+ * crc16_update() gives the right crc before crc16_init() ran, and every
+ * kernel matches the bit-wise CRC16-CCITT for all lengths and offsets.
+ ***************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <unity.h>
+
+#include "crc16.h"
+
+/*** local variables ******************************************************/
+static const uint8_t _slices[] = {1u, 4u, 8u};
+static uint8_t _buffer[128];
+
+/*** functions ************************************************************/
+
+// bit by bit, no tables
+static uint16_t _reference(const uint8_t* data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    while (len--)
+    {
+        crc ^= (uint16_t)(*data++ << 8);
+        for (uint8_t k = 0; k < 8u; k++) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// CRC-16/CCITT-FALSE("123456789") = 0x29B1, crc16_init() not called yet
+static void test_check_value_without_init(void)
+{
+    for (size_t s = 0; s < sizeof(_slices); s++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(0x29B1, crc16_update(0xFFFF, (const uint8_t*)"123456789", 9u, _slices[s]));
+    }
+}
+
+static void test_kernels_match_reference(void)
+{
+    uint32_t seed = 0x2545F491u;
+    for (size_t i = 0; i < sizeof(_buffer); i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        _buffer[i] = (uint8_t)(seed >> 24);
+    }
+
+    for (size_t len = 0; len <= 64u; len++)
+    {
+        for (size_t offset = 0; offset < 8u; offset++)
+        {
+            uint16_t expected = _reference(&_buffer[offset], len);
+            for (size_t s = 0; s < sizeof(_slices); s++)
+            {
+                TEST_ASSERT_EQUAL_UINT32(expected, crc16_update(0xFFFF, &_buffer[offset], len, _slices[s]));
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_check_value_without_init);
+    RUN_TEST(test_kernels_match_reference);
+    return UNITY_END();
+}
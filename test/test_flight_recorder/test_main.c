@@ -0,0 +1,84 @@
+/***************************************************************************
+ * test_main.c (test_flight_recorder)
+ * Created on: 24-Oct-2026 10:30:00
+ * M. Schermutzki
+ * Flight recorder ring (pio test -e native): after a wrap the records come
+ * out oldest first without gaps, the trigger record sits at triggerIndex
+ * and postTrigger records follow it, then the recorder stops by itself.
+ ***************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <unity.h>
+
+#include "flight_recorder.h"
+
+/*** macros ***************************************************************/
+#define C_TEST_POST_TRIGGER  (C_FLIGHTREC_RECORDS / 4u)
+#define C_TEST_CHUNK         (8u)     // records per dump chunk (matlab_communication.c)
+
+/*** local variables ******************************************************/
+static flight_record_t _dump[C_FLIGHTREC_RECORDS];
+
+/*** functions ************************************************************/
+
+// what the control task does once per pass
+static void _record(uint32_t i)
+{
+    flightRecorder_setImu((int16_t)i, (int16_t)(i >> 1), (int16_t)-i);
+    flightRecorder_setMotors((uint8_t)i, (uint8_t)(i + 1u), (uint8_t)(i + 2u), (uint8_t)(i + 3u));
+    for (uint8_t axis = 0; axis < E_FLIGHTREC_AXIS_COUNT; axis++)
+    {
+        flightRecorder_setPid((flight_recorder_axis_t)axis, (q16_16_t)(i << 8), -(q16_16_t)(i << 8), (q16_16_t)axis << 16);
+    }
+    flightRecorder_setMode(1);
+    flightRecorder_commit();
+}
+
+void setUp(void)
+{
+    flightRecorder_init();
+}
+
+void tearDown(void) {}
+
+/***************************************************************************
+ * Arm, run past a wrap, trigger, stop by itself; check the dump
+ **************************************************************************/
+static void test_trigger_after_wrap(void)
+{
+    flight_recorder_status_t status;
+    uint32_t i = 0;
+
+    flightRecorder_arm(C_TEST_POST_TRIGGER, E_FLIGHTREC_EVENT_CRC_ERROR);
+    for (; i < 2u * C_FLIGHTREC_RECORDS; i++) _record(i);
+
+    flightRecorder_event(E_FLIGHTREC_EVENT_CRC_ERROR);
+    for (; i < 4u * C_FLIGHTREC_RECORDS; i++) _record(i);   // stops after the post trigger records
+
+    flightRecorder_getStatus(&status);
+    TEST_ASSERT_TRUE(status.state == E_FLIGHTREC_STOPPED);
+    TEST_ASSERT_EQUAL_UINT32(C_FLIGHTREC_RECORDS, status.count);
+    TEST_ASSERT_EQUAL_UINT32(C_FLIGHTREC_RECORDS - 1u - C_TEST_POST_TRIGGER, status.triggerIndex);
+
+    size_t count = 0;
+    while (count < status.count)
+    {
+        size_t read = flightRecorder_read((uint32_t)count, &_dump[count], C_TEST_CHUNK);
+        TEST_ASSERT_TRUE(read > 0);
+        count += read;
+    }
+
+    TEST_ASSERT_TRUE((_dump[status.triggerIndex].events & E_FLIGHTREC_EVENT_TRIGGER) != 0);
+    for (size_t k = 1; k < count; k++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(1u, (uint16_t)(_dump[k].sequence - _dump[k - 1].sequence));
+        TEST_ASSERT_EQUAL_INT32((int16_t)_dump[k].sequence, _dump[k].imu[0]);
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_trigger_after_wrap);
+    return UNITY_END();
+}
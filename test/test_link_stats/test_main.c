@@ -0,0 +1,116 @@
+/***************************************************************************
+ * test_main.c (test_link_stats)
+ * Created on: 24-Oct-2026 14:00:00
+ * M. Schermutzki
+ * Link counters of the binary parser (pio test -e native): every rejected
+ * frame shows up in matlabCommunication_getLinkStats(), a payload that
+ * does not fit its command in badLength.
+ ***************************************************************************/
+#define _POSIX_C_SOURCE 200809L   // setenv
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unity.h>
+
+#include "hal_native.h"
+#include "uart.h"
+#include "matlab_communication.h"
+#include "crc16.h"
+#include "cobs.h"
+
+/*** macros ***************************************************************/
+#define C_TEST_MAX_FRAME  (64u)
+
+/*** local variables ******************************************************/
+static matlab_communication_t* _matlabCom = NULL;
+
+/*** functions ************************************************************/
+
+/***************************************************************************
+ * cmd | payload | crc16 (LE), COBS encoded and delimited, into the parser
+ **************************************************************************/
+static void _parseFrame(uint8_t cmd, const uint8_t* payload, size_t len)
+{
+    uint8_t frame[C_TEST_MAX_FRAME];
+    uint8_t encoded[C_TEST_MAX_FRAME + 2u];
+
+    frame[0] = cmd;
+    if (len > 0) memcpy(&frame[1], payload, len);
+    uint16_t crc = crc16_update(0xFFFF, frame, len + 1u, 1);
+    frame[len + 1u] = (uint8_t)crc;
+    frame[len + 2u] = (uint8_t)(crc >> 8);
+
+    size_t encodedLen = cobs_encode(frame, len + 3u, encoded, sizeof(encoded) - 1u);
+    encoded[encodedLen++] = C_MATLABCOM_BIN_DELIMITER;
+    matlabCommunication_parse(_matlabCom, encoded, encodedLen);
+}
+
+static matlab_communication_link_stats_t _stats(void)
+{
+    matlab_communication_link_stats_t stats;
+    matlabCommunication_getLinkStats(_matlabCom, &stats);
+    return stats;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// sequence flag without the sequence byte
+static void test_missing_sequence(void)
+{
+    matlab_communication_link_stats_t before = _stats();
+
+    _parseFrame(C_MATLABCOM_ID_PID_ANGLE_READ | C_MATLABCOM_SEQ_FLAG, NULL, 0);
+    TEST_ASSERT_EQUAL_UINT32(before.badLength + 1u, _stats().badLength);
+    TEST_ASSERT_EQUAL_UINT32(before.framesOk, _stats().framesOk);
+}
+
+// command with sub-commands, but no sub-command byte
+static void test_missing_sub_command(void)
+{
+    matlab_communication_link_stats_t before = _stats();
+
+    _parseFrame(C_MATLABCOM_ID_PID_ANGLE_VALUES, NULL, 0);
+    TEST_ASSERT_EQUAL_UINT32(before.badLength + 1u, _stats().badLength);
+    TEST_ASSERT_EQUAL_UINT32(before.framesOk, _stats().framesOk);
+}
+
+// fields shorter than the command needs
+static void test_field_size_mismatch(void)
+{
+    static const uint8_t payload[] = { 0x07, 0x01 };   // TARGET_ANGLES, one byte instead of three fields
+    matlab_communication_link_stats_t before = _stats();
+
+    _parseFrame(C_MATLABCOM_ID_PID_ANGLE_VALUES, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL_UINT32(before.badLength + 1u, _stats().badLength);
+    TEST_ASSERT_EQUAL_UINT32(before.framesOk, _stats().framesOk);
+}
+
+// a valid frame after the rejects still goes through
+static void test_valid_frame(void)
+{
+    matlab_communication_link_stats_t before = _stats();
+
+    _parseFrame(C_MATLABCOM_ID_PID_ANGLE_READ, NULL, 0);
+    TEST_ASSERT_EQUAL_UINT32(before.framesOk + 1u, _stats().framesOk);
+    TEST_ASSERT_EQUAL_UINT32(before.badLength, _stats().badLength);
+}
+
+int main(void)
+{
+    setenv("HAL_NATIVE_PTY", "0", 1);
+
+    HAL_Init();
+    matlabCommunication_init();
+    _matlabCom = matlabCommunication_new(uart_new(UART_4, 115200));
+    if (!_matlabCom) return 1;
+    matlabCommunication_setFrameFormat(_matlabCom, E_MATLABCOM_FORMAT_BINARY);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_missing_sequence);
+    RUN_TEST(test_missing_sub_command);
+    RUN_TEST(test_field_size_mismatch);
+    RUN_TEST(test_valid_frame);
+    return UNITY_END();
+}
@@ -0,0 +1,308 @@
+/***************************************************************************
+ * test_main.c (test_parameter_store)
+ * Created on: 24-Oct-2026 09:00:00
+ * M. Schermutzki
+ * Parameter store under concurrency (pio test -e native): one writer
+ * thread, reader threads and, in the preempt test, a signal handler that
+ * reads the store on the writer thread in the middle of a publish (ISR
+ * reading the parameters). Every snapshot has to fulfil the relation the
+ * writer keeps within a group, never go back in time and, for whole sets
+ * published with publishSet, show one generation in all groups. A nested
+ * read that does not come back fails the test (hung).
+ ***************************************************************************/
+#define _POSIX_C_SOURCE 200809L   // clock_gettime, nanosleep, sigaction
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unity.h>
+
+#include "parameter_store.h"
+
+/*** macros ***************************************************************/
+#define C_TEST_READERS      (3u)
+#define C_TEST_PHASE_MS     (1000u)
+#define C_TEST_HANG_MS      (500u)    // writer without progress -> nested read hangs
+#define C_TEST_SIGNAL_NS    (20000)   // between two interrupts of the writer
+
+/*** definitions **********************************************************/
+typedef enum
+{
+    E_TEST_GROUPS,     // single groups, round robin
+    E_TEST_SET,        // whole sets, one generation in every group
+    E_TEST_PREEMPT     // whole sets and the same generation group by group
+} test_mode_t;
+
+typedef struct
+{
+    uint64_t reads;
+    uint64_t torn;
+    uint64_t backwards;
+    uint64_t mixed;       // readSet with groups of different publishes
+    q16_16_t last[E_PARAMSTORE_GROUP_COUNT];
+} test_reader_t;
+
+/*** local variables ******************************************************/
+static volatile bool _stop = false;
+static test_mode_t _mode = E_TEST_GROUPS;
+static volatile uint64_t _writes = 0;
+static test_reader_t _readers[C_TEST_READERS];
+
+// preempt test: reads in the signal handler, only touched by the writer thread
+static test_reader_t _nested;
+static volatile bool _inPublish = false;
+static uint64_t _nestedInPublish = 0;
+
+/*** functions ************************************************************/
+
+static uint64_t _nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t _random(uint32_t* state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// relation every complete group fulfils
+static inline bool _consistent(q16_16_t a, q16_16_t b, q16_16_t c)
+{
+    return (b == (q16_16_t)((uint32_t)a * 3u + 1u)) && (c == ~a);
+}
+
+static void _publishGroup(parameter_store_group_t group, q16_16_t a, q16_16_t b, q16_16_t c)
+{
+    if (group == E_PARAMSTORE_ANGLE)
+    {
+        parameter_store_angles_t angles = {a, b, c};
+        parameterStore_publishAngles(&angles);
+    }
+    else
+    {
+        parameter_store_gains_t gains = {a, b, c};
+        parameterStore_publishGains(group, &gains);
+    }
+}
+
+/***************************************************************************
+ * The one writer: generation k, single groups or whole sets by mode
+ **************************************************************************/
+static void* _writer(void* arg)
+{
+    (void)arg;
+    uint32_t k[E_PARAMSTORE_GROUP_COUNT] = {0};
+    uint8_t group = 0;
+
+    while (!_stop)
+    {
+        if (_mode == E_TEST_GROUPS)
+        {
+            uint32_t n = ++k[group];
+            _publishGroup((parameter_store_group_t)group, (q16_16_t)n, (q16_16_t)(n * 3u + 1u), ~(q16_16_t)n);
+            group = (uint8_t)((group + 1u) % E_PARAMSTORE_GROUP_COUNT);
+        }
+        else
+        {
+            uint32_t n = ++k[0];
+            q16_16_t a = (q16_16_t)n;
+            q16_16_t b = (q16_16_t)(n * 3u + 1u);
+            q16_16_t c = ~a;
+            parameter_store_set_t set = { {a, b, c}, {a, b, c}, {a, b, c} };
+
+            _inPublish = true;
+            parameterStore_publishSet(&set);
+            if (_mode == E_TEST_PREEMPT)
+            {
+                for (uint8_t g = 0; g < E_PARAMSTORE_GROUP_COUNT; g++) _publishGroup((parameter_store_group_t)g, a, b, c);
+            }
+            _inPublish = false;
+        }
+        _writes++;
+    }
+    return NULL;
+}
+
+/***************************************************************************
+ * Checks shared by the reader threads and the signal handler
+ **************************************************************************/
+static void _checkSet(test_reader_t* stats)
+{
+    parameter_store_set_t set;
+    parameterStore_readSet(&set);
+
+    const q16_16_t values[E_PARAMSTORE_GROUP_COUNT][3] =
+    {
+        [E_PARAMSTORE_ROLL_PITCH] = {set.rollPitch.p, set.rollPitch.i, set.rollPitch.d},
+        [E_PARAMSTORE_YAW]        = {set.yaw.p, set.yaw.i, set.yaw.d},
+        [E_PARAMSTORE_ANGLE]      = {set.angles.roll, set.angles.pitch, set.angles.yaw}
+    };
+    for (uint8_t g = 0; g < E_PARAMSTORE_GROUP_COUNT; g++)
+    {
+        q16_16_t a = values[g][0];
+        if (a != 0 && !_consistent(a, values[g][1], values[g][2])) stats->torn++;
+        if ((uint32_t)a < (uint32_t)stats->last[g]) stats->backwards++;
+        stats->last[g] = a;
+        if (_mode != E_TEST_GROUPS && a != values[0][0]) stats->mixed++;
+    }
+    stats->reads++;
+}
+
+static void _checkGroup(test_reader_t* stats, parameter_store_group_t group)
+{
+    q16_16_t a, b, c;
+
+    if (group == E_PARAMSTORE_ANGLE)
+    {
+        parameter_store_angles_t angles;
+        parameterStore_readAngles(&angles);
+        a = angles.roll; b = angles.pitch; c = angles.yaw;
+    }
+    else
+    {
+        parameter_store_gains_t gains;
+        parameterStore_readGains(group, &gains);
+        a = gains.p; b = gains.i; c = gains.d;
+    }
+
+    stats->reads++;
+    if (a != 0 && !_consistent(a, b, c)) stats->torn++;
+    if ((uint32_t)a < (uint32_t)stats->last[group]) stats->backwards++;
+    stats->last[group] = a;
+}
+
+static void* _reader(void* arg)
+{
+    test_reader_t* stats = (test_reader_t*)arg;
+    uint32_t seed = (uint32_t)(uintptr_t)arg | 1u;
+
+    while (!_stop)
+    {
+        uint32_t pick = _random(&seed) % (E_PARAMSTORE_GROUP_COUNT + 1u);
+
+        if (pick == E_PARAMSTORE_GROUP_COUNT) _checkSet(stats);
+        else _checkGroup(stats, (parameter_store_group_t)pick);
+    }
+    return NULL;
+}
+
+// runs on the writer thread wherever the signal hits it
+static void _onSignal(int signal)
+{
+    (void)signal;
+
+    if (_inPublish) _nestedInPublish++;
+    _checkSet(&_nested);
+    _checkGroup(&_nested, (parameter_store_group_t)(_nested.reads % E_PARAMSTORE_GROUP_COUNT));
+}
+
+/***************************************************************************
+ * Run writer and readers for C_TEST_PHASE_MS and check the totals
+ **************************************************************************/
+static void _run(test_mode_t mode)
+{
+    pthread_t writer;
+    pthread_t readers[C_TEST_READERS];
+    bool hung = false;
+
+    parameterStore_init();
+    _stop = false;
+    _mode = mode;
+    _writes = 0;
+    _nestedInPublish = 0;
+    memset(_readers, 0, sizeof(_readers));
+    memset(&_nested, 0, sizeof(_nested));
+
+    pthread_create(&writer, NULL, _writer, NULL);
+    for (size_t r = 0; r < C_TEST_READERS; r++) pthread_create(&readers[r], NULL, _reader, &_readers[r]);
+
+    uint64_t startNs = _nowNs();
+    uint64_t progressNs = startNs;
+    uint64_t lastWrites = 0;
+    while (_nowNs() - startNs < (uint64_t)C_TEST_PHASE_MS * 1000000ull)
+    {
+        struct timespec ts = {0, (mode == E_TEST_PREEMPT) ? C_TEST_SIGNAL_NS : 10000000};
+        nanosleep(&ts, NULL);
+        if (mode == E_TEST_PREEMPT) pthread_kill(writer, SIGUSR1);
+
+        uint64_t nowNs = _nowNs();
+        if (_writes != lastWrites)
+        {
+            lastWrites = _writes;
+            progressNs = nowNs;
+        }
+        else if (nowNs - progressNs > (uint64_t)C_TEST_HANG_MS * 1000000ull)
+        {
+            hung = true;
+            break;
+        }
+    }
+    _stop = true;
+
+    // a hung writer leaves the store mid-publish, the process ends with the
+    // test run
+    TEST_ASSERT_FALSE_MESSAGE(hung, "nested read did not return");
+    pthread_join(writer, NULL);
+    for (size_t r = 0; r < C_TEST_READERS; r++) pthread_join(readers[r], NULL);
+
+    test_reader_t total = _nested;
+    for (size_t r = 0; r < C_TEST_READERS; r++)
+    {
+        total.reads += _readers[r].reads;
+        total.torn += _readers[r].torn;
+        total.backwards += _readers[r].backwards;
+        total.mixed += _readers[r].mixed;
+    }
+
+    TEST_ASSERT_TRUE_MESSAGE(_writes > 0 && total.reads > 0, "no traffic");
+    TEST_ASSERT_EQUAL_UINT64_MESSAGE(0, total.torn, "torn group");
+    TEST_ASSERT_EQUAL_UINT64_MESSAGE(0, total.backwards, "value went back in time");
+    TEST_ASSERT_EQUAL_UINT64_MESSAGE(0, total.mixed, "readSet mixed two publishes");
+    if (mode == E_TEST_PREEMPT)
+    {
+        TEST_ASSERT_TRUE_MESSAGE(_nestedInPublish > 0, "no read landed inside a publish");
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_single_groups(void)
+{
+    _run(E_TEST_GROUPS);
+}
+
+static void test_whole_sets(void)
+{
+    _run(E_TEST_SET);
+}
+
+static void test_reader_preempts_writer(void)
+{
+    _run(E_TEST_PREEMPT);
+}
+
+int main(void)
+{
+    struct sigaction action;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = _onSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGUSR1, &action, NULL);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_single_groups);
+    RUN_TEST(test_whole_sets);
+    RUN_TEST(test_reader_preempts_writer);
+    return UNITY_END();
+}
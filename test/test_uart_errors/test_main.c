@@ -0,0 +1,136 @@
+/***************************************************************************
+ * test_main.c (test_uart_errors)
+ * Created on: 24-Oct-2026 09:30:00
+ * M. Schermutzki
+ * UART receive error handling against lib/hal_native (pio test -e native):
+ * injects ORE, NE/FE and PE between two bursts, in interrupt and in DMA
+ * mode. Every byte after the error has to arrive (reception re-armed by
+ * HAL_UART_ErrorCallback) and the counters of uart_getStats() have to
+ * match the injected error.
+ ***************************************************************************/
+#define _POSIX_C_SOURCE 200809L   // setenv, clock_gettime
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unity.h>
+
+#include "hal_native.h"
+#include "uart.h"
+
+/*** macros ***************************************************************/
+#define C_TEST_BURST       (200u)
+#define C_TEST_TIMEOUT_MS  (200u)
+
+/*** definitions **********************************************************/
+typedef struct
+{
+    const char* name;
+    uint32_t error;
+} test_error_t;
+
+/*** local variables ******************************************************/
+static const test_error_t _errors[] =
+{
+    { "overrun",       HAL_UART_ERROR_ORE },
+    { "noise_framing", HAL_UART_ERROR_NE | HAL_UART_ERROR_FE },
+    { "parity",        HAL_UART_ERROR_PE }
+};
+
+static uart_t* _uart = NULL;
+static volatile uint32_t _received;
+static volatile uint8_t _expected;
+static volatile uint32_t _outOfOrder;
+
+/*** functions ************************************************************/
+
+static uint64_t _nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void _onBytes(void* context, const uint8_t* data, size_t len)
+{
+    (void)context;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (data[i] != _expected) _outOfOrder++;
+        _expected = (uint8_t)(data[i] + 1u);
+    }
+    _received += (uint32_t)len;
+}
+
+/***************************************************************************
+ * Inject one burst (running byte values) and wait until it is delivered
+ **************************************************************************/
+static bool _burst(void)
+{
+    uint8_t data[C_TEST_BURST];
+    uint32_t target = _received + C_TEST_BURST;
+
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(_expected + i);
+    halNative_uartInject(UART4, data, sizeof(data));
+
+    uint64_t endNs = _nowNs() + (uint64_t)C_TEST_TIMEOUT_MS * 1000000ull;
+    while (_received < target && _nowNs() < endNs) __WFI();
+
+    return _received == target && _outOfOrder == 0;
+}
+
+static void _checkErrors(void)
+{
+    uart_stats_t before, after;
+
+    for (size_t e = 0; e < sizeof(_errors) / sizeof(_errors[0]); e++)
+    {
+        const test_error_t* error = &_errors[e];
+        uart_getStats(_uart, &before);
+
+        TEST_ASSERT_TRUE_MESSAGE(_burst(), error->name);
+        halNative_uartInjectError(UART4, error->error);
+        TEST_ASSERT_TRUE_MESSAGE(_burst(), error->name);   // reception has to be back
+        uart_getStats(_uart, &after);
+
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE((error->error & HAL_UART_ERROR_ORE) ? 1u : 0u,
+                                         after.rxOverrun - before.rxOverrun, error->name);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE((error->error & HAL_UART_ERROR_NE) ? 1u : 0u,
+                                         after.rxNoise - before.rxNoise, error->name);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE((error->error & HAL_UART_ERROR_FE) ? 1u : 0u,
+                                         after.rxFraming - before.rxFraming, error->name);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE((error->error & HAL_UART_ERROR_PE) ? 1u : 0u,
+                                         after.rxParity - before.rxParity, error->name);
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_errors_interrupt_mode(void)
+{
+    _checkErrors();
+}
+
+static void test_errors_dma_mode(void)
+{
+    TEST_ASSERT_TRUE(uart_setRxMode(_uart, UART_RX_MODE_DMA));
+    _checkErrors();
+}
+
+int main(void)
+{
+    setenv("HAL_NATIVE_PTY", "0", 1);
+
+    HAL_Init();
+    uart_init();
+    _uart = uart_new(UART_4, 115200);
+    if (!_uart) return 1;
+    uart_registerRxSpanCallback(_uart, _onBytes, NULL);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_errors_interrupt_mode);
+    RUN_TEST(test_errors_dma_mode);
+    return UNITY_END();
+}
@@ -0,0 +1,104 @@
+/***************************************************************************
+ * test_main.c (test_uart_send)
+ * Created on: 24-Oct-2026 13:00:00
+ * M. Schermutzki
+ * Blocking send behind a running asynchronous transfer against
+ * lib/hal_native (pio test -e native): from the main context it waits for
+ * the TX ring and keeps the order, from an interrupt handler or with
+ * interrupts masked it returns UART_TX_BUSY instead of waiting for a
+ * completion interrupt that cannot come.
+ ***************************************************************************/
+#define _POSIX_C_SOURCE 200809L   // setenv
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unity.h>
+
+#include "hal_native.h"
+#include "uart.h"
+
+/*** local variables ******************************************************/
+static uart_t* _uart = NULL;
+static uart_tx_status_t _fromHandler;
+static bool _handlerRan;
+
+/*** functions ************************************************************/
+
+// TX ring ran empty: runs in the completion interrupt, the next block is already queued
+static void _onTxIdle(void* context)
+{
+    (void)context;
+    static const uint8_t data[] = "handler";
+
+    if (_handlerRan) return;
+    _handlerRan = true;
+    uart_sendBufferAsync(_uart, data, sizeof(data));
+    _fromHandler = uart_sendBuffer(_uart, data, sizeof(data));
+}
+
+void setUp(void)
+{
+    HAL_Delay(5);   // earlier transfers are done
+}
+
+void tearDown(void)
+{
+    uart_registerTxCallback(_uart, NULL, NULL);
+}
+
+static void test_main_context_waits(void)
+{
+    static const uint8_t data[] = "0123456789";
+
+    TEST_ASSERT_TRUE(uart_sendBufferAsync(_uart, data, sizeof(data)) == UART_TX_OK);
+    TEST_ASSERT_TRUE(uart_sendBuffer(_uart, data, sizeof(data)) == UART_TX_OK);
+    TEST_ASSERT_TRUE(uart_isTxIdle(_uart));
+}
+
+static void test_masked_returns_busy(void)
+{
+    static const uint8_t data[] = "0123456789";
+
+    // masked before the start: the completion interrupt stays pending
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uart_tx_status_t queued = uart_sendBufferAsync(_uart, data, sizeof(data));
+    bool active = !uart_isTxIdle(_uart);
+    uart_tx_status_t status = uart_sendBuffer(_uart, data, sizeof(data));
+    __set_PRIMASK(primask);
+
+    TEST_ASSERT_TRUE(queued == UART_TX_OK);
+    TEST_ASSERT_TRUE(active);
+    TEST_ASSERT_TRUE(status == UART_TX_BUSY);
+    TEST_ASSERT_TRUE(uart_isTxIdle(_uart));
+}
+
+static void test_handler_returns_busy(void)
+{
+    static const uint8_t data[] = "0123456789";
+
+    _handlerRan = false;
+    _fromHandler = UART_TX_OK;
+    uart_registerTxCallback(_uart, _onTxIdle, NULL);
+    TEST_ASSERT_TRUE(uart_sendBufferAsync(_uart, data, sizeof(data)) == UART_TX_OK);
+    HAL_Delay(5);
+    TEST_ASSERT_TRUE(_handlerRan);
+    TEST_ASSERT_TRUE(_fromHandler == UART_TX_BUSY);
+}
+
+int main(void)
+{
+    setenv("HAL_NATIVE_PTY", "0", 1);
+
+    HAL_Init();
+    uart_init();
+    _uart = uart_new(UART_4, 115200);
+    if (!_uart) return 1;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_main_context_waits);
+    RUN_TEST(test_masked_returns_busy);
+    RUN_TEST(test_handler_returns_busy);
+    return UNITY_END();
+}
@@ -0,0 +1,157 @@
+"""
+gen_matlab_protocol.py
+Created on: 21-Oct-2026 09:00:00
+M. Schermutzki
+
+Turns lib/matlab_communication/matlab_protocol.h into matlab/matlabProtocol.m,
+the message table of the host codec (protocolEncode.m / protocolDecode.m).
+Runs before every pio build (extra_scripts in platformio.ini) or by hand:
+    python tools/gen_matlab_protocol.py
+The file is only written if its content changed.
+"""
+import os
+import re
+import sys
+
+HEADER = os.path.join("lib", "matlab_communication", "matlab_protocol.h")
+OUTPUT = os.path.join("matlab", "matlabProtocol.m")
+
+# wire type -> MATLAB class, bytes in a binary frame
+TYPES = {
+    "U8": ("uint8", 1),
+    "I16": ("int16", 2),
+    "U32": ("uint32", 4),
+    "I32": ("int32", 4),
+    "Q16_16": ("int32", 4),
+}
+
+
+def _read_macros(path):
+    with open(path, "r") as f:
+        text = f.read()
+
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    text = re.sub(r"//[^\n]*", "", text)
+    text = re.sub(r"\\\s*\n", " ", text)
+
+    macros = {}
+    for line in text.splitlines():
+        m = re.match(r"\s*#define\s+(\w+)(\([^)]*\))?\s*(.*)$", line)
+        if m:
+            macros[m.group(1)] = (m.group(2), m.group(3).strip())
+    return macros
+
+
+def _value(token, macros):
+    token = token.strip()
+    while token.startswith("(") and token.endswith(")"):
+        token = token[1:-1].strip()
+    if token in macros:
+        return _value(macros[token][1], macros)
+    return int(token.rstrip("uU"), 0)
+
+
+def _calls(body, name):
+    """ name(a, b, ...) in body -> list of argument lists """
+    return [[a.strip() for a in args.split(",")] for args in re.findall(name + r"\(([^()]*)\)", body)]
+
+
+def _fields(list_name, macros):
+    body = macros[list_name][1]
+    fields = []
+    # nested lists and F(...) in the order they appear
+    for m in re.finditer(r"(MATLABCOM_FIELDS_\w+)\(F\)|F\(([^()]*)\)", body):
+        if m.group(1):
+            fields += _fields(m.group(1), macros)
+        else:
+            kind, member, scale = [a.strip() for a in m.group(2).split(",")]
+            if kind not in TYPES:
+                raise ValueError("%s: unknown field type %s" % (list_name, kind))
+            name = re.sub(r"\[(\d+)\]", r"\1", member.split(".")[-1])   # payload[0] -> payload0
+            fields.append((kind, name, _value(scale, macros)))
+    return fields
+
+
+def _messages(macros):
+    to_mcu = _value("C_MATLABCOM_TO_MCU", macros)
+    to_host = _value("C_MATLABCOM_TO_HOST", macros)
+    no_sub = _value("C_MATLABCOM_NO_SUB_CMD", macros)
+    messages = []
+
+    for name, cmd, sub, direction, fields, ascii_cmd in _calls(macros["MATLABCOM_MESSAGES"][1], "X"):
+        direction = _value(direction, macros)
+        sub = _value(sub, macros)
+        messages.append({
+            "name": name,
+            "id": _value(cmd, macros),
+            "sub": None if sub == no_sub else sub,
+            "toMcu": bool(direction & to_mcu),
+            "toHost": bool(direction & to_host),
+            "asciiCmd": _value(ascii_cmd, macros) != 0,
+            "fields": _fields(fields, macros),
+        })
+    return messages
+
+
+def _cell(items):
+    return "{" + ", ".join("'%s'" % i for i in items) + "}"
+
+
+def _bool(flag):
+    return "true" if flag else "false"
+
+
+def generate(project_dir):
+    macros = _read_macros(os.path.join(project_dir, HEADER))
+    lines = [
+        "function p = matlabProtocol()",
+        "    %% GENERIERT aus %s durch" % HEADER.replace(os.sep, "/"),
+        "    % tools/gen_matlab_protocol.py (jeder pio-Build) - nicht von Hand aendern",
+        "    % p.msg.<NAME>: id, sub ([] = ohne), toMcu/toHost, asciiCmd (false: ASCII-Frame",
+        "    % ohne cmd-Feld), je Feld names/types/classes/bytes/scales",
+        "    % (Wert auf der Leitung = round(Wert * scale))",
+    ]
+    for key in ("STX", "US", "ETX"):
+        lines.append("    p.%s = uint8(%d);" % (key, _value("C_MATLABCOM_" + key, macros)))
+    lines.append("    p.SEQ_FLAG = %d;" % _value("C_MATLABCOM_SEQ_FLAG", macros))
+
+    for msg in _messages(macros):
+        fields = msg["fields"]
+        lines += [
+            "",
+            "    p.msg.%s = struct('id', %d, 'sub', %s, 'toMcu', %s, 'toHost', %s, 'asciiCmd', %s, ..." % (
+                msg["name"], msg["id"], "[]" if msg["sub"] is None else str(msg["sub"]),
+                _bool(msg["toMcu"]), _bool(msg["toHost"]), _bool(msg["asciiCmd"])),
+            "        'names', {%s}, ..." % _cell(f[1] for f in fields),
+            "        'types', {%s}, ..." % _cell(f[0] for f in fields),
+            "        'classes', {%s}, ..." % _cell(TYPES[f[0]][0] for f in fields),
+            "        'bytes', [%s], ..." % " ".join(str(TYPES[f[0]][1]) for f in fields),
+            "        'scales', [%s]);" % " ".join(str(f[2]) for f in fields),
+        ]
+    lines.append("end")
+    content = "\n".join(lines) + "\n"
+
+    output = os.path.join(project_dir, OUTPUT)
+    if os.path.exists(output):
+        with open(output, "r", newline="") as f:
+            if f.read() == content:
+                return False
+
+    with open(output, "w", newline="\n") as f:
+        f.write(content)
+    return True
+
+
+try:
+    Import  # noqa: F821 (only defined when run by PlatformIO/SCons)
+except NameError:
+    Import = None
+
+if Import is not None:
+    Import("env")
+    if generate(env.subst("$PROJECT_DIR")):  # noqa: F821
+        print("gen_matlab_protocol: %s updated" % OUTPUT)
+elif __name__ == "__main__":
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    print("%s %s" % (OUTPUT, "updated" if generate(root) else "unchanged"))
+    sys.exit(0)